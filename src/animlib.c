@@ -26,7 +26,10 @@
 #include "sizebuf.h"
 #include "video.h"
 
+#include "SDL.h"
+
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 
 /*** Structs ***/
@@ -55,16 +58,23 @@ typedef struct anim_LargePageHeader_s
 } anim_LargePageHeader_t;
 
 /*** Globals ***/
-Uint8 CurrentPageBuffer[65536];
 anim_LargePageHeader_t PageHeader[256];
-Uint16 CurrentPageRecordSizes[256];
 
-anim_LargePageHeader_t CurrentPageHeader;
 anim_FileHeader_t FileHeader;
 
-unsigned int Curlpnum;
+/* The file is mapped rather than read page by page.  A streamer thread walks the
+ * pages ahead of playback, touching them so their I/O happens off the render
+ * loop, and fills in a prefix-sum table of where every record (delta frame)
+ * starts.  Rendering any indexed frame is then a table lookup.
+ */
+static FileView AnimView;
+static Uint32 *RecordOffsets; /* file offset of each record's data */
+static Uint16 *RecordSizes;
 
-FILE * InFile;
+static SDL_atomic_t PagesReady;   /* pages indexed so far */
+static SDL_atomic_t PagesBad;     /* set when the streamer stops at a page with bad data */
+static SDL_atomic_t StreamerQuit;
+static SDL_Thread *Streamer;
 
 /*** Function decs ***/
 int JE_playRunSkipDump(Uint8 *, unsigned int);
@@ -72,54 +82,83 @@ void JE_closeAnim(void);
 int JE_loadAnim(const char *);
 int JE_renderFrame(unsigned int);
 int JE_findPage (unsigned int);
-int JE_loadPage(unsigned int);
+int JE_indexPage(unsigned int);
 
 /*** Implementation ***/
 
-/* Loads the given page into memory.
+/* Indexes the records of the given page and faults its data in.
  *
  * Returns  0 on success or nonzero on failure (bad data)
  */
-int JE_loadPage(unsigned int pagenumber)
+int JE_indexPage(unsigned int pagenumber)
 {
 	unsigned int i, pageSize;
 
-	if (Curlpnum == pagenumber)
-		return 0; /* Already loaded */
-	Curlpnum = pagenumber;
-
-	/* We need to seek to the page and load it into our buffer.
-	 * Pages have a fixed size of 0x10000; any left over space is padded
+	/* Pages have a fixed size of 0x10000; any left over space is padded
 	 * unless it's the end of the file.
 	 *
 	 * Pages repeat their headers for some reason.  They then have two bytes of
 	 * padding followed by a word for every record.  THEN the data starts.
 	 */
-	fseek(InFile, ANIM_OFFSET + (pagenumber * ANI_PAGE_SIZE), SEEK_SET);
-	fread_u16_die(&CurrentPageHeader.baseRecord, 1, InFile);
-	fread_u16_die(&CurrentPageHeader.nRecords,   1, InFile);
-	fread_u16_die(&CurrentPageHeader.nBytes,     1, InFile);
+	const size_t pageStart = ANIM_OFFSET + (size_t)pagenumber * ANI_PAGE_SIZE;
+	if (pageStart + 8 > AnimView.size)
+		return -1;
 
-	fseek(InFile, 2, SEEK_CUR);
-	fread_u16_die(CurrentPageRecordSizes, CurrentPageHeader.nRecords, InFile);
+	const Uint8 *page = AnimView.data + pageStart;
+	const unsigned int baseRecord = view_read_u16(page);
+	const unsigned int nRecords   = view_read_u16(page + 2);
+	const unsigned int nBytes     = view_read_u16(page + 4);
 
-	/* What remains is the 'compressed' data */
-	fread_die(CurrentPageBuffer, 1, CurrentPageHeader.nBytes, InFile);
+	/* No frame lives on an empty page, so playback never reads it */
+	if (nRecords == 0)
+		return 0;
 
-	/* Okay, we've succeeded in all our IO checks.  Now, make sure the
-	 * headers aren't lying or damaged or something.
-	 */
+	const size_t dataStart = pageStart + 8 + nRecords * 2;
+	if (dataStart + nBytes > AnimView.size || baseRecord + nRecords > FileHeader.nRecords)
+		return -1;
+
+	/* Make sure the headers aren't lying or damaged or something. */
 	pageSize = 0;
-	for (i = 0; i < CurrentPageHeader.nRecords; i++)
-		pageSize += CurrentPageRecordSizes[i];
+	for (i = 0; i < nRecords; i++)
+	{
+		const Uint16 size = view_read_u16(page + 8 + i * 2);
+
+		RecordOffsets[baseRecord + i] = dataStart + pageSize;
+		RecordSizes[baseRecord + i] = size;
+		pageSize += size;
+	}
 
-	if (pageSize != CurrentPageHeader.nBytes)
+	if (pageSize != nBytes)
 		return -1;
 
+	/* Touch every 4 KiB so the page is resident before playback needs it */
+	volatile Uint8 sink = 0;
+	for (size_t offset = 0; offset < nBytes; offset += 4096)
+		sink ^= AnimView.data[dataStart + offset];
+	(void)sink;
+
 	/* So far, so good */
 	return 0;
 }
 
+static int SDLCALL JE_streamAnim(void *data)
+{
+	(void)data;
+
+	for (unsigned int i = 0; i < FileHeader.nlps && SDL_AtomicGet(&StreamerQuit) == 0; i++)
+	{
+		if (JE_indexPage(i) != 0)
+		{
+			/* frames on the pages before this one still play */
+			SDL_AtomicSet(&PagesBad, 1);
+			return 0;
+		}
+		SDL_AtomicSet(&PagesReady, i + 1);
+	}
+
+	return 0;
+}
+
 int JE_findPage(unsigned int framenumber)
 {
 	unsigned int i;
@@ -138,21 +177,30 @@ int JE_findPage(unsigned int framenumber)
 
 int JE_renderFrame(unsigned int framenumber)
 {
-	unsigned int i, offset, destframe;
+	int pageNum = JE_findPage(framenumber);
+	if (pageNum == -1)
+		return -1;
 
-	destframe = framenumber - CurrentPageHeader.baseRecord;
+	/* Normally the streamer is far ahead; only a cold seek can get here first */
+	while (SDL_AtomicGet(&PagesReady) <= pageNum)
+	{
+		if (SDL_AtomicGet(&PagesBad) != 0)
+			return -1;
+		SDL_Delay(1);
+	}
+	if (RecordOffsets[framenumber] == 0)
+		return -1;
 
-	offset = 0;
-	for (i = 0; i < destframe; i++)
-		offset += CurrentPageRecordSizes[i];
+	/* A record too short for its header carries no changes; the frame repeats */
+	if (RecordSizes[framenumber] < 4)
+		return 0;
 
-	return (JE_playRunSkipDump(CurrentPageBuffer + offset + 4, CurrentPageRecordSizes[destframe] - 4));
+	return (JE_playRunSkipDump((Uint8 *)AnimView.data + RecordOffsets[framenumber] + 4, RecordSizes[framenumber] - 4));
 }
 
 void JE_playAnim(const char *animfile, JE_byte startingframe, JE_byte speed)
 {
 	unsigned int i;
-	int pageNum;
 
 	if (JE_loadAnim(animfile) != 0)
 		return; /* Failed to open or process file */
@@ -172,13 +220,6 @@ void JE_playAnim(const char *animfile, JE_byte startingframe, JE_byte speed)
 		/* Handle boring crap */
 		setDelay(speed);
 
-		/* Load required frame.  The loading function is smart enough to not re-load an already loaded frame */
-		pageNum = JE_findPage(i);
-		if (pageNum == -1)
-			break;
-		if (JE_loadPage(pageNum) != 0)
-			break;
-
 		/* render frame. */
 		if (JE_renderFrame(i) != 0)
 			break;
@@ -197,26 +238,21 @@ void JE_playAnim(const char *animfile, JE_byte startingframe, JE_byte speed)
 	JE_closeAnim();
 }
 
-/* loadAnim opens the file and loads data from it into the header structs.
+/* loadAnim maps the file and loads data from it into the header structs.
  * It should take care to clean up after itself should an error occur.
  */
 int JE_loadAnim(const char *filename)
 {
 	unsigned int i;
-	long fileSize;
-	char temp[4];
 
-	Curlpnum = -1;
-	InFile = dir_fopen(data_dir(), filename, "rb");
-	if (InFile == NULL)
+	if (!dir_map(data_dir(), filename, &AnimView))
 		return -1;
 
-	fileSize = ftell_eof(InFile);
-	if (fileSize < ANIM_OFFSET)
+	if (AnimView.size < ANIM_OFFSET)
 	{
 		/* We don't know the exact size our file should be yet,
 		 * but we do know it should be way more than this */
-		fclose(InFile);
+		file_view_release(&AnimView);
 		return -1;
 	}
 
@@ -227,58 +263,87 @@ int JE_loadAnim(const char *filename)
 	 * is constant will be ignored.
 	 */
 
-	fread_die(&temp, 1, 4, InFile); /* The ID, should equal "LPF " */
-	fseek(InFile, 2, SEEK_CUR); /* skip over this word */
-	fread_u16_die(&FileHeader.nlps,     1, InFile); /* Number of pages */
-	fread_u32_die(&FileHeader.nRecords, 1, InFile); /* Number of records */
+	/* The ID, should equal "LPF ", followed by a word we skip over */
+	FileHeader.nlps     = view_read_u16(AnimView.data + 6); /* Number of pages */
+	FileHeader.nRecords = view_read_u32(AnimView.data + 8); /* Number of records */
 
-	if (memcmp(temp, "LPF ", 4) != 0 ||
+	if (memcmp(AnimView.data, "LPF ", 4) != 0 ||
 	    FileHeader.nlps == 0  || FileHeader.nRecords == 0 ||
 	    FileHeader.nlps > 256 || FileHeader.nRecords > 65535)
 	{
-		fclose(InFile);
+		file_view_release(&AnimView);
 		return -1;
 	}
 
 	/* Read in headers */
-	fseek(InFile, PAGEHEADER_OFFSET, SEEK_SET);
 	for (i = 0; i < FileHeader.nlps; i++)
 	{
-		fread_u16_die(&PageHeader[i].baseRecord, 1, InFile);
-		fread_u16_die(&PageHeader[i].nRecords,   1, InFile);
-		fread_u16_die(&PageHeader[i].nBytes,     1, InFile);
+		const Uint8 *header = AnimView.data + PAGEHEADER_OFFSET + i * 6;
+		PageHeader[i].baseRecord = view_read_u16(header);
+		PageHeader[i].nRecords   = view_read_u16(header + 2);
+		PageHeader[i].nBytes     = view_read_u16(header + 4);
 	}
 
 	/* Now we have enough information to calculate the 'expected' file size.
 	 * Our calculation SHOULD be equal to fileSize, but we won't begrudge
 	 * padding */
-	if (fileSize < (FileHeader.nlps-1) * ANI_PAGE_SIZE + ANIM_OFFSET
+	if (AnimView.size < (size_t)(FileHeader.nlps-1) * ANI_PAGE_SIZE + ANIM_OFFSET
 	  + PageHeader[FileHeader.nlps-1].nBytes
 	  + PageHeader[FileHeader.nlps-1].nRecords * 2 + 8)
 	{
-		fclose(InFile);
+		file_view_release(&AnimView);
 		return -1;
 	}
 
 	/* Now read in the palette. */
-	fseek(InFile, PALETTE_OFFSET, SEEK_SET);
 	for (i = 0; i < 256; i++)
 	{
-		Uint8 bgru[4];
-		fread_u8_die(bgru, 4, InFile);
+		const Uint8 *bgru = AnimView.data + PALETTE_OFFSET + i * 4;
 		colors[i].b = bgru[0];
 		colors[i].g = bgru[1];
 		colors[i].r = bgru[2];
 	}
 	set_palette(colors, 0, 255);
 
+	/* Records no page claims keep offset 0 and fail to render */
+	RecordOffsets = calloc(FileHeader.nRecords, sizeof(*RecordOffsets));
+	RecordSizes = calloc(FileHeader.nRecords, sizeof(*RecordSizes));
+	if (RecordOffsets == NULL || RecordSizes == NULL)
+	{
+		free(RecordOffsets);
+		RecordOffsets = NULL;
+		free(RecordSizes);
+		RecordSizes = NULL;
+		file_view_release(&AnimView);
+		return -1;
+	}
+
+	SDL_AtomicSet(&PagesReady, 0);
+	SDL_AtomicSet(&PagesBad, 0);
+	SDL_AtomicSet(&StreamerQuit, 0);
+	Streamer = SDL_CreateThread(JE_streamAnim, "anim stream", NULL);
+	if (Streamer == NULL)
+		JE_streamAnim(NULL); /* no thread; index everything up front */
+
 	/* Whew!  That was hard.  Let's go grab some beers! */
 	return 0;
 }
 
 void JE_closeAnim(void)
 {
-	fclose(InFile);
+	if (Streamer != NULL)
+	{
+		SDL_AtomicSet(&StreamerQuit, 1);
+		SDL_WaitThread(Streamer, NULL);
+		Streamer = NULL;
+	}
+
+	free(RecordOffsets);
+	free(RecordSizes);
+	RecordOffsets = NULL;
+	RecordSizes = NULL;
+
+	file_view_release(&AnimView);
 }
 
 /* RunSkipDump decompresses the video.  There are three operations, run, skip,
@@ -19,7 +19,10 @@
 #include "debug_console.h"
 
 #include "fonthand.h"
+#include "loudness.h"
+#include "network.h"
 #include "opentyr.h"
+#include "remote_control.h"
 #include "vga256d.h"
 #include "video.h"
 #include "video_scale.h"
@@ -63,6 +66,7 @@ static void console_print(const char *text)
 	}
 
 	snprintf(console_lines[console_line_count], CONSOLE_MAX_LINE_LEN, "%s", text);
+	remote_control_on_console_line(console_lines[console_line_count]);
 	console_line_count++;
 }
 
@@ -221,7 +225,7 @@ static void completion_step_selection(int delta)
 
 static void build_completion_info(CompletionInfo *info)
 {
-	static const char *const root_commands[] = { "resolution", "exit" };
+	static const char *const root_commands[] = { "resolution", "audio", "net", "exit" };
 	static const char *const res_commands[] = { "set", "mode" };
 	static const char *const mode_values[] = { "center", "integer", "fit8:5", "fit4:3" };
 
@@ -499,6 +503,10 @@ static const char *completion_selected_description(const CompletionInfo *info)
 	case COMPLETION_CTX_ROOT:
 		if (SDL_strcasecmp(choice, "resolution") == 0)
 			snprintf(desc, sizeof(desc), "Open resolution/scaler submenu.");
+		else if (SDL_strcasecmp(choice, "audio") == 0)
+			snprintf(desc, sizeof(desc), "Audio callback timings (stats, reset).");
+		else if (SDL_strcasecmp(choice, "net") == 0)
+			snprintf(desc, sizeof(desc), "Netplay link counters (stats, reset, overlay).");
 		else if (SDL_strcasecmp(choice, "exit") == 0)
 			snprintf(desc, sizeof(desc), "Close debug console.");
 		break;
@@ -953,6 +961,114 @@ static void cmd_resolution_set(const char *arg)
 	console_print(buf);
 }
 
+static void cmd_audio(const char *arg)
+{
+	if (arg != NULL && SDL_strcasecmp(arg, "reset") == 0)
+	{
+		audio_reset_stats();
+		console_print("Audio stats reset.");
+		return;
+	}
+
+	if (arg != NULL && SDL_strcasecmp(arg, "stats") != 0)
+	{
+		console_print("Usage: audio stats | audio reset");
+		return;
+	}
+
+	AudioStats stats;
+	if (!audio_get_stats(&stats))
+	{
+		console_print("Audio is disabled.");
+		return;
+	}
+
+	char buf[CONSOLE_MAX_LINE_LEN];
+	snprintf(buf, sizeof(buf), "Device: %d Hz x%d, %d frames (%.1f ms)",
+	         stats.rate, stats.channels, stats.frames,
+	         stats.rate > 0 ? stats.frames * 1000.0 / stats.rate : 0.0);
+	console_print(buf);
+
+	snprintf(buf, sizeof(buf), "Callbacks: %u  Underruns: %u  Dropped: %u",
+	         stats.callbacks, stats.underruns, stats.dropped);
+	console_print(buf);
+
+	snprintf(buf, sizeof(buf), "Callback ms: avg %.2f max %.2f last %.2f",
+	         stats.callback_ms_avg, stats.callback_ms_max, stats.callback_ms_last);
+	console_print(buf);
+
+	snprintf(buf, sizeof(buf), "Interval ms: avg %.2f max %.2f",
+	         stats.interval_ms_avg, stats.interval_ms_max);
+	console_print(buf);
+
+	const double total_ms = stats.lds_ms + stats.synth_ms + stats.mix_ms;
+	if (total_ms > 0)
+	{
+		snprintf(buf, sizeof(buf), "Time: lds %.0f%%  opl %.0f%%  mix %.0f%%",
+		         stats.lds_ms * 100 / total_ms, stats.synth_ms * 100 / total_ms, stats.mix_ms * 100 / total_ms);
+		console_print(buf);
+	}
+}
+
+static void cmd_net(const char *arg)
+{
+#ifdef WITH_NETWORK
+	if (arg != NULL && SDL_strcasecmp(arg, "reset") == 0)
+	{
+		network_reset_stats();
+		console_print("Net stats reset.");
+		return;
+	}
+
+	if (arg != NULL && SDL_strcasecmp(arg, "overlay") == 0)
+	{
+		network_overlay = !network_overlay;
+		console_print(network_overlay ? "Net overlay on." : "Net overlay off.");
+		return;
+	}
+
+	if (arg != NULL && SDL_strcasecmp(arg, "stats") != 0)
+	{
+		console_print("Usage: net stats | net reset | net overlay");
+		return;
+	}
+
+	if (!isNetworkGame)
+	{
+		console_print("Not in a network game.");
+		return;
+	}
+
+	const NetworkStats *stats = &network_stats;
+
+	char buf[CONSOLE_MAX_LINE_LEN];
+	snprintf(buf, sizeof(buf), "RTT ms: avg %.1f p95 %u (%u samples)",
+	         stats->rtt_ms, stats->rtt_p95_ms, stats->rtt_count);
+	console_print(buf);
+
+	snprintf(buf, sizeof(buf), "Out: %.0f pkt/s %.0f B/s  In: %.0f pkt/s %.0f B/s",
+	         stats->packets_sent_rate, stats->bytes_sent_rate, stats->packets_received_rate, stats->bytes_received_rate);
+	console_print(buf);
+
+	snprintf(buf, sizeof(buf), "Resends: %u  Retries: %u  XOR: %u  Desyncs: %u",
+	         stats->resends, stats->retries, stats->xor_recoveries, stats->desyncs);
+	console_print(buf);
+
+	snprintf(buf, sizeof(buf), "Blocked: %u ms, %u stalls, %.0f ms/s",
+	         stats->stalled_ms, stats->stalls, stats->stalled_ms_rate);
+	console_print(buf);
+
+	if (network_spectators_max > 0)
+	{
+		snprintf(buf, sizeof(buf), "Spectators: %u of %d", stats->spectators, network_spectators_max);
+		console_print(buf);
+	}
+#else
+	(void)arg;
+	console_print("Networking is not compiled in.");
+#endif
+}
+
 static void execute_command(const char *cmd)
 {
 	/* Echo the command. */
@@ -984,6 +1100,10 @@ static void execute_command(const char *cmd)
 
 	if (strcmp(verb, "resolution") == 0)
 		cmd_resolution_set(arg);
+	else if (strcmp(verb, "audio") == 0)
+		cmd_audio(arg);
+	else if (strcmp(verb, "net") == 0)
+		cmd_net(arg);
 	else if (strcmp(verb, "exit") == 0)
 	{
 		console_active = false;
@@ -0,0 +1,137 @@
+/*
+ * Tyrian 3000: Demo Replay Benchmark
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#include "demo_bench.h"
+
+#include "varz.h"
+
+#include <stdio.h>
+
+typedef struct
+{
+	Uint8 demo;
+	Uint32 frames;
+	Uint32 enemy_frames;  // live enemies summed over the frames
+	Uint32 peak_enemies;
+	Uint64 frame_ticks;
+	Uint64 enemy_ticks;
+} DemoBenchRun;
+
+int demo_bench_passes = 0;
+int demo_bench_crowd = 1;
+
+static DemoBenchRun runs[DEMO_BENCH_DEMOS * DEMO_BENCH_PASSES_MAX];
+static int run_count = 0;
+static bool playing = false;
+
+static DemoBenchRun current;
+static Uint64 last_frame = 0;
+
+static double ticks_to_ms(Uint64 ticks)
+{
+	return ticks * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static void print_report(void)
+{
+	DemoBenchRun total = { 0, 0, 0, 0, 0, 0 };
+	for (int i = 0; i < run_count; ++i)
+	{
+		total.frames += runs[i].frames;
+		total.enemy_frames += runs[i].enemy_frames;
+		total.peak_enemies = MAX(total.peak_enemies, runs[i].peak_enemies);
+		total.frame_ticks += runs[i].frame_ticks;
+		total.enemy_ticks += runs[i].enemy_ticks;
+	}
+
+	printf("demo bench: %d pass%s, crowd %d\n", demo_bench_passes, demo_bench_passes == 1 ? "" : "es", demo_bench_crowd);
+	printf("  %6s %8s %8s %5s %10s %10s %12s\n", "demo", "frames", "enemies", "peak", "frame ms", "enemy ms", "ns/enemy");
+	for (int i = 0; i <= run_count; ++i)
+	{
+		const DemoBenchRun *run = i < run_count ? &runs[i] : &total;
+		const double enemy_ms = ticks_to_ms(run->enemy_ticks);
+
+		char name[8];
+		if (i < run_count)
+			snprintf(name, sizeof(name), "%u", run->demo);
+		else
+			snprintf(name, sizeof(name), "total");
+
+		printf("  %6s %8u %8.1f %5u %10.2f %10.2f %12.1f\n", name, run->frames,
+		       run->frames > 0 ? (double)run->enemy_frames / run->frames : 0.0, run->peak_enemies,
+		       ticks_to_ms(run->frame_ticks), enemy_ms,
+		       run->enemy_frames > 0 ? enemy_ms * 1e6 / run->enemy_frames : 0.0);
+	}
+
+	// one line, so benchmark scripts can grep for it
+	const double enemy_ms = ticks_to_ms(total.enemy_ticks);
+	printf("{\"demo_bench\":{\"passes\":%d,\"crowd\":%d,\"frames\":%u,\"enemy_frames\":%u,\"peak_enemies\":%u,"
+	       "\"frame_ms\":%.3f,\"enemy_ms\":%.3f,\"ns_per_enemy\":%.3f,\"runs\":[",
+	       demo_bench_passes, demo_bench_crowd, total.frames, total.enemy_frames, total.peak_enemies,
+	       ticks_to_ms(total.frame_ticks), enemy_ms, total.enemy_frames > 0 ? enemy_ms * 1e6 / total.enemy_frames : 0.0);
+	for (int i = 0; i < run_count; ++i)
+		printf("%s{\"demo\":%u,\"frames\":%u,\"enemy_frames\":%u,\"peak_enemies\":%u,\"frame_ms\":%.3f,\"enemy_ms\":%.3f}",
+		       i > 0 ? "," : "", runs[i].demo, runs[i].frames, runs[i].enemy_frames, runs[i].peak_enemies,
+		       ticks_to_ms(runs[i].frame_ticks), ticks_to_ms(runs[i].enemy_ticks));
+	printf("]}}\n");
+	fflush(stdout);
+}
+
+bool demo_bench_next(void)
+{
+	if (playing)
+	{
+		current.demo = demo_num;
+		runs[run_count++] = current;
+		playing = false;
+	}
+
+	if (run_count == demo_bench_passes * DEMO_BENCH_DEMOS)
+	{
+		print_report();
+		return false;
+	}
+
+	const DemoBenchRun empty = { 0, 0, 0, 0, 0, 0 };
+	current = empty;
+	last_frame = 0;
+	playing = true;
+
+	return true;
+}
+
+Uint64 demo_bench_clock(void)
+{
+	return playing ? SDL_GetPerformanceCounter() : 0;
+}
+
+void demo_bench_enemy_time(Uint64 start)
+{
+	if (start != 0)
+		current.enemy_ticks += SDL_GetPerformanceCounter() - start;
+}
+
+void demo_bench_frame(void)
+{
+	if (!playing)
+		return;
+
+	const Uint64 now = SDL_GetPerformanceCounter();
+	if (last_frame != 0)
+		current.frame_ticks += now - last_frame;
+	last_frame = now;
+
+	Uint32 live = 0;
+	for (unsigned int i = slot_pool_next_live(&enemyPool, 0, 100); i < 100; i = slot_pool_next_live(&enemyPool, i + 1, 100))
+		++live;
+
+	current.frames++;
+	current.enemy_frames += live;
+	current.peak_enemies = MAX(current.peak_enemies, live);
+}
@@ -0,0 +1,44 @@
+/*
+ * Tyrian 3000: Demo Replay Benchmark
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#ifndef DEMO_BENCH_H
+#define DEMO_BENCH_H
+
+#include "opentyr.h"
+
+#include "SDL.h"
+
+#include <stdbool.h>
+
+#define DEMO_BENCH_DEMOS      5  // demo.1 to demo.5 ship with the game data
+#define DEMO_BENCH_PASSES_MAX 9
+#define DEMO_BENCH_CROWD_MAX  8
+
+/* Times to play through every demo; 0 is a normal game. */
+extern int demo_bench_passes;
+
+/* Copies spawned of each enemy a level creates (1 plays the demos as recorded).
+   More fill the enemy slots so the enemy passes have more to do. */
+extern int demo_bench_crowd;
+
+/* Called from the main loop in place of the title screen.  Closes out the demo just
+   played and returns true if JE_main should play another; after the last one, prints
+   the report and returns false. */
+bool demo_bench_next(void);
+
+/* Returns a start stamp for demo_bench_enemy_time, or 0 when benchmarking is off. */
+Uint64 demo_bench_clock(void);
+
+/* Adds the time since `start` to the enemy movement, draw and collision total. */
+void demo_bench_enemy_time(Uint64 start);
+
+/* Called once per game frame: counts the frame and the enemies alive in it. */
+void demo_bench_frame(void);
+
+#endif /* DEMO_BENCH_H */
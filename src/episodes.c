@@ -20,9 +20,11 @@
 
 #include "config.h"
 #include "file.h"
+#include "helptext.h"
 #include "lvllib.h"
 #include "lvlmast.h"
 #include "opentyr.h"
+#include "startup_report.h"
 
 /* MAIN Weapons Data */
 JE_WeaponPortType weaponPort;
@@ -51,8 +53,17 @@ JE_boolean bonusLevel;
 /* Tells if the game jumped back to Episode 1 */
 JE_boolean jumpBackToEpisode1;
 
+/* levelsN.dat decrypted once per episode, split into lines and '*' sections */
+static char   *episode_text = NULL;
+static size_t *episode_lines = NULL;      // offset of each line in episode_text
+static size_t  episode_line_count = 0;
+static size_t *episode_sections = NULL;   // first line of each section
+static size_t  episode_section_count = 0;
+
 void JE_loadItemDat(void)
 {
+	const Uint64 report_start = startup_report_clock();
+
 	FILE *f = NULL;
 	
 	if (episodeNum <= 3)
@@ -68,6 +79,8 @@ void JE_loadItemDat(void)
 		fseek(f, lvlPos[lvlNum-1], SEEK_SET);
 	}
 
+	const long item_start = ftell(f);
+
 	JE_word itemNum[7]; /* [1..7] */
 	fread_u16_die(itemNum, 7, f);
 
@@ -222,22 +235,105 @@ void JE_loadItemDat(void)
 		}
 	}
 	
+	startup_report_file(episodeNum <= 3 ? "tyrian.hdt (items)" : levelFile, ftell(f) - item_start, report_start);
 	fclose(f);
 }
 
+static void free_episode_script(void)
+{
+	free(episode_text);
+	free(episode_lines);
+	free(episode_sections);
+
+	episode_text = NULL;
+	episode_lines = NULL;
+	episode_sections = NULL;
+	episode_line_count = 0;
+	episode_section_count = 0;
+}
+
+static void index_episode_script(void)
+{
+	free_episode_script();
+
+	const Uint64 report_start = startup_report_clock();
+
+	FILE *f = dir_fopen_warn(data_dir(), episode_file, "rb");
+	if (f == NULL)
+		return;
+
+	const long size = ftell_eof(f);
+
+	// every line costs at least its length byte, which becomes its terminator
+	episode_text = malloc(MAX(size, 1));
+	episode_lines = malloc(MAX(size, 1) * sizeof(*episode_lines));
+	episode_sections = malloc((MAX(size, 1) + 1) * sizeof(*episode_sections));
+
+	episode_sections[episode_section_count++] = 0;
+
+	size_t text_len = 0;
+	while (ftell(f) < size)
+	{
+		char *line = episode_text + text_len;
+		read_encrypted_pascal_string(line, 256, f);
+
+		episode_lines[episode_line_count++] = text_len;
+		text_len += strlen(line) + 1;
+
+		if (line[0] == '*')
+			episode_sections[episode_section_count++] = episode_line_count;
+	}
+
+	startup_report_file(episode_file, size, report_start);
+	fclose(f);
+}
+
+static void episode_script_die(void)
+{
+	fprintf(stderr, "error: An unexpected problem occurred while reading from a file.\n");
+	SDL_Quit();
+	exit(EXIT_FAILURE);
+}
+
+size_t episode_script_seek(unsigned int section)
+{
+	if (section >= episode_section_count)
+		episode_script_die();
+
+	return episode_sections[section];
+}
+
+void episode_script_read(size_t *line, char *s, size_t size)
+{
+	if (*line >= episode_line_count)
+		episode_script_die();
+
+	SDL_strlcpy(s, episode_text + episode_lines[*line], size);
+	++*line;
+}
+
 void JE_initEpisode(JE_byte newEpisode)
 {
 	if (newEpisode == episodeNum)
 		return;
 	
 	episodeNum = newEpisode;
+	startup_report_section();
 	
 	snprintf(levelFile,    sizeof(levelFile),    "tyrian%hhu.lvl",  episodeNum);
 	snprintf(cube_file,    sizeof(cube_file),    "cubetxt%hhu.dat", episodeNum);
 	snprintf(episode_file, sizeof(episode_file), "levels%hhu.dat",  episodeNum);
 	
+	index_episode_script();
+	startup_report_phase("episode_script");
 	JE_analyzeLevel();
+	startup_report_phase("level_index");
 	JE_loadItemDat();
+	startup_report_phase("item_data");
+
+	char section[16];
+	snprintf(section, sizeof(section), "episode %d", episodeNum);
+	startup_report_print(section);
 }
 
 void JE_scanForEpisodes(void)
@@ -165,6 +165,10 @@ extern JE_boolean jumpBackToEpisode1;
 
 void JE_loadItemDat(void);
 void JE_initEpisode(JE_byte newEpisode);
+
+/* Episode script access; a cursor is a line number returned by episode_script_seek. */
+size_t episode_script_seek(unsigned int section);
+void episode_script_read(size_t *line, char *s, size_t size);
 unsigned int JE_findNextEpisode(void);
 void JE_scanForEpisodes(void);
 
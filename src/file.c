@@ -19,15 +19,27 @@
 #include "file.h"
 
 #include "opentyr.h"
+#include "preload.h"
+#include "startup_report.h"
 #include "varz.h"
 
 #include "SDL.h"
 
+#if !defined(TARGET_WIN32) && !defined(__EMSCRIPTEN__)
+#define FILE_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#define MAPPED_FILES_MAX 32
+
 const char *custom_data_dir = NULL;
 
 // finds the Tyrian data directory
@@ -116,6 +128,146 @@ bool dir_file_exists(const char *dir, const char *file)
 	return (f != NULL);
 }
 
+static struct
+{
+	char *path;
+	FileView view;
+}
+mapped_files[MAPPED_FILES_MAX];
+static SDL_SpinLock mapped_files_lock = 0;  // the startup preloader maps files from worker threads
+
+static bool map_file(const char *path, FileView *view)
+{
+#ifdef FILE_USE_MMAP
+	const int fd = open(path, O_RDONLY);
+	if (fd >= 0)
+	{
+		struct stat st;
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			// read-only shared mapping: every running instance uses the same page-cache pages
+			void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			if (data != MAP_FAILED)
+			{
+				close(fd);
+
+				view->data = data;
+				view->size = (size_t)st.st_size;
+				view->heap = false;
+				return true;
+			}
+		}
+		close(fd);
+	}
+#endif
+
+	// no mmap (or it failed); fall back to a private heap copy
+	FILE *f = fopen(path, "rb");
+	if (f == NULL)
+		return false;
+
+	const long size = ftell_eof(f);
+	Uint8 *data = malloc(MAX(size, 1));
+	if (data == NULL || fread(data, 1, (size_t)size, f) != (size_t)size)
+	{
+		free(data);
+		fclose(f);
+		return false;
+	}
+	fclose(f);
+
+	view->data = data;
+	view->size = (size_t)size;
+	view->heap = true;
+	return true;
+}
+
+// map a data file privately; unlike dir_map_die, the caller owns the view and must release it
+bool dir_map(const char *dir, const char *file, FileView *view)
+{
+	char *path = malloc(strlen(dir) + 1 + strlen(file) + 1);
+	sprintf(path, "%s/%s", dir, file);
+
+	const Uint64 report_start = startup_report_clock();
+
+	const bool ok = map_file(path, view);
+	if (ok)
+		startup_report_file(file, view->size, report_start);
+	if (!ok)
+		fprintf(stderr, "warning: failed to open '%s': %s\n", file, strerror(errno));
+
+	free(path);
+	return ok;
+}
+
+void file_view_release(FileView *view)
+{
+	if (view->data == NULL)
+		return;
+
+#ifdef FILE_USE_MMAP
+	if (!view->heap)
+		munmap((void *)view->data, view->size);
+	else
+#endif
+		free((void *)view->data);
+
+	view->data = NULL;
+	view->size = 0;
+}
+
+// map a data file read-only; views stay valid until exit and are shared by every caller
+FileView dir_map_die(const char *dir, const char *file)
+{
+	char *path = malloc(strlen(dir) + 1 + strlen(file) + 1);
+	sprintf(path, "%s/%s", dir, file);
+
+	SDL_AtomicLock(&mapped_files_lock);
+
+	uint i;
+	for (i = 0; i < COUNTOF(mapped_files) && mapped_files[i].path != NULL; ++i)
+	{
+		if (strcmp(mapped_files[i].path, path) == 0)
+		{
+			const FileView view = mapped_files[i].view;
+			SDL_AtomicUnlock(&mapped_files_lock);
+
+			free(path);
+			return view;
+		}
+	}
+
+	const Uint64 report_start = startup_report_clock();
+
+	FileView view;
+	if (!map_file(path, &view))
+	{
+		SDL_AtomicUnlock(&mapped_files_lock);
+		free(path);
+
+		fprintf(stderr, "error: failed to open '%s': %s\n", file, strerror(errno));
+		fprintf(stderr, "error: One or more of the required Tyrian " TYRIAN_VERSION " data files could not be found.\n"
+		                "       Please read the README file.\n");
+		JE_tyrianHalt(1);
+	}
+
+	if (i < COUNTOF(mapped_files))
+	{
+		mapped_files[i].path = path;
+		mapped_files[i].view = view;
+	}
+	else
+	{
+		free(path);  // registry full; the view is simply not shared with later callers
+	}
+
+	SDL_AtomicUnlock(&mapped_files_lock);
+
+	startup_report_file(file, view.size, report_start);
+
+	return view;
+}
+
 // returns end-of-file position
 long ftell_eof(FILE *f)
 {
@@ -135,6 +287,7 @@ void fread_die(void *buffer, size_t size, size_t count, FILE *stream)
 	if (result != count)
 	{
 		fprintf(stderr, "error: An unexpected problem occurred while reading from a file.\n");
+		preload_halting();
 		SDL_Quit();
 		exit(EXIT_FAILURE);
 	}
@@ -146,6 +299,7 @@ void fwrite_die(const void *buffer, size_t size, size_t count, FILE *stream)
 	if (result != count)
 	{
 		fprintf(stderr, "error: An unexpected problem occurred while writing to a file.\n");
+		preload_halting();
 		SDL_Quit();
 		exit(EXIT_FAILURE);
 	}
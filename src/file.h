@@ -34,6 +34,30 @@ FILE *dir_fopen_die(const char *dir, const char *file, const char *mode);
 
 bool dir_file_exists(const char *dir, const char *file);
 
+typedef struct
+{
+	const Uint8 *data;
+	size_t size;
+	bool heap;  // fallback copy rather than a mapping
+}
+FileView;
+
+FileView dir_map_die(const char *dir, const char *file);
+bool dir_map(const char *dir, const char *file, FileView *view);
+void file_view_release(FileView *view);
+
+// little-endian 16-bit read from a (possibly unaligned) file view
+static inline Uint16 view_read_u16(const Uint8 *p)
+{
+	return (Uint16)(p[0] | (p[1] << 8));
+}
+
+// little-endian 32-bit read from a (possibly unaligned) file view
+static inline Uint32 view_read_u32(const Uint8 *p)
+{
+	return (Uint32)p[0] | ((Uint32)p[1] << 8) | ((Uint32)p[2] << 16) | ((Uint32)p[3] << 24);
+}
+
 long ftell_eof(FILE *f);
 
 void fread_die(void *buffer, size_t size, size_t count, FILE *stream);
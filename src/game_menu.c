@@ -35,6 +35,7 @@
 #include "pcxmast.h"
 #include "picload.h"
 #include "player.h"
+#include "remote_control.h"
 #include "shots.h"
 #include "sprite.h"
 #include "tyrian2.h"
@@ -158,6 +159,28 @@ void JE_itemScreen(void)
 {
 	bool quit = false;
 
+	remote_control_set_ui_context("item_screen");
+
+#ifdef WITH_NETWORK
+	if (network_spectating)
+	{
+		// nothing to buy; the host's next keyframe says which level the players chose
+		const char *waiting = "Waiting for the next level.";
+
+		VGAScreen = VGAScreenSeg;
+		JE_loadPic(VGAScreen, 2, false);
+		JE_dString(VGAScreen, JE_fontCenter(waiting, SMALL_FONT_SHAPES), 140, waiting, SMALL_FONT_SHAPES);
+		JE_showVGA();
+		fade_palette(colors, 10, 0, 255);
+
+		network_spectate_next_level();
+
+		fade_black(10);
+		jumpSection = true;
+		return;
+	}
+#endif
+
 	if (shopSpriteSheet.data == NULL)
 		JE_loadCompShapes(&shopSpriteSheet, '1');
 
@@ -1628,7 +1651,7 @@ void JE_itemScreen(void)
 			service_SDL_events(false);
 			JE_showVGA();
 
-			if (packet_in[0] && SDLNet_Read16(&packet_in[0]->data[0]) == PACKET_WAITING)
+			if (NET_PACKET(packet_in, 0) && SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[0]) == PACKET_WAITING)
 			{
 				network_update();
 				break;
@@ -2271,7 +2294,7 @@ void JE_initWeaponView(void)
 	power = 500;
 	lastPower = 500;
 
-	memset(shotAvail, 0, sizeof(shotAvail));
+	player_shot_free_all();
 
 	memset(shotRepeat, 1, sizeof(shotRepeat));
 	memset(shotMultiPos, 0, sizeof(shotMultiPos));
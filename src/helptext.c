@@ -24,6 +24,7 @@
 #include "fonthand.h"
 #include "menus.h"
 #include "opentyr.h"
+#include "startup_report.h"
 #include "video.h"
 
 #include <assert.h>
@@ -190,6 +191,8 @@ void JE_loadHelpText(void)
 	const unsigned int menuInt_entries[MENU_MAX + 1] = { -1, 7, 9, 9, -1, -1, 11, -1, -1, -1, 6, 4, 7, 7, 5, 6 };
 	const unsigned int setup_entries[10] = {10, 5, 4, 4, 5, 7, 7, 21, 3, 3};
 	
+	const Uint64 report_start = startup_report_clock();
+
 	FILE *f = dir_fopen_die(data_dir(), "tyrian.hdt", "rb");
 	fread_s32_die(&episode1DataLoc, 1, f);
 
@@ -449,5 +452,6 @@ void JE_loadHelpText(void)
 	for (unsigned int i = 0; i < COUNTOF(superTyrianText); ++i)
 		read_encrypted_pascal_string(superTyrianText[i], sizeof(superTyrianText[i]), f);
 
+	startup_report_file("tyrian.hdt", ftell(f), report_start);
 	fclose(f);
 }
@@ -21,7 +21,6 @@
 #include "font.h"
 #include "joystick.h"
 #include "keyboard.h"
-#include "lds_play.h"
 #include "loudness.h"
 #include "mtrand.h"
 #include "nortsong.h"
@@ -71,7 +70,7 @@ void jukebox(void)  // FKA Setup.jukeboxGo
 	{
 		if (!stopped && !audio_disabled)
 		{
-			if (songlooped && fade_looped_songs)
+			if (song_has_looped() && fade_looped_songs)
 				fading_song = true;
 
 			if (fading_song)
@@ -90,7 +89,7 @@ void jukebox(void)  // FKA Setup.jukeboxGo
 				set_volume(fade_volume, fxVolume);
 			}
 
-			if (!playing || (songlooped && fade_looped_songs && !fading_song))
+			if (!song_is_playing() || (song_has_looped() && fade_looped_songs && !fading_song))
 				play_song(mt_rand() % MUSIC_NUM);
 		}
 
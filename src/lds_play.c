@@ -230,6 +230,12 @@ void lds_rewind(void)
 	}
 }
 
+void lds_get_position(unsigned int *position, unsigned int *row)
+{
+	*position = posplay;
+	*row = pattplay;
+}
+
 void lds_fade(Uint8 speed)
 {
 	fadeonoff = speed;
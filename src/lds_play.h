@@ -30,6 +30,7 @@ bool lds_load(FILE *f, unsigned int music_offset, unsigned int music_size);
 void lds_free(void);
 void lds_rewind(void);
 void lds_fade(Uint8 speed);
+void lds_get_position(unsigned int *position, unsigned int *row);
 
 /*unsigned int getorders() { return numposi; }
 unsigned int getorder() { return posplay; }
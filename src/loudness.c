@@ -23,24 +23,30 @@
 #include "nortsong.h"
 #include "opentyr.h"
 #include "params.h"
+#include "startup_report.h"
 
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define OUTPUT_QUALITY 4  // 44.1 kHz
-
 int audioSampleRate = 0;
+static int audioChannels = 1;  // of the device; everything is mixed in mono
 
 bool music_stopped = true;
 unsigned int song_playing = 0;
 
 bool audio_disabled = false, music_disabled = false, samples_disabled = false;
 
+bool music_prerender = false;
+
+int audio_output_rate = 48000;
+
 static SDL_AudioDeviceID audioDevice = 0;
 
-static Uint8 musicVolume = 255;
-static Uint8 sampleVolume = 255;
+// Latest volumes, music in bits 8-15 and samples in bits 0-7.  Only the newest
+// setting matters, so the game thread overwrites it and the callback reads it once
+// per buffer; a volume change can never be dropped or reordered behind triggers.
+static SDL_atomic_t volumeSetting = { (255 << 8) | 255 };
 
 static const float volumeRange = 30.0f;  // dB
 
@@ -72,10 +78,77 @@ static size_t channelSampleCount[CHANNEL_COUNT] = { 0 };
 static Uint8 channelVolume[CHANNEL_COUNT];
 #define CHANNEL_VOLUME_LEVELS 8
 
+// Sample triggers are handed to the audio callback through a single-producer
+// (game thread), single-consumer (callback) ring, so neither side ever takes the
+// audio device lock for them.  A trigger with a sampleCount of 0 stops its channel.
+typedef struct
+{
+	Uint8 chan, vol;
+	const Sint16 *samples;
+	size_t sampleCount;
+	Uint64 stamp;  // performance counter when queued
+} AudioCommand;
+
+#define AUDIO_COMMAND_QUEUE_SIZE 128  // power of two; a few frames of triggers
+static AudioCommand audioCommands[AUDIO_COMMAND_QUEUE_SIZE];
+static SDL_atomic_t audioCommandHead;  // written only by the game thread
+static SDL_atomic_t audioCommandTail;  // written only by the callback
+static unsigned int audioCommandsDropped = 0;
+
+// Callback telemetry.  The callback keeps running totals to itself and copies
+// them out after every buffer under a sequence counter, so readers get a
+// consistent snapshot without either side taking a lock.
+typedef struct
+{
+	int frames;  // of the last buffer
+	Uint32 callbacks, intervals, underruns;
+	Uint64 callbackTicks, callbackTicksMax, callbackTicksLast;
+	Uint64 intervalTicks, intervalTicksMax;  // between callback starts
+	Uint64 ldsTicks, synthTicks;  // player updates; OPL emulation or pre-rendered copy
+} CallbackStats;
+
+static CallbackStats callbackStats;  // audio thread only
+static Uint64 lastCallbackStart = 0;
+static CallbackStats publishedStats;
+static SDL_atomic_t publishedStatsSequence;  // odd while publishedStats is being written
+static SDL_atomic_t statsResetRequested;
+
 static void audioCallback(void *userdata, Uint8 *stream, int size);
 
 static void load_song(unsigned int song_num);
 
+static void setSampleRate(int rate)
+{
+	audioSampleRate = rate;
+
+	samplesPerLdsUpdate = 2 * (audioSampleRate / ldsUpdate2Rate);
+	samplesPerLdsUpdateFrac = 2 * (audioSampleRate % ldsUpdate2Rate);
+}
+
+// The number of samples that should be produced per Loudness update is not an
+// integer, but we can only produce an integer number of samples, so we
+// accumulate the fractional samples until it amounts to a whole sample.
+static int ldsUpdateInterval(int *frac)
+{
+	int samples = samplesPerLdsUpdate;
+
+	*frac += samplesPerLdsUpdateFrac;
+	if (*frac >= ldsUpdate2Rate)
+	{
+		samples += 1;
+		*frac -= ldsUpdate2Rate;
+	}
+
+	return samples;
+}
+
+static void prerender_init(void);
+static void prerender_shutdown(void);
+static void prerender_mix(Sint16 *samples, int count);
+static void prerender_play_song(unsigned int song_num);
+static void prerender_restart(void);
+static void prerender_fade(void);
+
 bool init_audio(void)
 {
 	if (audio_disabled)
@@ -83,10 +156,13 @@ bool init_audio(void)
 
 	SDL_AudioSpec ask, got;
 
-	ask.freq = 11025 * OUTPUT_QUALITY;
+	// Ask for what the hardware most likely runs at, so that nothing resamples
+	// behind our back; music is synthesized at whatever rate we get, and the
+	// 11 kHz samples are resampled once, when they are loaded.
+	ask.freq = audio_output_rate;
 	ask.format = AUDIO_S16SYS;
-	ask.channels = 1;
-	ask.samples = 256 * OUTPUT_QUALITY; // ~23 ms
+	ask.channels = 2;
+	ask.samples = 1024; // ~21 ms at 48 kHz
 	ask.callback = audioCallback;
 
 	if (SDL_InitSubSystem(SDL_INIT_AUDIO))
@@ -109,10 +185,8 @@ bool init_audio(void)
 		return false;
 	}
 
-	audioSampleRate = got.freq;
-
-	samplesPerLdsUpdate = 2 * (audioSampleRate / ldsUpdate2Rate);
-	samplesPerLdsUpdateFrac = 2 * (audioSampleRate % ldsUpdate2Rate);
+	setSampleRate(got.freq);
+	audioChannels = got.channels;
 
 	volumeFactorTable[0] = 0;
 	for (size_t i = 1; i < 256; ++i)
@@ -120,45 +194,51 @@ bool init_audio(void)
 
 	opl_init();
 
+	if (music_prerender)
+		prerender_init();
+
 	SDL_PauseAudioDevice(audioDevice, 0); // unpause
 
 	return true;
 }
 
-static void audioCallback(void *userdata, Uint8 *stream, int size)
+#define MIX_BLOCK_FRAMES 256
+
+static void renderMusic(Sint16 *samples, int samplesCount)
 {
-	(void)userdata;
+	if (!music_disabled && !music_stopped && music_prerender)
+	{
+		const Uint64 start = SDL_GetPerformanceCounter();
 
-	Sint16 *const samples = (Sint16 *)stream;
-	const int samplesCount = size / sizeof (Sint16);
+		prerender_mix(samples, samplesCount);
 
-	if (!music_disabled && !music_stopped)
+		callbackStats.synthTicks += SDL_GetPerformanceCounter() - start;
+	}
+	else if (!music_disabled && !music_stopped)
 	{
 		Sint16 *remaining = samples;
 		int remainingCount = samplesCount;
 		while (remainingCount > 0)
 		{
+			Uint64 start = SDL_GetPerformanceCounter();
+
 			if (samplesUntilLdsUpdate == 0)
 			{
 				lds_update();
 
-				// The number of samples that should be produced per Loudness
-				// update is not an integer, but we can only produce an integer
-				// number of samples, so we accumulate the fractional samples
-				// until it amounts to a whole sample.
-				samplesUntilLdsUpdate += samplesPerLdsUpdate;
-				samplesUntilLdsUpdateFrac += samplesPerLdsUpdateFrac;
-				if (samplesUntilLdsUpdateFrac >= ldsUpdate2Rate)
-				{
-					samplesUntilLdsUpdate += 1;
-					samplesUntilLdsUpdateFrac -= ldsUpdate2Rate;
-				}
+				samplesUntilLdsUpdate += ldsUpdateInterval(&samplesUntilLdsUpdateFrac);
+
+				const Uint64 updated = SDL_GetPerformanceCounter();
+				callbackStats.ldsTicks += updated - start;
+				start = updated;
 			}
 
 			int count = MIN(samplesUntilLdsUpdate, remainingCount);
 
 			opl_update(remaining, count);
 
+			callbackStats.synthTicks += SDL_GetPerformanceCounter() - start;
+
 			remaining += count;
 			remainingCount -= count;
 
@@ -167,61 +247,206 @@ static void audioCallback(void *userdata, Uint8 *stream, int size)
 	}
 	else
 	{
-		for (int i = 0; i < samplesCount; ++i)
-			samples[i] = 0;
+		memset(samples, 0, samplesCount * sizeof(*samples));
 	}
+}
 
-	Sint32 musicVolumeFactor = volumeFactorTable[musicVolume];
-	musicVolumeFactor *= 2;  // OPL emulator is too quiet
+// Each voice is accumulated over the whole block at once.  The inner loops
+// have a constant trip count so that the compiler turns them into SIMD even
+// at -O2; MIX_LANES covers eight 32-bit lanes (two SSE/NEON registers, one AVX).
+#define MIX_LANES 8
 
-	if (samples_disabled && !music_disabled)
+static void mixVoices(Sint32 *mix, int count, const Sint32 *sampleVolumeFactors)
+{
+	for (size_t i = 0; i < CHANNEL_COUNT; ++i)
 	{
-		// Mix music
-		Sint16 *remaining = samples;
-		int remainingCount = samplesCount;
-		while (remainingCount > 0)
-		{
-			Sint32 sample = *remaining * musicVolumeFactor;
+		const int voiceCount = (int)MIN(channelSampleCount[i], (size_t)count);
+		if (voiceCount == 0)
+			continue;
+
+		const Sint16 *voice = channelSamples[i];
+		const Sint32 factor = sampleVolumeFactors[channelVolume[i]];
+
+		int j = 0;
+		for (; j + MIX_LANES <= voiceCount; j += MIX_LANES)
+			for (int k = 0; k < MIX_LANES; ++k)
+				mix[j + k] += voice[j + k] * factor;
+		for (; j < voiceCount; ++j)
+			mix[j] += voice[j] * factor;
+
+		channelSamples[i] += voiceCount;
+		channelSampleCount[i] -= voiceCount;
+	}
+}
 
-			sample = FIXED_TO_INT(sample);
-			*remaining = MIN(MAX(INT16_MIN, sample), INT16_MAX);
+static Sint16 saturate(Sint32 sample)
+{
+	sample = FIXED_TO_INT(sample);
+	return MIN(MAX(INT16_MIN, sample), INT16_MAX);
+}
 
-			remaining += 1;
-			remainingCount -= 1;
-		}
+// Mixes up to MIX_BLOCK_FRAMES frames; `sampleVolumeFactors` is NULL when
+// samples are disabled.
+static void mixBlock(Sint16 *out, int count, Sint32 musicVolumeFactor, const Sint32 *sampleVolumeFactors)
+{
+	Sint16 music[MIX_BLOCK_FRAMES];
+	Sint32 mix[MIX_BLOCK_FRAMES];
+
+	renderMusic(music, count);
+
+	const int blockEnd = count - count % MIX_LANES;
+
+	for (int j = 0; j < blockEnd; j += MIX_LANES)
+		for (int k = 0; k < MIX_LANES; ++k)
+			mix[j + k] = music[j + k] * musicVolumeFactor;
+	for (int j = blockEnd; j < count; ++j)
+		mix[j] = music[j] * musicVolumeFactor;
+
+	if (sampleVolumeFactors != NULL)
+		mixVoices(mix, count, sampleVolumeFactors);
+
+	if (audioChannels == 2)
+	{
+		for (int j = 0; j < blockEnd; j += MIX_LANES)
+			for (int k = 0; k < MIX_LANES; ++k)
+				out[2 * (j + k)] = out[2 * (j + k) + 1] = saturate(mix[j + k]);
+		for (int j = blockEnd; j < count; ++j)
+			out[2 * j] = out[2 * j + 1] = saturate(mix[j]);
 	}
-	else if (!samples_disabled)
+	else
 	{
-		Sint32 sampleVolumeFactor = volumeFactorTable[sampleVolume];
-		Sint32 sampleVolumeFactors[CHANNEL_VOLUME_LEVELS];
-		for (int i = 0; i < CHANNEL_VOLUME_LEVELS; ++i)
-			sampleVolumeFactors[i] = sampleVolumeFactor * (i + 1) / CHANNEL_VOLUME_LEVELS;
+		for (int j = 0; j < blockEnd; j += MIX_LANES)
+			for (int k = 0; k < MIX_LANES; ++k)
+				out[j + k] = saturate(mix[j + k]);
+		for (int j = blockEnd; j < count; ++j)
+			out[j] = saturate(mix[j]);
+	}
+}
 
-		// Mix music and channels
-		Sint16 *remaining = samples;
-		int remainingCount = samplesCount;
-		while (remainingCount > 0)
-		{
-			Sint32 sample = *remaining * musicVolumeFactor;
+static void mixFrames(Sint16 *out, int from, int to, Sint32 musicVolumeFactor, const Sint32 *sampleVolumeFactors)
+{
+	while (from < to)
+	{
+		const int count = MIN(to - from, MIX_BLOCK_FRAMES);
+		mixBlock(out + from * audioChannels, count, musicVolumeFactor, sampleVolumeFactors);
+		from += count;
+	}
+}
 
-			for (size_t i = 0; i < CHANNEL_COUNT; ++i)
-			{
-				if (channelSampleCount[i] > 0)
-				{
-					sample += *channelSamples[i] * sampleVolumeFactors[channelVolume[i]];
+static void startChannel(const AudioCommand *command)
+{
+	channelSamples[command->chan] = command->samples;
+	channelSampleCount[command->chan] = command->sampleCount;
+	channelVolume[command->chan] = command->vol;
+}
 
-					channelSamples[i] += 1;
-					channelSampleCount[i] -= 1;
-				}
-			}
+// Where in this buffer a trigger should start.  The callback runs once per
+// buffer, so a trigger queued while the previous buffer was playing is placed
+// one buffer after it was queued; that keeps triggers from the same frame (or
+// from consecutive frames) the same distance apart as when they were issued,
+// instead of snapping them all to the start of the next buffer.
+static int commandOffset(const AudioCommand *command, Uint64 now, int framesCount)
+{
+	if (command->stamp >= now)
+		return framesCount;
 
-			sample = FIXED_TO_INT(sample);
-			*remaining = MIN(MAX(INT16_MIN, sample), INT16_MAX);
+	const Uint64 age = (now - command->stamp) * audioSampleRate / SDL_GetPerformanceFrequency();
 
-			remaining += 1;
-			remainingCount -= 1;
-		}
+	return age >= (Uint64)framesCount ? 0 : framesCount - (int)age;
+}
+
+// SDL paces the callback by how fast the device drains its buffers, so a
+// callback that starts more than half a buffer late, or that takes longer
+// than a buffer plays for, means the device most likely ran dry.
+static void updateCallbackStats(Uint64 start, int framesCount)
+{
+	const Uint64 end = SDL_GetPerformanceCounter();
+	const Uint64 bufferTicks = (Uint64)framesCount * SDL_GetPerformanceFrequency() / audioSampleRate;
+
+	CallbackStats *stats = &callbackStats;
+
+	const Uint64 ticks = end - start;
+	stats->frames = framesCount;
+	stats->callbacks += 1;
+	stats->callbackTicks += ticks;
+	stats->callbackTicksMax = MAX(stats->callbackTicksMax, ticks);
+	stats->callbackTicksLast = ticks;
+
+	bool underrun = ticks > bufferTicks;
+
+	if (lastCallbackStart != 0)
+	{
+		const Uint64 interval = start - lastCallbackStart;
+		stats->intervals += 1;
+		stats->intervalTicks += interval;
+		stats->intervalTicksMax = MAX(stats->intervalTicksMax, interval);
+
+		underrun = underrun || interval > bufferTicks + bufferTicks / 2;
+	}
+	lastCallbackStart = start;
+
+	if (underrun)
+		stats->underruns += 1;
+
+	SDL_AtomicAdd(&publishedStatsSequence, 1);
+	SDL_MemoryBarrierRelease();
+	publishedStats = *stats;
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicAdd(&publishedStatsSequence, 1);
+}
+
+static void audioCallback(void *userdata, Uint8 *stream, int size)
+{
+	(void)userdata;
+
+	Sint16 *const out = (Sint16 *)stream;
+	const int framesCount = size / (sizeof (Sint16) * audioChannels);
+
+	// Take everything queued so far; commands queued while we mix wait for the
+	// next buffer.  Slots stay ours until the tail is published below.
+	const unsigned int commandTail = SDL_AtomicGet(&audioCommandTail);
+	const unsigned int commandHead = SDL_AtomicGet(&audioCommandHead);
+	SDL_MemoryBarrierAcquire();
+	const Uint64 now = SDL_GetPerformanceCounter();
+
+	if (SDL_AtomicCAS(&statsResetRequested, 1, 0))
+	{
+		memset(&callbackStats, 0, sizeof(callbackStats));
+		lastCallbackStart = 0;
 	}
+
+	const int volume = SDL_AtomicGet(&volumeSetting);
+	const Uint8 musicVolume = (volume >> 8) & 0xff;
+	const Uint8 sampleVolume = volume & 0xff;
+
+	Sint32 musicVolumeFactor = volumeFactorTable[musicVolume];
+	musicVolumeFactor *= 2;  // OPL emulator is too quiet
+
+	Sint32 sampleVolumeFactor = volumeFactorTable[sampleVolume];
+	Sint32 sampleVolumeFactors[CHANNEL_VOLUME_LEVELS];
+	for (int i = 0; i < CHANNEL_VOLUME_LEVELS; ++i)
+		sampleVolumeFactors[i] = sampleVolumeFactor * (i + 1) / CHANNEL_VOLUME_LEVELS;
+
+	const Sint32 *const voiceFactors = samples_disabled ? NULL : sampleVolumeFactors;
+
+	// Mix music and channels, starting each queued trigger at its offset
+	int mixed = 0;
+	for (unsigned int i = commandTail; i != commandHead; ++i)
+	{
+		const AudioCommand *command = &audioCommands[i & (AUDIO_COMMAND_QUEUE_SIZE - 1)];
+
+		const int offset = MAX(mixed, commandOffset(command, now, framesCount));
+		mixFrames(out, mixed, offset, musicVolumeFactor, voiceFactors);
+		mixed = offset;
+
+		startChannel(command);
+	}
+	mixFrames(out, mixed, framesCount, musicVolumeFactor, voiceFactors);
+
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&audioCommandTail, commandHead);
+
+	updateCallbackStats(now, framesCount);
 }
 
 void deinit_audio(void)
@@ -239,6 +464,9 @@ void deinit_audio(void)
 	SDL_QuitSubSystem(SDL_INIT_AUDIO);
 
 	memset(channelSampleCount, 0, sizeof channelSampleCount);
+	SDL_AtomicSet(&audioCommandTail, SDL_AtomicGet(&audioCommandHead));
+
+	prerender_shutdown();  // the renderer owns the player until it exits
 
 	lds_free();
 }
@@ -247,6 +475,8 @@ void load_music(void)  // FKA NortSong.loadSong
 {
 	if (music_file == NULL)
 	{
+		const Uint64 report_start = startup_report_clock();
+
 		music_file = dir_fopen_die(data_dir(), "music.mus", "rb");
 
 		fread_u16_die(&song_count, 1, music_file);
@@ -256,6 +486,8 @@ void load_music(void)  // FKA NortSong.loadSong
 		fread_u32_die(song_offset, song_count, music_file);
 
 		song_offset[song_count] = ftell_eof(music_file);
+
+		startup_report_file("music.mus (offsets)", ftell(music_file), report_start);
 	}
 }
 
@@ -277,6 +509,12 @@ void play_song(unsigned int song_num)  // FKA NortSong.playSong
 	if (audio_disabled)
 		return;
 
+	if (music_prerender)
+	{
+		prerender_play_song(song_num);
+		return;
+	}
+
 	if (song_num != song_playing)
 	{
 		SDL_LockAudioDevice(audioDevice);
@@ -302,6 +540,12 @@ void restart_song(void)  // FKA Player.selectSong(1)
 	if (audio_disabled)
 		return;
 
+	if (music_prerender)
+	{
+		prerender_restart();
+		return;
+	}
+
 	SDL_LockAudioDevice(audioDevice);
 
 	lds_rewind();
@@ -328,6 +572,12 @@ void fade_song(void)  // FKA Player.selectSong($C001)
 	if (audio_disabled)
 		return;
 
+	if (music_prerender)
+	{
+		prerender_fade();
+		return;
+	}
+
 	SDL_LockAudioDevice(audioDevice);
 
 	lds_fade(1);
@@ -335,17 +585,34 @@ void fade_song(void)  // FKA Player.selectSong($C001)
 	SDL_UnlockAudioDevice(audioDevice);
 }
 
+// Called only from the game thread.  Returns NULL when the callback has
+// fallen a whole queue behind; the command is dropped rather than waited for.
+static AudioCommand *beginAudioCommand(void)
+{
+	const unsigned int head = SDL_AtomicGet(&audioCommandHead);
+	if (head - (unsigned int)SDL_AtomicGet(&audioCommandTail) >= AUDIO_COMMAND_QUEUE_SIZE)
+	{
+		++audioCommandsDropped;
+		return NULL;
+	}
+
+	AudioCommand *command = &audioCommands[head & (AUDIO_COMMAND_QUEUE_SIZE - 1)];
+	command->stamp = SDL_GetPerformanceCounter();
+	return command;
+}
+
+static void commitAudioCommand(void)
+{
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicAdd(&audioCommandHead, 1);
+}
+
 void set_volume(Uint8 musicVolume_, Uint8 sampleVolume_)  // FKA NortSong.setVol and Player.setVol
 {
 	if (audio_disabled)
 		return;
 
-	SDL_LockAudioDevice(audioDevice);
-
-	musicVolume = musicVolume_;
-	sampleVolume = sampleVolume_;
-
-	SDL_UnlockAudioDevice(audioDevice);
+	SDL_AtomicSet(&volumeSetting, (musicVolume_ << 8) | sampleVolume_);
 }
 
 void multiSamplePlay(const Sint16 *samples, size_t sampleCount, Uint8 chan, Uint8 vol)  // FKA Player.multiSamplePlay
@@ -353,14 +620,762 @@ void multiSamplePlay(const Sint16 *samples, size_t sampleCount, Uint8 chan, Uint
 	assert(chan < CHANNEL_COUNT);
 	assert(vol < CHANNEL_VOLUME_LEVELS);
 
-	if (audio_disabled || samples_disabled)
+	if (audio_disabled || samples_disabled || audioDevice == 0)
+		return;
+
+	AudioCommand *command = beginAudioCommand();
+	if (command == NULL)
+		return;
+
+	command->chan = chan;
+	command->vol = vol;
+	command->samples = samples;
+	command->sampleCount = sampleCount;
+
+	commitAudioCommand();
+}
+
+static double ticksToMs(Uint64 ticks)
+{
+	return ticks * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+bool audio_get_stats(AudioStats *stats)
+{
+	if (audio_disabled || audioDevice == 0)
+		return false;
+
+	CallbackStats snapshot;
+	for (; ; )
+	{
+		const int sequence = SDL_AtomicGet(&publishedStatsSequence);
+		SDL_MemoryBarrierAcquire();
+		if (sequence & 1)
+			continue;
+
+		snapshot = publishedStats;
+
+		SDL_MemoryBarrierAcquire();
+		if (SDL_AtomicGet(&publishedStatsSequence) == sequence)
+			break;
+	}
+
+	stats->rate = audioSampleRate;
+	stats->channels = audioChannels;
+	stats->frames = snapshot.frames;
+	stats->callbacks = snapshot.callbacks;
+	stats->underruns = snapshot.underruns;
+	stats->dropped = audioCommandsDropped;
+
+	stats->callback_ms_avg = snapshot.callbacks > 0 ? ticksToMs(snapshot.callbackTicks) / snapshot.callbacks : 0;
+	stats->callback_ms_max = ticksToMs(snapshot.callbackTicksMax);
+	stats->callback_ms_last = ticksToMs(snapshot.callbackTicksLast);
+	stats->interval_ms_avg = snapshot.intervals > 0 ? ticksToMs(snapshot.intervalTicks) / snapshot.intervals : 0;
+	stats->interval_ms_max = ticksToMs(snapshot.intervalTicksMax);
+
+	stats->lds_ms = ticksToMs(snapshot.ldsTicks);
+	stats->synth_ms = ticksToMs(snapshot.synthTicks);
+	stats->mix_ms = ticksToMs(snapshot.callbackTicks - MIN(snapshot.callbackTicks, snapshot.ldsTicks + snapshot.synthTicks));
+
+	return true;
+}
+
+void audio_reset_stats(void)
+{
+	audioCommandsDropped = 0;
+	SDL_AtomicSet(&statsResetRequested, 1);
+}
+
+// Offline rendering
+
+static void write_wav_header(FILE *f, Uint32 sample_rate, Uint32 sample_count)
+{
+	const Uint16 channels = 1, bits = 16;
+	const Uint16 block_align = channels * bits / 8;
+	const Uint32 byte_rate = sample_rate * block_align;
+	const Uint32 data_size = sample_count * block_align;
+	const Uint32 riff_size = 36 + data_size;
+	const Uint32 fmt_size = 16;
+	const Uint16 format_pcm = 1;
+
+	fwrite_die("RIFF", 1, 4, f);
+	fwrite_u32_die(&riff_size, f);
+	fwrite_die("WAVE", 1, 4, f);
+	fwrite_die("fmt ", 1, 4, f);
+	fwrite_u32_die(&fmt_size, f);
+	fwrite_u16_die(&format_pcm, f);
+	fwrite_u16_die(&channels, f);
+	fwrite_u32_die(&sample_rate, f);
+	fwrite_u32_die(&byte_rate, f);
+	fwrite_u16_die(&block_align, f);
+	fwrite_u16_die(&bits, f);
+	fwrite_die("data", 1, 4, f);
+	fwrite_u32_die(&data_size, f);
+}
+
+/* Opens a WAV written by write_wav_header and leaves it at the first sample. */
+static FILE *open_wav(const char *path, Uint32 *sample_rate, Uint32 *sample_count)
+{
+	FILE *f = fopen(path, "rb");
+	if (f == NULL)
+		return NULL;
+
+	Uint8 header[44];
+	if (fread(header, 1, sizeof(header), f) != sizeof(header) ||
+	    memcmp(header, "RIFF", 4) != 0 || memcmp(header + 8, "WAVE", 4) != 0 || memcmp(header + 36, "data", 4) != 0 ||
+	    view_read_u16(header + 22) != 1 || view_read_u16(header + 34) != 16)
+	{
+		fclose(f);
+		return NULL;
+	}
+
+	*sample_rate = view_read_u32(header + 24);
+	*sample_count = view_read_u32(header + 40) / sizeof(Sint16);
+	return f;
+}
+
+static bool render_one_song(unsigned int song_num, unsigned int seconds, const char *wav_path, const char *compare_path)
+{
+	static Sint16 buffer[4096];
+	static Sint16 expected[COUNTOF(buffer)];
+
+	FILE *f = NULL;
+	if (wav_path != NULL)
+	{
+		f = fopen(wav_path, "wb");
+		if (f == NULL)
+		{
+			fprintf(stderr, "error: failed to open '%s' for writing\n", wav_path);
+			return false;
+		}
+		write_wav_header(f, audioSampleRate, 0);  // sizes are patched once known
+	}
+
+	FILE *cf = NULL;
+	Uint32 expected_count = 0;
+	if (compare_path != NULL)
+	{
+		Uint32 expected_rate;
+		cf = open_wav(compare_path, &expected_rate, &expected_count);
+		if (cf == NULL || expected_rate != (Uint32)audioSampleRate)
+		{
+			fprintf(stderr, "error: '%s' is not a %d Hz render to compare against\n", compare_path, audioSampleRate);
+			if (cf != NULL)
+				fclose(cf);
+			if (f != NULL)
+				fclose(f);
+			return false;
+		}
+	}
+
+	load_song(song_num);
+
+	const Uint32 total = seconds * (Uint32)audioSampleRate;
+	Uint32 rendered = 0;
+	Uint64 render_ticks = 0;  // excludes file input and output
+
+	Uint32 mismatches = 0, first_mismatch = 0;
+
+	int untilUpdate = 0;
+	int untilUpdateFrac = 0;
+
+	while (rendered < total)
+	{
+		const Uint64 start = SDL_GetPerformanceCounter();
+
+		size_t filled = 0;
+		while (filled < COUNTOF(buffer) && rendered + filled < total)
+		{
+			if (untilUpdate == 0)
+			{
+				lds_update();
+
+				untilUpdate += ldsUpdateInterval(&untilUpdateFrac);
+			}
+
+			const size_t count = MIN(MIN((size_t)untilUpdate, COUNTOF(buffer) - filled), total - rendered - filled);
+
+			opl_update(buffer + filled, count);
+
+			filled += count;
+			untilUpdate -= count;
+		}
+
+		render_ticks += SDL_GetPerformanceCounter() - start;
+
+		if (cf != NULL)
+		{
+			const size_t count = fread(expected, sizeof(Sint16), filled, cf);
+			for (size_t i = 0; i < filled; ++i)
+			{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+				if (i < count)
+					expected[i] = SDL_Swap16(expected[i]);
+#endif
+				if (i >= count || expected[i] != buffer[i])
+				{
+					if (mismatches == 0)
+						first_mismatch = rendered + i;
+					mismatches += 1;
+				}
+			}
+		}
+
+		if (f != NULL)
+		{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+			for (size_t i = 0; i < filled; ++i)
+				buffer[i] = SDL_Swap16(buffer[i]);
+#endif
+			fwrite_die(buffer, sizeof(Sint16), filled, f);
+		}
+
+		rendered += filled;
+	}
+
+	if (f != NULL)
+	{
+		fseek(f, 0, SEEK_SET);
+		write_wav_header(f, audioSampleRate, rendered);
+		fclose(f);
+	}
+
+	if (cf != NULL)
+	{
+		fclose(cf);
+
+		if (mismatches == 0 && expected_count != rendered)
+		{
+			first_mismatch = MIN(expected_count, rendered);
+			mismatches = 1;  // same samples, different length
+		}
+	}
+
+	const double ms = render_ticks * 1000.0 / SDL_GetPerformanceFrequency();
+	const double samples_per_second = ms > 0 ? rendered * 1000.0 / ms : 0;
+
+	printf("rendered song %d: %u samples at %d Hz in %.2f ms (%.0f samples/s, %.1fx real time)\n",
+	       song_num + 1, (unsigned int)rendered, audioSampleRate, ms, samples_per_second, samples_per_second / audioSampleRate);
+	if (f != NULL)
+		printf("wrote %s\n", wav_path);
+	if (cf != NULL && mismatches == 0)
+		printf("identical to %s\n", compare_path);
+	else if (cf != NULL)
+		printf("differs from %s: %u samples, first at sample %u\n", compare_path, (unsigned int)mismatches, (unsigned int)first_mismatch);
+
+	// one line, so benchmark scripts can grep for it
+	printf("{\"render_song\":{\"song\":%d,\"rate\":%d,\"samples\":%u,\"ms\":%.3f,\"samples_per_second\":%.0f,\"realtime\":%.2f",
+	       song_num + 1, audioSampleRate, (unsigned int)rendered, ms, samples_per_second, samples_per_second / audioSampleRate);
+	if (cf != NULL)
+		printf(",\"mismatches\":%u", (unsigned int)mismatches);
+	printf("}}\n");
+
+	return mismatches == 0;
+}
+
+bool render_song_offline(int song_num, unsigned int seconds, const char *wav_path, const char *compare_path)
+{
+	if (audioSampleRate == 0)
+		setSampleRate(audio_output_rate);
+
+	load_music();
+
+	bool ok = true;
+
+	if (song_num >= 0)
+	{
+		if ((unsigned int)song_num >= song_count)
+		{
+			fprintf(stderr, "error: there is no song %d\n", song_num + 1);
+			ok = false;
+		}
+		else
+		{
+			ok = render_one_song(song_num, seconds, wav_path, compare_path);
+		}
+	}
+	else
+	{
+		// every song; the paths name directories
+		unsigned int failed = 0;
+		for (unsigned int i = 0; i < song_count; ++i)
+		{
+			char wav_file[1024], compare_file[1024];
+			if (wav_path != NULL)
+				snprintf(wav_file, sizeof(wav_file), "%s/song%02u.wav", wav_path, i + 1);
+			if (compare_path != NULL)
+				snprintf(compare_file, sizeof(compare_file), "%s/song%02u.wav", compare_path, i + 1);
+
+			if (!render_one_song(i, seconds, wav_path != NULL ? wav_file : NULL, compare_path != NULL ? compare_file : NULL))
+				failed += 1;
+		}
+
+		if (compare_path != NULL)
+			printf("%u of %u songs differ from %s\n", failed, (unsigned int)song_count, compare_path);
+		ok = failed == 0;
+	}
+
+	lds_free();
+
+	return ok;
+}
+
+// Pre-rendered music
+//
+// With --prerender-music, a render thread owns the Loudness player and the OPL
+// emulator and renders each requested song into memory once, up to the point
+// where it loops.  The audio callback then only copies PCM.  Playback may start
+// as soon as the first samples are rendered, since the renderer runs far ahead
+// of real time.
+
+#define PCM_CHUNK_SAMPLES 65536
+#define PRERENDER_MAX_SECONDS 300
+#define PRERENDER_TAIL_SECONDS 1  // rendered after a song stops itself
+#define PRERENDER_BUDGET (64 * 1024 * 1024)  // bytes of cached PCM
+#define PRERENDER_FADE_UPDATES 64  // about as long as lds_fade(1) takes to silence
+
+typedef struct
+{
+	Sint16 **chunks;  // PCM_CHUNK_SAMPLES each; pointer table sized for PRERENDER_MAX_SECONDS
+	size_t chunk_slots;
+	size_t chunks_allocated;  // renderer only
+	SDL_atomic_t rendered;  // samples ready for playback
+	SDL_atomic_t done;
+	size_t loop_start, loop_end;  // valid once done; loop_end == 0 if the song doesn't loop
+	Uint32 last_used;
+} SongPcm;
+
+static SongPcm **song_pcm = NULL;  // indexed by song; guarded by prerender_mutex
+static Uint32 song_pcm_clock = 0;
+
+static SDL_Thread *prerender_thread = NULL;
+static SDL_mutex *prerender_mutex = NULL;
+static SDL_cond *prerender_cond = NULL;
+static SDL_atomic_t prerender_request;  // song to render, or -1
+static int prerender_current = -1;  // song the callback is playing
+static bool prerender_quit = false;
+
+// owned by the audio callback; changed by the main thread only with the device locked
+static SongPcm *playback_pcm = NULL;
+static size_t playback_pos = 0;
+static int playback_fade = 0;  // samples left in a fade, or -1 once faded out
+static int playback_fade_length = 1;
+static bool playback_looped = false, playback_ended = false;
+
+static SongPcm *song_pcm_new(void)
+{
+	SongPcm *pcm = calloc(1, sizeof(*pcm));
+	if (pcm == NULL)
+		return NULL;
+
+	pcm->chunk_slots = (size_t)PRERENDER_MAX_SECONDS * audioSampleRate / PCM_CHUNK_SAMPLES + 1;
+	pcm->chunks = calloc(pcm->chunk_slots, sizeof(*pcm->chunks));
+	if (pcm->chunks == NULL)
+	{
+		free(pcm);
+		return NULL;
+	}
+
+	SDL_AtomicSet(&pcm->rendered, 0);
+	SDL_AtomicSet(&pcm->done, 0);
+
+	return pcm;
+}
+
+static void song_pcm_free(SongPcm *pcm)
+{
+	if (pcm == NULL)
 		return;
 
+	for (size_t i = 0; i < pcm->chunks_allocated; ++i)
+		free(pcm->chunks[i]);
+	free(pcm->chunks);
+	free(pcm);
+}
+
+/* Called with prerender_mutex held.  Drops the least recently played songs until
+   another full-length song would fit in the budget. */
+static void prerender_evict(unsigned int keep)
+{
+	const size_t chunk_bytes = PCM_CHUNK_SAMPLES * sizeof(Sint16);
+	const size_t song_bytes = (size_t)PRERENDER_MAX_SECONDS * audioSampleRate * sizeof(Sint16);
+
+	for (; ; )
+	{
+		size_t total = 0;
+		int oldest = -1;
+		for (unsigned int i = 0; i < song_count; ++i)
+		{
+			if (song_pcm[i] == NULL)
+				continue;
+
+			total += song_pcm[i]->chunks_allocated * chunk_bytes;
+
+			if (i != keep && (int)i != prerender_current &&
+			    (oldest < 0 || (Sint32)(song_pcm[i]->last_used - song_pcm[oldest]->last_used) < 0))
+				oldest = i;
+		}
+
+		if (total + song_bytes <= PRERENDER_BUDGET || oldest < 0)
+			break;
+
+		song_pcm_free(song_pcm[oldest]);
+		song_pcm[oldest] = NULL;
+	}
+}
+
+/* Renders a song from the start.  Samples a previous, abandoned render already
+   published are rendered again but not stored, so playback of them is undisturbed.
+   Returns false if another song was requested first. */
+static bool render_song(unsigned int song_num, SongPcm *pcm)
+{
+	static Sint16 scratch[PCM_CHUNK_SAMPLES];
+
+	load_song(song_num);  // also rewinds the player and resets the OPL chip
+
+	const size_t skip = SDL_AtomicGet(&pcm->rendered);
+	const size_t max_samples = pcm->chunk_slots * PCM_CHUNK_SAMPLES;
+
+	// sample index at which each position first started playing; a position
+	// that starts again means the song has looped back to it
+	size_t first_start[256];
+	for (size_t i = 0; i < COUNTOF(first_start); ++i)
+		first_start[i] = SIZE_MAX;
+
+	size_t rendered = 0;
+	size_t tail_end = 0;
+	size_t loop_start = 0, loop_end = 0;
+
+	int untilUpdate = 0;
+	int untilUpdateFrac = 0;
+
+	for (; ; )
+	{
+		if (untilUpdate == 0)
+		{
+			if (SDL_AtomicGet(&prerender_request) != (int)song_num)
+				return false;
+
+			if (!playing)
+			{
+				if (tail_end == 0)
+					tail_end = rendered + PRERENDER_TAIL_SECONDS * audioSampleRate;
+			}
+			else
+			{
+				unsigned int position, row, next_position, next_row;
+				lds_get_position(&position, &row);
+				lds_update();
+				lds_get_position(&next_position, &next_row);
+
+				if ((next_position != position || next_row != row) && row == 0)
+				{
+					if (first_start[position] != SIZE_MAX)
+					{
+						loop_start = first_start[position];
+						loop_end = rendered;
+						break;
+					}
+					first_start[position] = rendered;
+				}
+			}
+
+			untilUpdate += ldsUpdateInterval(&untilUpdateFrac);
+		}
+
+		if (tail_end != 0 && rendered >= tail_end)
+			break;
+
+		if (rendered >= max_samples)
+		{
+			loop_end = rendered;  // too long to find the loop; repeat what we have
+			break;
+		}
+
+		const size_t chunk = rendered / PCM_CHUNK_SAMPLES;
+		const size_t offset = rendered % PCM_CHUNK_SAMPLES;
+
+		size_t count = MIN((size_t)untilUpdate, PCM_CHUNK_SAMPLES - offset);
+		if (tail_end != 0)
+			count = MIN(count, tail_end - rendered);
+
+		Sint16 *out;
+		if (rendered < skip)
+		{
+			count = MIN(count, skip - rendered);
+			out = scratch + offset;
+		}
+		else
+		{
+			if (chunk == pcm->chunks_allocated)
+			{
+				pcm->chunks[chunk] = malloc(PCM_CHUNK_SAMPLES * sizeof(Sint16));
+				if (pcm->chunks[chunk] == NULL)
+				{
+					fprintf(stderr, "warning: out of memory pre-rendering song %d\n", song_num + 1);
+					loop_end = rendered;
+					break;
+				}
+				pcm->chunks_allocated += 1;
+			}
+			out = pcm->chunks[chunk] + offset;
+		}
+
+		opl_update(out, count);
+
+		rendered += count;
+		untilUpdate -= count;
+
+		if (rendered > skip)
+		{
+			SDL_MemoryBarrierRelease();
+			SDL_AtomicSet(&pcm->rendered, rendered);
+		}
+	}
+
+	pcm->loop_start = loop_start;
+	pcm->loop_end = loop_end;
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&pcm->rendered, MAX(rendered, skip));
+	SDL_AtomicSet(&pcm->done, 1);
+
+	return true;
+}
+
+static int SDLCALL prerender_main(void *data)
+{
+	(void)data;
+
+	SDL_LockMutex(prerender_mutex);
+	for (; ; )
+	{
+		const int song_num = SDL_AtomicGet(&prerender_request);
+		SongPcm *pcm = song_num >= 0 ? song_pcm[song_num] : NULL;
+
+		if (prerender_quit)
+			break;
+
+		if (pcm == NULL || SDL_AtomicGet(&pcm->done))
+		{
+			SDL_AtomicCAS(&prerender_request, song_num, -1);
+			SDL_CondWait(prerender_cond, prerender_mutex);
+			continue;
+		}
+
+		prerender_evict(song_num);
+		SDL_UnlockMutex(prerender_mutex);
+
+		render_song(song_num, pcm);
+
+		SDL_LockMutex(prerender_mutex);
+	}
+	SDL_UnlockMutex(prerender_mutex);
+
+	return 0;
+}
+
+static void prerender_init(void)
+{
+	SDL_AtomicSet(&prerender_request, -1);
+
+	prerender_mutex = SDL_CreateMutex();
+	prerender_cond = SDL_CreateCond();
+	if (prerender_mutex != NULL && prerender_cond != NULL)
+	{
+		prerender_quit = false;
+		prerender_thread = SDL_CreateThread(prerender_main, "prerender", NULL);
+	}
+
+	if (prerender_thread == NULL)
+	{
+		fprintf(stderr, "warning: music will not be pre-rendered: %s\n", SDL_GetError());
+		prerender_shutdown();
+		music_prerender = false;
+	}
+}
+
+static void prerender_shutdown(void)
+{
+	if (prerender_thread != NULL)
+	{
+		SDL_LockMutex(prerender_mutex);
+		prerender_quit = true;
+		SDL_AtomicSet(&prerender_request, -1);  // abandons a render in progress
+		SDL_CondSignal(prerender_cond);
+		SDL_UnlockMutex(prerender_mutex);
+
+		SDL_WaitThread(prerender_thread, NULL);
+		prerender_thread = NULL;
+	}
+
+	if (prerender_cond != NULL)
+	{
+		SDL_DestroyCond(prerender_cond);
+		prerender_cond = NULL;
+	}
+	if (prerender_mutex != NULL)
+	{
+		SDL_DestroyMutex(prerender_mutex);
+		prerender_mutex = NULL;
+	}
+
+	if (song_pcm != NULL)
+	{
+		for (unsigned int i = 0; i < song_count; ++i)
+			song_pcm_free(song_pcm[i]);
+		free(song_pcm);
+		song_pcm = NULL;
+	}
+
+	playback_pcm = NULL;
+	prerender_current = -1;
+}
+
+static void prerender_mix(Sint16 *samples, int count)
+{
+	SongPcm *const pcm = playback_pcm;
+
+	int filled = 0;
+
+	if (pcm != NULL)
+	{
+		// read `done` first; once it is set, `rendered` and the loop points are final
+		const bool done = SDL_AtomicGet(&pcm->done);
+		const size_t rendered = SDL_AtomicGet(&pcm->rendered);
+		SDL_MemoryBarrierAcquire();
+
+		const size_t end = done && pcm->loop_end != 0 ? pcm->loop_end : rendered;
+
+		while (filled < count)
+		{
+			if (playback_pos >= end)
+			{
+				if (!done)
+					break;  // underrun; the renderer is still catching up
+
+				if (pcm->loop_end == 0)
+				{
+					playback_ended = true;
+					break;
+				}
+
+				playback_pos = pcm->loop_start;
+				playback_looped = true;
+			}
+
+			const size_t offset = playback_pos % PCM_CHUNK_SAMPLES;
+			const size_t n = MIN(MIN((size_t)(count - filled), end - playback_pos), PCM_CHUNK_SAMPLES - offset);
+
+			memcpy(samples + filled, pcm->chunks[playback_pos / PCM_CHUNK_SAMPLES] + offset, n * sizeof(Sint16));
+
+			filled += n;
+			playback_pos += n;
+		}
+	}
+
+	for (int i = filled; i < count; ++i)
+		samples[i] = 0;
+
+	if (playback_fade < 0)
+	{
+		for (int i = 0; i < filled; ++i)
+			samples[i] = 0;
+	}
+	else if (playback_fade > 0)
+	{
+		for (int i = 0; i < filled; ++i)
+		{
+			samples[i] = (Sint32)samples[i] * playback_fade / playback_fade_length;
+
+			if (playback_fade > 0)
+				playback_fade -= 1;
+		}
+
+		if (playback_fade == 0)
+			playback_fade = -1;
+	}
+}
+
+static void prerender_play_song(unsigned int song_num)
+{
+	SDL_LockMutex(prerender_mutex);
+
+	if (song_pcm == NULL && song_count > 0)
+		song_pcm = calloc(song_count, sizeof(*song_pcm));
+
+	SongPcm *pcm = NULL;
+	if (song_pcm != NULL && song_num < song_count)
+	{
+		if (song_pcm[song_num] == NULL)
+			song_pcm[song_num] = song_pcm_new();
+		pcm = song_pcm[song_num];
+	}
+
+	if (pcm == NULL)
+		fprintf(stderr, "warning: failed to load song %d\n", song_num + 1);
+	else
+		pcm->last_used = ++song_pcm_clock;
+
 	SDL_LockAudioDevice(audioDevice);
 
-	channelSamples[chan] = samples;
-	channelSampleCount[chan] = sampleCount;
-	channelVolume[chan] = vol;
+	if (song_num != song_playing || playback_pcm != pcm)
+	{
+		playback_pcm = pcm;
+		playback_pos = 0;
+		playback_fade = 0;
+		playback_looped = false;
+		playback_ended = false;
+	}
+
+	music_stopped = false;
 
 	SDL_UnlockAudioDevice(audioDevice);
+
+	song_playing = song_num;
+	prerender_current = pcm != NULL ? (int)song_num : -1;
+
+	if (pcm != NULL && !SDL_AtomicGet(&pcm->done))
+	{
+		SDL_AtomicSet(&prerender_request, song_num);
+		SDL_CondSignal(prerender_cond);
+	}
+
+	SDL_UnlockMutex(prerender_mutex);
+}
+
+static void prerender_restart(void)
+{
+	SDL_LockAudioDevice(audioDevice);
+
+	playback_pos = 0;
+	playback_fade = 0;
+	playback_looped = false;
+	playback_ended = false;
+
+	music_stopped = false;
+
+	SDL_UnlockAudioDevice(audioDevice);
+}
+
+static void prerender_fade(void)
+{
+	SDL_LockAudioDevice(audioDevice);
+
+	if (playback_fade == 0)
+	{
+		playback_fade_length = MAX(1, PRERENDER_FADE_UPDATES * samplesPerLdsUpdate);
+		playback_fade = playback_fade_length;
+	}
+
+	SDL_UnlockAudioDevice(audioDevice);
+}
+
+bool song_is_playing(void)
+{
+	return music_prerender ? playback_pcm != NULL && !playback_ended : playing;
+}
+
+bool song_has_looped(void)
+{
+	return music_prerender ? playback_looped : songlooped;
 }
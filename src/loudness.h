@@ -29,6 +29,8 @@ extern int audioSampleRate;
 extern unsigned int song_playing;
 
 extern bool audio_disabled, music_disabled, samples_disabled;
+extern bool music_prerender;
+extern int audio_output_rate;  // requested; audioSampleRate is what the device gave us
 
 bool init_audio(void);
 void deinit_audio(void);
@@ -39,8 +41,37 @@ void restart_song(void);
 void stop_song(void);
 void fade_song(void);
 
+/* Whether the current song is still going, and whether it has looped back at least
+   once.  These follow playback rather than the player when music is pre-rendered. */
+bool song_is_playing(void);
+bool song_has_looped(void);
+
 void set_volume(Uint8 musicVolume, Uint8 sampleVolume);
 
+/* Renders a song (or every song, for -1) without an audio device, straight from
+   the player and the OPL emulator, and prints the synthesis throughput.  Writes a
+   16-bit mono WAV unless `wav_path` is NULL, and compares the output sample by
+   sample with an earlier render unless `compare_path` is NULL; for every song,
+   both name directories.  Returns false on error or mismatch.  Not for use while
+   audio is running. */
+bool render_song_offline(int song_num, unsigned int seconds, const char *wav_path, const char *compare_path);
+
 void multiSamplePlay(const Sint16 *samples, size_t sampleCount, Uint8 chan, Uint8 vol);
 
+typedef struct
+{
+	int rate, channels, frames;  // device format and buffer size
+	unsigned int callbacks;
+	unsigned int underruns;      // estimated from late or overlong callbacks
+	unsigned int dropped;        // sample triggers lost to a full queue
+	double callback_ms_avg, callback_ms_max, callback_ms_last;
+	double interval_ms_avg, interval_ms_max;  // between callbacks
+	double lds_ms, synth_ms, mix_ms;          // totals: player, OPL (or pre-rendered copy), the rest
+} AudioStats;
+
+/* Copies the audio callback timings gathered since the last reset.  Never blocks
+   the callback.  Returns false when there is no audio device. */
+bool audio_get_stats(AudioStats *stats);
+void audio_reset_stats(void);
+
 #endif /* LOUDNESS_H */
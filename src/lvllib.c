@@ -20,6 +20,7 @@
 
 #include "file.h"
 #include "opentyr.h"
+#include "startup_report.h"
 
 JE_LvlPosType lvlPos;
 
@@ -28,6 +29,8 @@ JE_word lvlNum;
 
 void JE_analyzeLevel(void)
 {
+	const Uint64 report_start = startup_report_clock();
+
 	FILE *f = dir_fopen_die(data_dir(), levelFile, "rb");
 	
 	fread_u16_die(&lvlNum, 1, f);
@@ -36,5 +39,6 @@ void JE_analyzeLevel(void)
 	
 	lvlPos[lvlNum] = ftell_eof(f);
 	
+	startup_report_file(levelFile, ftell(f), report_start);
 	fclose(f);
 }
@@ -20,6 +20,7 @@
 
 #include "backgrnd.h"
 #include "config.h"
+#include "demo_bench.h"
 #include "editship.h"
 #include "episodes.h"
 #include "file.h"
@@ -30,11 +31,11 @@
 #include "helptext.h"
 #include "joystick.h"
 #include "keyboard.h"
-#include "lds_play.h"
 #include "loudness.h"
 #include "menus.h"
 #include "mouse.h"
 #include "mtrand.h"
+#include "netsim.h"
 #include "network.h"
 #include "nortsong.h"
 #include "nortvars.h"
@@ -1402,7 +1403,7 @@ void JE_doInGameSetup(void)
 		{
 			service_SDL_events(false);
 
-			if (packet_in[0] && SDLNet_Read16(&packet_in[0]->data[0]) == PACKET_GAME_MENU)
+			if (NET_PACKET(packet_in, 0) && SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[0]) == PACKET_GAME_MENU)
 			{
 				network_update();
 				break;
@@ -1462,14 +1463,14 @@ void JE_doInGameSetup(void)
 				service_SDL_events(false);
 				JE_showVGA();
 
-				if (packet_in[0])
+				if (NET_PACKET(packet_in, 0))
 				{
-					if (SDLNet_Read16(&packet_in[0]->data[0]) == PACKET_WAITING)
+					if (SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[0]) == PACKET_WAITING)
 					{
 						network_check();
 						break;
 					}
-					else if (SDLNet_Read16(&packet_in[0]->data[0]) == PACKET_GAME_QUIT)
+					else if (SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[0]) == PACKET_GAME_QUIT)
 					{
 						reallyEndLevel = true;
 						playerEndLevel = true;
@@ -2155,7 +2156,7 @@ void JE_highScoreCheck(void)
 
 					} while (!newkey && !newmouse && !new_text);
 
-					if (!playing)
+					if (!song_is_playing())
 						play_song(31);
 
 					if (mouseButton > 0)
@@ -3419,7 +3420,7 @@ void JE_pauseGame(void)
 		{
 			service_SDL_events(false);
 
-			if (packet_in[0] && SDLNet_Read16(&packet_in[0]->data[0]) == PACKET_GAME_PAUSE)
+			if (NET_PACKET(packet_in, 0) && SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[0]) == PACKET_GAME_PAUSE)
 			{
 				network_update();
 				break;
@@ -3460,7 +3461,7 @@ void JE_pauseGame(void)
 		{
 			network_check();
 
-			if (packet_in[0] && SDLNet_Read16(&packet_in[0]->data[0]) == PACKET_WAITING)
+			if (NET_PACKET(packet_in, 0) && SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[0]) == PACKET_WAITING)
 			{
 				network_check();
 
@@ -3516,7 +3517,7 @@ void JE_playerMovement(Player *this_player,
 	if (isNetworkGame && thisPlayerNum == playerNum_)
 	{
 		network_state_prepare();
-		memset(&packet_state_out[0]->data[4], 0, 10);
+		memset(&NET_PACKET(packet_state_out, 0)->data[4], 0, 10);
 	}
 #endif
 
@@ -3725,6 +3726,11 @@ redo:
 					mouseYC += mouseYR;
 				}
 
+#ifdef WITH_NETWORK
+				if (net_soak_frames > 0)
+					netsim_script_keys();
+#endif
+
 				/* keyboard input */
 				if ((inputDevice == 0 || inputDevice == 1) && !play_demo)
 				{
@@ -3830,11 +3836,11 @@ redo:
 					buttons |= button[i];
 				}
 
-				SDLNet_Write16(this_player->x - *mouseX_, &packet_state_out[0]->data[4]);
-				SDLNet_Write16(this_player->y - *mouseY_, &packet_state_out[0]->data[6]);
-				SDLNet_Write16(accelXC,                   &packet_state_out[0]->data[8]);
-				SDLNet_Write16(accelYC,                   &packet_state_out[0]->data[10]);
-				SDLNet_Write16(buttons,                   &packet_state_out[0]->data[12]);
+				SDLNet_Write16(this_player->x - *mouseX_, &NET_PACKET(packet_state_out, 0)->data[4]);
+				SDLNet_Write16(this_player->y - *mouseY_, &NET_PACKET(packet_state_out, 0)->data[6]);
+				SDLNet_Write16(accelXC,                   &NET_PACKET(packet_state_out, 0)->data[8]);
+				SDLNet_Write16(accelYC,                   &NET_PACKET(packet_state_out, 0)->data[10]);
+				SDLNet_Write16(buttons,                   &NET_PACKET(packet_state_out, 0)->data[12]);
 
 				this_player->x = *mouseX_;
 				this_player->y = *mouseY_;
@@ -3857,37 +3863,23 @@ redo:
 #ifdef WITH_NETWORK
 		if (isNetworkGame && !network_state_is_reset())
 		{
-			if (playerNum_ != thisPlayerNum)
-			{
-				if (thisPlayerNum == 2)
-					difficultyLevel = SDLNet_Read16(&packet_state_in[0]->data[16]);
+			const UDPpacket *state = network_state_of(playerNum_);
 
-				Uint16 buttons = SDLNet_Read16(&packet_state_in[0]->data[12]);
-				for (int i = 0; i < 4; i++)
-				{
-					button[i] = buttons & 1;
-					buttons >>= 1;
-				}
+			// player 1's difficulty is everyone's
+			if (playerNum_ == 1 && thisPlayerNum != 1)
+				difficultyLevel = SDLNet_Read16(&state->data[16]);
 
-				this_player->x += (Sint16)SDLNet_Read16(&packet_state_in[0]->data[4]);
-				this_player->y += (Sint16)SDLNet_Read16(&packet_state_in[0]->data[6]);
-				accelXC = (Sint16)SDLNet_Read16(&packet_state_in[0]->data[8]);
-				accelYC = (Sint16)SDLNet_Read16(&packet_state_in[0]->data[10]);
-			}
-			else
+			Uint16 buttons = SDLNet_Read16(&state->data[12]);
+			for (int i = 0; i < 4; i++)
 			{
-				Uint16 buttons = SDLNet_Read16(&packet_state_out[network_delay]->data[12]);
-				for (int i = 0; i < 4; i++)
-				{
-					button[i] = buttons & 1;
-					buttons >>= 1;
-				}
-
-				this_player->x += (Sint16)SDLNet_Read16(&packet_state_out[network_delay]->data[4]);
-				this_player->y += (Sint16)SDLNet_Read16(&packet_state_out[network_delay]->data[6]);
-				accelXC = (Sint16)SDLNet_Read16(&packet_state_out[network_delay]->data[8]);
-				accelYC = (Sint16)SDLNet_Read16(&packet_state_out[network_delay]->data[10]);
+				button[i] = buttons & 1;
+				buttons >>= 1;
 			}
+
+			this_player->x += (Sint16)SDLNet_Read16(&state->data[4]);
+			this_player->y += (Sint16)SDLNet_Read16(&state->data[6]);
+			accelXC = (Sint16)SDLNet_Read16(&state->data[8]);
+			accelYC = (Sint16)SDLNet_Read16(&state->data[10]);
 		}
 #endif
 
@@ -4733,377 +4725,375 @@ void JE_playerCollide(Player *this_player, JE_byte playerNum_)
 {
 	char tempStr[256];
 
-	for (int z = 0; z < 100; z++)
+	const Uint64 bench_start = demo_bench_clock();
+
+	for (int z = slot_pool_next_live(&enemyPool, 0, 100); z < 100; z = slot_pool_next_live(&enemyPool, z + 1, 100))
 	{
-		if (enemyAvail[z] != 1)
-		{
-			int enemy_screen_x = enemy[z].ex + enemy[z].mapoffset;
+		int enemy_screen_x = enemy[z].ex + enemy[z].mapoffset;
 
-			if (abs(this_player->x - enemy_screen_x) < 12 && abs(this_player->y - enemy[z].ey) < 14)
-			{   /*Collide*/
-				int evalue = enemy[z].evalue;
-				if (evalue > 29999)
+		if (abs(this_player->x - enemy_screen_x) < 12 && abs(this_player->y - enemy[z].ey) < 14)
+		{   /*Collide*/
+			int evalue = enemy[z].evalue;
+			if (evalue > 29999)
+			{
+				if (evalue == 30000)  // spawn dragonwing in galaga mode, otherwise just a purple ball
 				{
-					if (evalue == 30000)  // spawn dragonwing in galaga mode, otherwise just a purple ball
-					{
-						this_player->cash += 100;
+					this_player->cash += 100;
 
-						if (!galagaMode)
-						{
-							handle_got_purple_ball(this_player);
-						}
-						else
-						{
-							// spawn the dragonwing?
-							if (twoPlayerMode)
-								this_player->cash += 2400;
-							twoPlayerMode = true;
-							twoPlayerLinked = true;
-							player[1].items.weapon[REAR_WEAPON].power = 1;
-							player[1].armor = 10;
-							player[1].is_alive = true;
-						}
-						enemyAvail[z] = 1;
-						soundQueue[7] = S_POWERUP;
+					if (!galagaMode)
+					{
+						handle_got_purple_ball(this_player);
 					}
-					else if (superArcadeMode != SA_NONE && evalue > 30000)
+					else
 					{
-						shotMultiPos[SHOT_FRONT] = 0;
-						shotRepeat[SHOT_FRONT] = 10;
+						// spawn the dragonwing?
+						if (twoPlayerMode)
+							this_player->cash += 2400;
+						twoPlayerMode = true;
+						twoPlayerLinked = true;
+						player[1].items.weapon[REAR_WEAPON].power = 1;
+						player[1].armor = 10;
+						player[1].is_alive = true;
+					}
+					enemy_set_avail(z, 1);
+					soundQueue[7] = S_POWERUP;
+				}
+				else if (superArcadeMode != SA_NONE && evalue > 30000)
+				{
+					shotMultiPos[SHOT_FRONT] = 0;
+					shotRepeat[SHOT_FRONT] = 10;
 
-						tempW = SAWeapon[superArcadeMode-1][evalue - 30000-1];
+					tempW = SAWeapon[superArcadeMode-1][evalue - 30000-1];
 
-						// if picked up already-owned weapon, power weapon up
-						if (tempW == player[0].items.weapon[FRONT_WEAPON].id)
-						{
-							this_player->cash += 1000;
-							power_up_weapon(this_player, FRONT_WEAPON);
-						}
-						// else weapon also gives purple ball
-						else
-						{
-							handle_got_purple_ball(this_player);
-						}
-
-						player[0].items.weapon[FRONT_WEAPON].id = tempW;
-						this_player->cash += 200;
-						soundQueue[7] = S_POWERUP;
-						enemyAvail[z] = 1;
-					}
-					else if (evalue > 32100)
+					// if picked up already-owned weapon, power weapon up
+					if (tempW == player[0].items.weapon[FRONT_WEAPON].id)
 					{
-						if (playerNum_ == 1)
-						{
-							this_player->cash += 250;
-							player[0].items.special = evalue - 32100;
-							shotMultiPos[SHOT_SPECIAL] = 0;
-							shotRepeat[SHOT_SPECIAL] = 10;
-							shotMultiPos[SHOT_SPECIAL2] = 0;
-							shotRepeat[SHOT_SPECIAL2] = 0;
-
-							if (isNetworkGame)
-								snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(1), miscTextB[4-1], special[evalue - 32100].name);
-							else if (twoPlayerMode)
-								snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[43-1], special[evalue - 32100].name);
-							else
-								snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[64-1], special[evalue - 32100].name);
-							JE_drawTextWindow(tempStr);
-							soundQueue[7] = S_POWERUP;
-							enemyAvail[z] = 1;
-						}
+						this_player->cash += 1000;
+						power_up_weapon(this_player, FRONT_WEAPON);
 					}
-					else if (evalue > 32000)
+					// else weapon also gives purple ball
+					else
 					{
-						if (playerNum_ == 2)
-						{
-							enemyAvail[z] = 1;
-							if (isNetworkGame)
-								snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(2), miscTextB[4-1], options[evalue - 32000].name);
-							else
-								snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[44-1], options[evalue - 32000].name);
-							JE_drawTextWindow(tempStr);
-
-							// if picked up a different sidekick than player already has, then reset sidekicks to least powerful, else power them up
-							if (evalue - 32000u != player[1].items.sidekick_series)
-							{
-								player[1].items.sidekick_series = evalue - 32000;
-								player[1].items.sidekick_level = 101;
-							}
-							else if (player[1].items.sidekick_level < 103)
-							{
-								++player[1].items.sidekick_level;
-							}
-
-							uint temp = player[1].items.sidekick_level - 100 - 1;
-							for (uint i = 0; i < COUNTOF(player[1].items.sidekick); ++i)
-								player[1].items.sidekick[i] = optionSelect[player[1].items.sidekick_series][temp][i];
-
-							shotMultiPos[SHOT_LEFT_SIDEKICK] = 0;
-							shotMultiPos[SHOT_RIGHT_SIDEKICK] = 0;
-							JE_drawOptions();
-							soundQueue[7] = S_POWERUP;
-						}
-						else if (onePlayerAction)
-						{
-							enemyAvail[z] = 1;
-							snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[64-1], options[evalue - 32000].name);
-							JE_drawTextWindow(tempStr);
+						handle_got_purple_ball(this_player);
+					}
 
-							for (uint i = 0; i < COUNTOF(player[0].items.sidekick); ++i)
-								player[0].items.sidekick[i] = evalue - 32000;
-							shotMultiPos[SHOT_LEFT_SIDEKICK] = 0;
-							shotMultiPos[SHOT_RIGHT_SIDEKICK] = 0;
+					player[0].items.weapon[FRONT_WEAPON].id = tempW;
+					this_player->cash += 200;
+					soundQueue[7] = S_POWERUP;
+					enemy_set_avail(z, 1);
+				}
+				else if (evalue > 32100)
+				{
+					if (playerNum_ == 1)
+					{
+						this_player->cash += 250;
+						player[0].items.special = evalue - 32100;
+						shotMultiPos[SHOT_SPECIAL] = 0;
+						shotRepeat[SHOT_SPECIAL] = 10;
+						shotMultiPos[SHOT_SPECIAL2] = 0;
+						shotRepeat[SHOT_SPECIAL2] = 0;
 
-							JE_drawOptions();
-							soundQueue[7] = S_POWERUP;
-						}
-						if (enemyAvail[z] == 1)
-							this_player->cash += 250;
+						if (isNetworkGame)
+							snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(1), miscTextB[4-1], special[evalue - 32100].name);
+						else if (twoPlayerMode)
+							snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[43-1], special[evalue - 32100].name);
+						else
+							snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[64-1], special[evalue - 32100].name);
+						JE_drawTextWindow(tempStr);
+						soundQueue[7] = S_POWERUP;
+						enemy_set_avail(z, 1);
 					}
-					else if (evalue > 31000)
+				}
+				else if (evalue > 32000)
+				{
+					if (playerNum_ == 2)
 					{
-						this_player->cash += 250;
-						if (playerNum_ == 2)
+						enemy_set_avail(z, 1);
+						if (isNetworkGame)
+							snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(2), miscTextB[4-1], options[evalue - 32000].name);
+						else
+							snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[44-1], options[evalue - 32000].name);
+						JE_drawTextWindow(tempStr);
+
+						// if picked up a different sidekick than player already has, then reset sidekicks to least powerful, else power them up
+						if (evalue - 32000u != player[1].items.sidekick_series)
 						{
-							if (isNetworkGame)
-								snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(2), miscTextB[4-1], weaponPort[evalue - 31000].name);
-							else
-								snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[44-1], weaponPort[evalue - 31000].name);
-							JE_drawTextWindow(tempStr);
-							player[1].items.weapon[REAR_WEAPON].id = evalue - 31000;
-							shotMultiPos[SHOT_REAR] = 0;
-							enemyAvail[z] = 1;
-							soundQueue[7] = S_POWERUP;
+							player[1].items.sidekick_series = evalue - 32000;
+							player[1].items.sidekick_level = 101;
 						}
-						else if (onePlayerAction)
+						else if (player[1].items.sidekick_level < 103)
 						{
-							snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[64-1], weaponPort[evalue - 31000].name);
-							JE_drawTextWindow(tempStr);
-							player[0].items.weapon[REAR_WEAPON].id = evalue - 31000;
-							shotMultiPos[SHOT_REAR] = 0;
-							enemyAvail[z] = 1;
-							soundQueue[7] = S_POWERUP;
-
-							if (player[0].items.weapon[REAR_WEAPON].power == 0)  // does this ever happen?
-								player[0].items.weapon[REAR_WEAPON].power = 1;
+							++player[1].items.sidekick_level;
 						}
+
+						uint temp = player[1].items.sidekick_level - 100 - 1;
+						for (uint i = 0; i < COUNTOF(player[1].items.sidekick); ++i)
+							player[1].items.sidekick[i] = optionSelect[player[1].items.sidekick_series][temp][i];
+
+						shotMultiPos[SHOT_LEFT_SIDEKICK] = 0;
+						shotMultiPos[SHOT_RIGHT_SIDEKICK] = 0;
+						JE_drawOptions();
+						soundQueue[7] = S_POWERUP;
 					}
-					else if (evalue > 30000)
+					else if (onePlayerAction)
 					{
-						if (playerNum_ == 1 && twoPlayerMode)
-						{
-							if (isNetworkGame)
-								snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(1), miscTextB[4-1], weaponPort[evalue - 30000].name);
-							else
-								snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[43-1], weaponPort[evalue - 30000].name);
-							JE_drawTextWindow(tempStr);
-							player[0].items.weapon[FRONT_WEAPON].id = evalue - 30000;
-							shotMultiPos[SHOT_FRONT] = 0;
-							enemyAvail[z] = 1;
-							soundQueue[7] = S_POWERUP;
-						}
-						else if (onePlayerAction)
-						{
-							snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[64-1], weaponPort[evalue - 30000].name);
-							JE_drawTextWindow(tempStr);
-							player[0].items.weapon[FRONT_WEAPON].id = evalue - 30000;
-							shotMultiPos[SHOT_FRONT] = 0;
-							enemyAvail[z] = 1;
-							soundQueue[7] = S_POWERUP;
-						}
+						enemy_set_avail(z, 1);
+						snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[64-1], options[evalue - 32000].name);
+						JE_drawTextWindow(tempStr);
 
-						if (enemyAvail[z] == 1)
-						{
-							player[0].items.special = specialArcadeWeapon[evalue - 30000-1];
-							if (player[0].items.special > 0)
-							{
-								shotMultiPos[SHOT_SPECIAL] = 0;
-								shotRepeat[SHOT_SPECIAL] = 0;
-								shotMultiPos[SHOT_SPECIAL2] = 0;
-								shotRepeat[SHOT_SPECIAL2] = 0;
-							}
-							this_player->cash += 250;
-						}
+						for (uint i = 0; i < COUNTOF(player[0].items.sidekick); ++i)
+							player[0].items.sidekick[i] = evalue - 32000;
+						shotMultiPos[SHOT_LEFT_SIDEKICK] = 0;
+						shotMultiPos[SHOT_RIGHT_SIDEKICK] = 0;
 
+						JE_drawOptions();
+						soundQueue[7] = S_POWERUP;
 					}
+					if (enemyAvail[z] == 1)
+						this_player->cash += 250;
 				}
-				else if (evalue > 20000)
+				else if (evalue > 31000)
 				{
-					if (twoPlayerLinked)
-					{
-						// share the armor evenly between linked players
-						for (uint i = 0; i < COUNTOF(player); ++i)
-						{
-							player[i].armor += (evalue - 20000) / COUNTOF(player);
-							if (player[i].armor > 28)
-								player[i].armor = 28;
-						}
-					}
-					else
+					this_player->cash += 250;
+					if (playerNum_ == 2)
 					{
-						this_player->armor += evalue - 20000;
-						if (this_player->armor > 28)
-							this_player->armor = 28;
+						if (isNetworkGame)
+							snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(2), miscTextB[4-1], weaponPort[evalue - 31000].name);
+						else
+							snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[44-1], weaponPort[evalue - 31000].name);
+						JE_drawTextWindow(tempStr);
+						player[1].items.weapon[REAR_WEAPON].id = evalue - 31000;
+						shotMultiPos[SHOT_REAR] = 0;
+						enemy_set_avail(z, 1);
+						soundQueue[7] = S_POWERUP;
 					}
-					enemyAvail[z] = 1;
-					VGAScreen = VGAScreenSeg; /* side-effect of game_screen */
-					JE_drawArmor();
-					VGAScreen = game_screen; /* side-effect of game_screen */
-					soundQueue[7] = S_POWERUP;
-				}
-				else if (evalue > 10000 && enemyAvail[z] == 2)
-				{
-					if (!bonusLevel)
+					else if (onePlayerAction)
 					{
-						play_song(30);  /*Zanac*/
-						bonusLevel = true;
-						nextLevel = evalue - 10000;
-						enemyAvail[z] = 1;
-						displayTime = 150;
+						snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[64-1], weaponPort[evalue - 31000].name);
+						JE_drawTextWindow(tempStr);
+						player[0].items.weapon[REAR_WEAPON].id = evalue - 31000;
+						shotMultiPos[SHOT_REAR] = 0;
+						enemy_set_avail(z, 1);
+						soundQueue[7] = S_POWERUP;
+
+						if (player[0].items.weapon[REAR_WEAPON].power == 0)  // does this ever happen?
+							player[0].items.weapon[REAR_WEAPON].power = 1;
 					}
 				}
-				else if (enemy[z].scoreitem)
+				else if (evalue > 30000)
 				{
-					enemyAvail[z] = 1;
-					soundQueue[7] = S_ITEM;
-					if (evalue == 1)
-					{
-						cubeMax++;
-						soundQueue[3] = V_DATA_CUBE;
-					}
-					else if (evalue == -1)  // got front weapon powerup
+					if (playerNum_ == 1 && twoPlayerMode)
 					{
 						if (isNetworkGame)
-							snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(1), miscTextB[4-1], miscText[45-1]);
-						else if (twoPlayerMode)
-							snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[43-1], miscText[45-1]);
+							snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(1), miscTextB[4-1], weaponPort[evalue - 30000].name);
 						else
-							strcpy(tempStr, miscText[45-1]);
+							snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[43-1], weaponPort[evalue - 30000].name);
 						JE_drawTextWindow(tempStr);
-
-						power_up_weapon(&player[0], FRONT_WEAPON);
+						player[0].items.weapon[FRONT_WEAPON].id = evalue - 30000;
+						shotMultiPos[SHOT_FRONT] = 0;
+						enemy_set_avail(z, 1);
 						soundQueue[7] = S_POWERUP;
 					}
-					else if (evalue == -2)  // got rear weapon powerup
+					else if (onePlayerAction)
 					{
-						if (isNetworkGame)
-							snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(2), miscTextB[4-1], miscText[46-1]);
-						else if (twoPlayerMode)
-							snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[44-1], miscText[46-1]);
-						else
-							strcpy(tempStr, miscText[46-1]);
+						snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[64-1], weaponPort[evalue - 30000].name);
 						JE_drawTextWindow(tempStr);
-
-						power_up_weapon(twoPlayerMode ? &player[1] : &player[0], REAR_WEAPON);
+						player[0].items.weapon[FRONT_WEAPON].id = evalue - 30000;
+						shotMultiPos[SHOT_FRONT] = 0;
+						enemy_set_avail(z, 1);
 						soundQueue[7] = S_POWERUP;
 					}
-					else if (evalue == -3)
+
+					if (enemyAvail[z] == 1)
 					{
-						// picked up orbiting asteroid killer
-						shotMultiPos[SHOT_MISC] = 0;
-						b = player_shot_create(0, SHOT_MISC, this_player->x, this_player->y, mouseX, mouseY, 104, playerNum_);
-						shotAvail[z] = 0;
+						player[0].items.special = specialArcadeWeapon[evalue - 30000-1];
+						if (player[0].items.special > 0)
+						{
+							shotMultiPos[SHOT_SPECIAL] = 0;
+							shotRepeat[SHOT_SPECIAL] = 0;
+							shotMultiPos[SHOT_SPECIAL2] = 0;
+							shotRepeat[SHOT_SPECIAL2] = 0;
+						}
+						this_player->cash += 250;
 					}
-					else if (evalue == -4)
+
+				}
+			}
+			else if (evalue > 20000)
+			{
+				if (twoPlayerLinked)
+				{
+					// share the armor evenly between linked players
+					for (uint i = 0; i < COUNTOF(player); ++i)
 					{
-						if (player[playerNum_-1].superbombs < 10)
-							++player[playerNum_-1].superbombs;
+						player[i].armor += (evalue - 20000) / COUNTOF(player);
+						if (player[i].armor > 28)
+							player[i].armor = 28;
 					}
-					else if (evalue == -5)
-					{
-						player[0].items.weapon[FRONT_WEAPON].id = 25;  // HOT DOG!
-						player[0].items.weapon[REAR_WEAPON].id = 26;
-						player[1].items.weapon[REAR_WEAPON].id = 26;
+				}
+				else
+				{
+					this_player->armor += evalue - 20000;
+					if (this_player->armor > 28)
+						this_player->armor = 28;
+				}
+				enemy_set_avail(z, 1);
+				VGAScreen = VGAScreenSeg; /* side-effect of game_screen */
+				JE_drawArmor();
+				VGAScreen = game_screen; /* side-effect of game_screen */
+				soundQueue[7] = S_POWERUP;
+			}
+			else if (evalue > 10000 && enemyAvail[z] == 2)
+			{
+				if (!bonusLevel)
+				{
+					play_song(30);  /*Zanac*/
+					bonusLevel = true;
+					nextLevel = evalue - 10000;
+					enemy_set_avail(z, 1);
+					displayTime = 150;
+				}
+			}
+			else if (enemy[z].scoreitem)
+			{
+				enemy_set_avail(z, 1);
+				soundQueue[7] = S_ITEM;
+				if (evalue == 1)
+				{
+					cubeMax++;
+					soundQueue[3] = V_DATA_CUBE;
+				}
+				else if (evalue == -1)  // got front weapon powerup
+				{
+					if (isNetworkGame)
+						snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(1), miscTextB[4-1], miscText[45-1]);
+					else if (twoPlayerMode)
+						snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[43-1], miscText[45-1]);
+					else
+						strcpy(tempStr, miscText[45-1]);
+					JE_drawTextWindow(tempStr);
+
+					power_up_weapon(&player[0], FRONT_WEAPON);
+					soundQueue[7] = S_POWERUP;
+				}
+				else if (evalue == -2)  // got rear weapon powerup
+				{
+					if (isNetworkGame)
+						snprintf(tempStr, sizeof(tempStr), "%s %s %s", JE_getName(2), miscTextB[4-1], miscText[46-1]);
+					else if (twoPlayerMode)
+						snprintf(tempStr, sizeof(tempStr), "%s %s", miscText[44-1], miscText[46-1]);
+					else
+						strcpy(tempStr, miscText[46-1]);
+					JE_drawTextWindow(tempStr);
 
-						player[0].last_items = player[0].items;
+					power_up_weapon(twoPlayerMode ? &player[1] : &player[0], REAR_WEAPON);
+					soundQueue[7] = S_POWERUP;
+				}
+				else if (evalue == -3)
+				{
+					// picked up orbiting asteroid killer
+					shotMultiPos[SHOT_MISC] = 0;
+					b = player_shot_create(0, SHOT_MISC, this_player->x, this_player->y, mouseX, mouseY, 104, playerNum_);
+					player_shot_set_avail(z, 0);
+				}
+				else if (evalue == -4)
+				{
+					if (player[playerNum_-1].superbombs < 10)
+						++player[playerNum_-1].superbombs;
+				}
+				else if (evalue == -5)
+				{
+					player[0].items.weapon[FRONT_WEAPON].id = 25;  // HOT DOG!
+					player[0].items.weapon[REAR_WEAPON].id = 26;
+					player[1].items.weapon[REAR_WEAPON].id = 26;
 
-						for (uint i = 0; i < COUNTOF(player); ++i)
-							player[i].weapon_mode = 1;
+					player[0].last_items = player[0].items;
 
-						memset(shotMultiPos, 0, sizeof(shotMultiPos));
-					}
-					else if (twoPlayerLinked)
-					{
-						// players get equal share of pick-up cash when linked
-						for (uint i = 0; i < COUNTOF(player); ++i)
-							player[i].cash += evalue / COUNTOF(player);
-					}
-					else
-					{
-						this_player->cash += evalue;
-					}
-					JE_setupExplosion(enemy_screen_x, enemy[z].ey, 0, enemyDat[enemy[z].enemytype].explosiontype, true, false);
+					for (uint i = 0; i < COUNTOF(player); ++i)
+						player[i].weapon_mode = 1;
+
+					memset(shotMultiPos, 0, sizeof(shotMultiPos));
+				}
+				else if (twoPlayerLinked)
+				{
+					// players get equal share of pick-up cash when linked
+					for (uint i = 0; i < COUNTOF(player); ++i)
+						player[i].cash += evalue / COUNTOF(player);
 				}
-				else if (this_player->invulnerable_ticks == 0 && enemyAvail[z] == 0 &&
-				         (enemyDat[enemy[z].enemytype].explosiontype & 1) == 0) // explosiontype & 1 == 0: not ground enemy
+				else
 				{
-					int armorleft = enemy[z].armorleft;
-					if (armorleft > damageRate)
-						armorleft = damageRate;
+					this_player->cash += evalue;
+				}
+				JE_setupExplosion(enemy_screen_x, enemy[z].ey, 0, enemyDat[enemy[z].enemytype].explosiontype, true, false);
+			}
+			else if (this_player->invulnerable_ticks == 0 && enemyAvail[z] == 0 &&
+			         (enemyDat[enemy[z].enemytype].explosiontype & 1) == 0) // explosiontype & 1 == 0: not ground enemy
+			{
+				int armorleft = enemy[z].armorleft;
+				if (armorleft > damageRate)
+					armorleft = damageRate;
 
-					JE_playerDamage(armorleft, this_player);
+				JE_playerDamage(armorleft, this_player);
 
-					// player ship gets push-back from collision
-					if (enemy[z].armorleft > 0)
-					{
-						this_player->x_velocity += (enemy[z].exc * enemy[z].armorleft) / 2;
-						this_player->y_velocity += (enemy[z].eyc * enemy[z].armorleft) / 2;
-					}
+				// player ship gets push-back from collision
+				if (enemy[z].armorleft > 0)
+				{
+					this_player->x_velocity += (enemy[z].exc * enemy[z].armorleft) / 2;
+					this_player->y_velocity += (enemy[z].eyc * enemy[z].armorleft) / 2;
+				}
 
-					int armorleft2 = enemy[z].armorleft;
-					if (armorleft2 == 255)
-						armorleft2 = 30000;
+				int armorleft2 = enemy[z].armorleft;
+				if (armorleft2 == 255)
+					armorleft2 = 30000;
 
-					temp = enemy[z].linknum;
-					if (temp == 0)
-						temp = 255;
+				temp = enemy[z].linknum;
+				if (temp == 0)
+					temp = 255;
 
-					b = z;
+				b = z;
 
-					if (armorleft2 > armorleft)
-					{
-						// damage enemy
-						if (enemy[z].armorleft != 255)
-							enemy[z].armorleft -= armorleft;
-						soundQueue[5] = S_ENEMY_HIT;
-					}
-					else
+				if (armorleft2 > armorleft)
+				{
+					// damage enemy
+					if (enemy[z].armorleft != 255)
+						enemy[z].armorleft -= armorleft;
+					soundQueue[5] = S_ENEMY_HIT;
+				}
+				else
+				{
+					// kill enemy
+					for (temp2 = slot_pool_next_live(&enemyPool, 0, 100); temp2 < 100; temp2 = slot_pool_next_live(&enemyPool, temp2 + 1, 100))
 					{
-						// kill enemy
-						for (temp2 = 0; temp2 < 100; temp2++)
+						temp3 = enemy[temp2].linknum;
+						if (temp2 == b ||
+							(temp != 255 &&
+							 (temp == temp3 || temp - 100 == temp3 ||
+							  (temp3 > 40 && temp3 / 20 == temp / 20 && temp3 <= temp))))
 						{
-							if (enemyAvail[temp2] != 1)
-							{
-								temp3 = enemy[temp2].linknum;
-								if (temp2 == b ||
-									(temp != 255 &&
-									 (temp == temp3 || temp - 100 == temp3 ||
-									  (temp3 > 40 && temp3 / 20 == temp / 20 && temp3 <= temp))))
-								{
-									int enemy_screen_x = enemy[temp2].ex + enemy[temp2].mapoffset;
+							int enemy_screen_x = enemy[temp2].ex + enemy[temp2].mapoffset;
 
-									enemy[temp2].linknum = 0;
+							enemy[temp2].linknum = 0;
 
-									enemyAvail[temp2] = 1;
+							enemy_set_avail(temp2, 1);
 
-									if (enemyDat[enemy[temp2].enemytype].esize == 1)
-									{
-										JE_setupExplosionLarge(enemy[temp2].enemyground, enemy[temp2].explonum, enemy_screen_x, enemy[temp2].ey);
-										soundQueue[6] = S_EXPLOSION_9;
-									}
-									else
-									{
-										JE_setupExplosion(enemy_screen_x, enemy[temp2].ey, 0, 1, false, false);
-										soundQueue[5] = S_EXPLOSION_4;
-									}
-								}
+							if (enemyDat[enemy[temp2].enemytype].esize == 1)
+							{
+								JE_setupExplosionLarge(enemy[temp2].enemyground, enemy[temp2].explonum, enemy_screen_x, enemy[temp2].ey);
+								soundQueue[6] = S_EXPLOSION_9;
+							}
+							else
+							{
+								JE_setupExplosion(enemy_screen_x, enemy[temp2].ey, 0, 1, false, false);
+								soundQueue[5] = S_EXPLOSION_4;
 							}
 						}
-						enemyAvail[z] = 1;
 					}
+					enemy_set_avail(z, 1);
 				}
 			}
-
 		}
+
 	}
+
+	demo_bench_enemy_time(bench_start);
 }
@@ -0,0 +1,280 @@
+/*
+ * Tyrian 3000: Netplay Link Simulator
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#include "netsim.h"
+
+int net_soak_frames = 0;
+
+#ifdef WITH_NETWORK
+
+#include "config.h"
+#include "keyboard.h"
+#include "network.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NETSIM_PACKET_SIZE  256
+#define NETSIM_HELD         64   // packets in flight; more are sent straight away
+#define NETSIM_REORDER_HOLD 40   // extra ticks a reordered packet is held, longer than a frame
+#define NETSIM_ATTEMPTS     256  // packets remembered for counting resends of the same one
+
+typedef struct
+{
+	Uint32 due;
+	int channel;
+	IPaddress address;  // for channel -1
+	int len;
+	Uint8 data[NETSIM_PACKET_SIZE];
+} HeldPacket;
+
+static bool enabled = false;
+static int delay_ms = 0, jitter_ms = 0;
+static double loss_pct = 0, reorder_pct = 0;
+static Uint32 seed = 1;
+
+static Uint32 script_random = 0;  // scripted keys; seeded per player on first use
+
+// times each recently sent packet has been sent, so a resend gets a fate of its own
+static struct
+{
+	Uint32 key;
+	Uint32 count;
+} attempts[NETSIM_ATTEMPTS];
+
+static UDPsocket link_socket = NULL;
+static UDPpacket *scratch = NULL;
+static HeldPacket held[NETSIM_HELD];
+static int held_count = 0;
+
+static Uint32 sent_count = 0, dropped_count = 0, reordered_count = 0;
+
+// xorshift32; kept apart from mt_rand, which is game state and must stay in step
+static Uint32 next_random(Uint32 *state)
+{
+	Uint32 x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+// murmur3 finalizer
+static Uint32 mix(Uint32 x)
+{
+	x ^= x >> 16;
+	x *= 0x85ebca6bu;
+	x ^= x >> 13;
+	x *= 0xc2b2ae35u;
+	x ^= x >> 16;
+	return x;
+}
+
+// Identifies a packet by its header: the type, then the sync number or the
+// spectator's level and tick.  Resends of a packet share its key.
+static Uint32 packet_key(const UDPpacket *packet)
+{
+	Uint32 key = mix(seed);
+	for (int i = 0; i < MIN(packet->len, 8); ++i)
+		key = mix(key ^ packet->data[i]);
+	return key;
+}
+
+// Each decision about a packet comes from its key, how many times it has been
+// sent and what is being decided, not from a stream shared by every packet.
+// The same seed then gives the same packet the same fate, however the sends
+// of other packets were timed.
+static Uint32 packet_random(Uint32 key, Uint32 attempt, Uint32 decision)
+{
+	return mix(mix(key ^ attempt) ^ decision);
+}
+
+static bool chance(double pct, Uint32 random)
+{
+	return pct > 0 && (random % 10000) < pct * 100;
+}
+
+bool netsim_configure(const char *spec)
+{
+	char buffer[128];
+	SDL_strlcpy(buffer, spec, sizeof(buffer));
+
+	for (char *item = strtok(buffer, ","); item != NULL; item = strtok(NULL, ","))
+	{
+		char *value = strchr(item, '=');
+		if (value == NULL)
+			return false;
+		*value++ = '\0';
+
+		char *end;
+		const double number = strtod(value, &end);
+		if (end == value || *end != '\0' || number < 0)
+			return false;
+
+		if (strcmp(item, "delay") == 0)
+			delay_ms = (int)number;
+		else if (strcmp(item, "jitter") == 0)
+			jitter_ms = (int)number;
+		else if (strcmp(item, "loss") == 0 && number <= 100)
+			loss_pct = number;
+		else if (strcmp(item, "reorder") == 0 && number <= 100)
+			reorder_pct = number;
+		else if (strcmp(item, "seed") == 0 && number <= 4294967295.0 && number == (Uint32)number)
+			seed = (Uint32)number;
+		else
+			return false;
+	}
+
+	enabled = true;
+
+	return true;
+}
+
+static int send_held(HeldPacket *packet)
+{
+	memcpy(scratch->data, packet->data, packet->len);
+	scratch->len = packet->len;
+	scratch->address = packet->address;
+
+	return SDLNet_UDP_Send(link_socket, packet->channel, scratch);
+}
+
+int netsim_send(UDPsocket socket, int channel, UDPpacket *packet)
+{
+	if (!enabled)
+		return SDLNet_UDP_Send(socket, channel, packet);
+
+	link_socket = socket;
+	sent_count++;
+
+	const Uint32 key = packet_key(packet);
+	const unsigned int slot_index = key % NETSIM_ATTEMPTS;
+	if (attempts[slot_index].key != key)
+	{
+		attempts[slot_index].key = key;
+		attempts[slot_index].count = 0;
+	}
+	const Uint32 attempt = attempts[slot_index].count++;
+
+	if (chance(loss_pct, packet_random(key, attempt, 0)))
+	{
+		dropped_count++;
+		return 1;  // as far as the sender can tell, it went
+	}
+
+	if (scratch == NULL)
+		scratch = SDLNet_AllocPacket(NETSIM_PACKET_SIZE);
+
+	int hold = delay_ms;
+	if (jitter_ms > 0)
+		hold += (int)(packet_random(key, attempt, 1) % (2 * jitter_ms + 1)) - jitter_ms;
+	if (chance(reorder_pct, packet_random(key, attempt, 2)))
+	{
+		hold += NETSIM_REORDER_HOLD;
+		reordered_count++;
+	}
+
+	if (hold <= 0 || held_count == NETSIM_HELD || scratch == NULL || packet->len > NETSIM_PACKET_SIZE)
+		return SDLNet_UDP_Send(socket, channel, packet);
+
+	HeldPacket *slot = &held[held_count++];
+	slot->due = SDL_GetTicks() + hold;
+	slot->channel = channel;
+	slot->address = packet->address;
+	slot->len = packet->len;
+	memcpy(slot->data, packet->data, packet->len);
+
+	return 1;
+}
+
+Uint32 netsim_pump(void)
+{
+	if (held_count == 0)
+		return NETSIM_IDLE;
+
+	const Uint32 now = SDL_GetTicks();
+
+	// send everything due, earliest first, so only the holds reorder packets
+	for (; ; )
+	{
+		int next = -1;
+		for (int i = 0; i < held_count; ++i)
+		{
+			if ((Sint32)(now - held[i].due) >= 0 && (next < 0 || (Sint32)(held[i].due - held[next].due) < 0))
+				next = i;
+		}
+		if (next < 0)
+			break;
+
+		if (!send_held(&held[next]))
+			fprintf(stderr, "warning: SDLNet_UDP_Send: %s\n", SDL_GetError());
+
+		held[next] = held[--held_count];
+	}
+
+	Uint32 wait = NETSIM_IDLE;
+	for (int i = 0; i < held_count; ++i)
+		wait = MIN(wait, held[i].due - now);
+
+	return wait;
+}
+
+void netsim_script_keys(void)
+{
+	static int hold = 0;
+	static unsigned int pressed = 0;
+
+	if (script_random == 0)
+		script_random = (seed * 2654435761u + thisPlayerNum) | 1;
+
+	// hold each choice of direction and fire for a random stretch, like a player would
+	if (hold-- <= 0)
+	{
+		const Uint32 r = next_random(&script_random);
+
+		pressed = r & ((1 << KEY_SETTING_UP) | (1 << KEY_SETTING_DOWN) | (1 << KEY_SETTING_LEFT) | (1 << KEY_SETTING_RIGHT));
+		if ((r >> 4) % 4 != 0)
+			pressed |= 1 << KEY_SETTING_FIRE;
+
+		hold = 5 + (r >> 8) % 30;
+	}
+
+	for (int i = KEY_SETTING_UP; i <= KEY_SETTING_FIRE; ++i)
+		keysactive[keySettings[i]] = (pressed >> i) & 1;
+}
+
+void netsim_soak_report(void)
+{
+	const NetworkStats *stats = &network_stats;
+
+	const double seconds = (SDL_GetTicks() - stats->started_tick) / 1000.0;
+	const double minutes = seconds > 0 ? seconds / 60 : 1;
+
+	printf("net soak: player %u, %u ticks in %.1f s\n", thisPlayerNum, stats->state_ticks, seconds);
+	printf("  stalls %u (%.1f/min, %u ms), resends %u, retries %u, xor recoveries %u, desyncs %u\n",
+	       stats->stalls, stats->stalls / minutes, stats->stalled_ms, stats->resends, stats->retries, stats->xor_recoveries, stats->desyncs);
+	printf("  link: delay %d ms, jitter %d ms, loss %.2f%%, reorder %.2f%%, seed %u; sent %u, dropped %u, reordered %u\n",
+	       delay_ms, jitter_ms, loss_pct, reorder_pct, seed, sent_count, dropped_count, reordered_count);
+
+	// one line, so the soak script can grep for it
+	printf("{\"net_soak\":{\"player\":%u,\"ticks\":%u,\"seconds\":%.3f,"
+	       "\"stalls\":%u,\"stalls_per_minute\":%.3f,\"stalled_ms\":%u,"
+	       "\"resends\":%u,\"retries\":%u,\"xor_recoveries\":%u,\"desyncs\":%u,"
+	       "\"link\":{\"delay_ms\":%d,\"jitter_ms\":%d,\"loss_pct\":%.3f,\"reorder_pct\":%.3f,\"seed\":%u,"
+	       "\"sent\":%u,\"dropped\":%u,\"reordered\":%u}}}\n",
+	       thisPlayerNum, stats->state_ticks, seconds,
+	       stats->stalls, stats->stalls / minutes, stats->stalled_ms,
+	       stats->resends, stats->retries, stats->xor_recoveries, stats->desyncs,
+	       delay_ms, jitter_ms, loss_pct, reorder_pct, seed,
+	       sent_count, dropped_count, reordered_count);
+	fflush(stdout);
+}
+
+#endif /* WITH_NETWORK */
@@ -0,0 +1,46 @@
+/*
+ * Tyrian 3000: Netplay Link Simulator
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#ifndef NETSIM_H
+#define NETSIM_H
+
+#include "opentyr.h"
+
+#include "SDL.h"
+#ifdef WITH_NETWORK
+#	include "SDL_net.h"
+#endif
+
+#include <stdbool.h>
+
+#define NETSIM_IDLE 0xffffffffu  // netsim_pump: nothing held back
+
+/* Stop a soak run after this many state ticks; 0 is a normal game. */
+extern int net_soak_frames;
+
+#ifdef WITH_NETWORK
+/* Parses "delay=MS,jitter=MS,loss=PCT,reorder=PCT,seed=N" (any subset) and turns the
+   simulator on.  Returns false, leaving it off, on a malformed spec. */
+bool netsim_configure(const char *spec);
+
+/* Drop-in for SDLNet_UDP_Send.  With the simulator on, the packet may be dropped or
+   held back and sent by a later netsim_pump; either way the caller's packet is free. */
+int netsim_send(UDPsocket socket, int channel, UDPpacket *packet);
+
+/* Sends held packets that are due.  Returns the ticks until the next one is. */
+Uint32 netsim_pump(void);
+
+/* Soak runs: presses the local player's movement and fire keys from the seed. */
+void netsim_script_keys(void);
+
+/* Prints the soak counters as a table and as one JSON line. */
+void netsim_soak_report(void);
+#endif
+
+#endif /* NETSIM_H */
@@ -18,12 +18,14 @@
  */
 #include "network.h"
 
+#include "config.h"
 #include "episodes.h"
 #include "fonthand.h"
 #include "helptext.h"
 #include "joystick.h"
 #include "keyboard.h"
 #include "mainint.h"
+#include "netsim.h"
 #include "nortvars.h"
 #include "opentyr.h"
 #include "picload.h"
@@ -32,6 +34,7 @@
 #include "video.h"
 
 #include <assert.h>
+#include <stdlib.h>
 
 /*                              HERE BE DRAGONS!
  *
@@ -41,16 +44,30 @@
  * Hopefully it'll be rewritten some day.
  */
 
-#define NET_VERSION       2            // increment whenever networking changes might create incompatibility
+#define NET_VERSION       3            // increment whenever networking changes might create incompatibility
 #define NET_PORT          1333         // UDP
 
 #define NET_PACKET_SIZE   256
-#define NET_PACKET_QUEUE  16
+#define NET_PACKET_POOL   (5 * NET_PACKET_QUEUE)  // enough for every slot of every queue
 
 #define NET_RETRY         640          // ticks to wait for packet acknowledgment before resending
 #define NET_RESEND        320          // ticks to wait before requesting unreceived game packet
-#define NET_KEEP_ALIVE    1600         // ticks to wait between keep-alive packets
+#define NET_KEEP_ALIVE    500          // ticks to wait between keep-alive packets, which also time the round trip
 #define NET_TIME_OUT      16000        // ticks to wait before considering connection dead
+#define NET_STATE_POLL    4            // ticks to sleep at most while a state packet is late
+#define NET_STATE_PRESENT 16           // ticks between servicing the window while a state packet is late
+#define NET_RTT_SAMPLES   64           // round trips kept for the 95th percentile
+
+#define NET_SPECTATORS_MAX  8                                   // endpoints the host will serve
+#define NET_SPECTATE_STATE  (28 - 4)                            // a state packet, less its header
+#define NET_SPECTATE_TICK   (2 * NET_SPECTATE_STATE)            // both players' states for one tick
+#define NET_SPECTATE_BATCH  ((NET_PACKET_SIZE - 9) / NET_SPECTATE_TICK)  // ticks in one packet
+#define NET_SPECTATE_REPEAT 3            // ticks in each broadcast, so a lost packet rarely costs a resend
+#define NET_SPECTATE_BURST  8            // packets sent in answer to one resend request
+#define NET_SPECTATE_RING   256          // ticks a spectator can hold ahead of play; power of two
+#define NET_SPECTATE_SLACK  4            // ticks a spectator may trail the host before it runs flat out
+#define NET_SPECTATE_RESEND 100          // ticks between a stalled spectator's resend requests
+#define NET_KEYFRAME_SIZE   (16 + 2 * 19)  // see write_keyframe
 
 bool isNetworkGame = false;
 int network_delay = 1 + 1;  // minimum is 1 + 0
@@ -64,28 +81,75 @@ static char empty_string[] = "";
 char *network_player_name = empty_string,
      *network_opponent_name = empty_string;
 
+bool network_spectating = false;
+int network_spectators_max = 0;
+
 #ifdef WITH_NETWORK
 static UDPsocket socket;
+static SDLNet_SocketSet socket_set = NULL;  // only to wake when a datagram arrives
 static IPaddress ip;
 
 UDPpacket *packet_out_temp;
 static UDPpacket *packet_temp;
 
-UDPpacket *packet_in[NET_PACKET_QUEUE] = { NULL },
-          *packet_out[NET_PACKET_QUEUE] = { NULL };
+PacketQueue packet_in, packet_out;
 
 static Uint16 last_out_sync = 0, queue_in_sync = 0, queue_out_sync = 0, last_ack_sync = 0;
 static Uint32 last_in_tick = 0, last_out_tick = 0;
 
-UDPpacket *packet_state_in[NET_PACKET_QUEUE] = { NULL };
-static UDPpacket *packet_state_in_xor[NET_PACKET_QUEUE] = { NULL };
-UDPpacket *packet_state_out[NET_PACKET_QUEUE] = { NULL };
+PacketQueue packet_state_in;
+static PacketQueue packet_state_in_xor;
+PacketQueue packet_state_out;
+
+// packets not in any queue; filled once by network_init
+static UDPpacket *packet_pool[NET_PACKET_POOL];
+static int packet_pool_count = 0;
 
 static Uint16 last_state_in_sync = 0, last_state_out_sync = 0;
 static Uint32 last_state_in_tick = 0;
 
+NetworkStats network_stats;
+bool network_overlay = false;
+static Uint32 rtt_samples[NET_RTT_SAMPLES];
+static NetworkStats rate_start;  // totals when the current rate window opened
+static Uint32 rate_tick = 0;
+
 static bool net_initialized = false;
 static bool connected = false, quit = false;
+
+typedef struct
+{
+	IPaddress address;
+	Uint32 last_tick;  // of its last join packet
+} Spectator;
+
+// the states of every tick since a keyframe
+typedef struct
+{
+	Uint16 keyframe_id;
+	Uint8 *ticks;      // NET_SPECTATE_TICK bytes each
+	Uint32 count, cap;
+} SpectateLog;
+
+// the host's keyframe for the current level, or the one a spectator has taken
+static Uint8 keyframe[NET_KEYFRAME_SIZE];
+static Uint16 keyframe_id = 0;  // 0 before the first
+
+// host
+static Spectator spectators[NET_SPECTATORS_MAX];
+static int spectator_count = 0;
+static SpectateLog spectate_logs[2];  // this level's and the last, for spectators still finishing it
+
+// spectator
+static Uint8 latest_keyframe[NET_KEYFRAME_SIZE];  // the newest received
+static Uint16 played_id = 0;                      // keyframe of the level being played
+static Uint8 spectate_ring[NET_SPECTATE_RING][NET_SPECTATE_TICK];
+static Uint32 spectate_ring_tick[NET_SPECTATE_RING];  // tick + 1 held in each slot; 0 when empty
+static Uint32 spectate_next = 0;                      // tick to play next
+static Uint32 spectate_host = 0;                      // ticks the host is known to have played
+static UDPpacket *spectate_state[2];
+static Uint8 spectate_sent[NET_PACKET_QUEUE][10];     // positions the players would have sent, by sync
+static Uint16 spectate_first_sync = 0;                // of this level's first state
 #endif
 
 uint thisPlayerNum = 0;  /* Player number on this PC (1 or 2) */
@@ -107,30 +171,54 @@ static void packet_copy(UDPpacket *dst, UDPpacket *src)
 	memcpy(dst->data, src->data, src->len);
 }
 
-static void packets_shift_up(UDPpacket **packet, int max_packets)
+static UDPpacket *packet_alloc(void)
 {
-		if (packet[0])
-		{
-			SDLNet_FreePacket(packet[0]);
-		}
-		for (int i = 0; i < max_packets - 1; i++)
-		{
-			packet[i] = packet[i + 1];
-		}
-		packet[max_packets - 1] = NULL;
+	if (packet_pool_count > 0)
+		return packet_pool[--packet_pool_count];
+
+	return SDLNet_AllocPacket(NET_PACKET_SIZE);  // only if the pool was never filled
+}
+
+static void packet_free(UDPpacket *packet)
+{
+	if (packet_pool_count < NET_PACKET_POOL)
+		packet_pool[packet_pool_count++] = packet;
+	else
+		SDLNet_FreePacket(packet);
 }
 
-static void packets_shift_down(UDPpacket **packet, int max_packets)
+// drop the oldest packet; every other packet moves one place closer to the front
+static void packets_shift_up(PacketQueue *queue)
 {
-	if (packet[max_packets - 1])
+	if (NET_PACKET(*queue, 0))
 	{
-		SDLNet_FreePacket(packet[max_packets - 1]);
+		packet_free(NET_PACKET(*queue, 0));
+		NET_PACKET(*queue, 0) = NULL;
 	}
-	for (int i = max_packets - 1; i > 0; i--)
+	queue->head += 1;
+}
+
+// drop the newest packet; every other packet moves one place further back
+static void packets_shift_down(PacketQueue *queue)
+{
+	if (NET_PACKET(*queue, NET_PACKET_QUEUE - 1))
 	{
-		packet[i] = packet[i - 1];
+		packet_free(NET_PACKET(*queue, NET_PACKET_QUEUE - 1));
+		NET_PACKET(*queue, NET_PACKET_QUEUE - 1) = NULL;
+	}
+	queue->head -= 1;
+}
+
+static void packets_clear(PacketQueue *queue)
+{
+	for (int i = 0; i < NET_PACKET_QUEUE; i++)
+	{
+		if (queue->slot[i])
+		{
+			packet_free(queue->slot[i]);
+			queue->slot[i] = NULL;
+		}
 	}
-	packet[0] = NULL;
 }
 
 // prepare new packet for sending
@@ -140,20 +228,42 @@ void network_prepare(Uint16 type)
 	SDLNet_Write16(last_out_sync, &packet_out_temp->data[2]);
 }
 
-// send packet but don't expect acknowledgment of delivery
-static bool network_send_no_ack(int len)
+// send packet as it is, on channel 0 to the opponent or on -1 to packet->address
+static bool send_packet_on(int channel, UDPpacket *packet)
 {
-	packet_out_temp->len = len;
-
-	if (!SDLNet_UDP_Send(socket, 0, packet_out_temp))
+	if (!netsim_send(socket, channel, packet))
 	{
 		printf("SDLNet_UDP_Send: %s\n", SDL_GetError());
 		return false;
 	}
 
+	network_stats.packets_sent++;
+	network_stats.bytes_sent += packet->len;
+
 	return true;
 }
 
+// send packet to the opponent as it is
+static bool send_packet(UDPpacket *packet)
+{
+	return send_packet_on(0, packet);
+}
+
+static bool send_packet_to(UDPpacket *packet, const IPaddress *address)
+{
+	packet->address = *address;
+
+	return send_packet_on(-1, packet);
+}
+
+// send packet but don't expect acknowledgment of delivery
+static bool network_send_no_ack(int len)
+{
+	packet_out_temp->len = len;
+
+	return send_packet(packet_out_temp);
+}
+
 // send packet and place it in queue to be acknowledged
 bool network_send(int len)
 {
@@ -162,8 +272,9 @@ bool network_send(int len)
 	Uint16 i = last_out_sync - queue_out_sync;
 	if (i < NET_PACKET_QUEUE)
 	{
-		packet_out[i] = SDLNet_AllocPacket(NET_PACKET_SIZE);
-		packet_copy(packet_out[i], packet_out_temp);
+		if (NET_PACKET(packet_out, i) == NULL)
+			NET_PACKET(packet_out, i) = packet_alloc();
+		packet_copy(NET_PACKET(packet_out, i), packet_out_temp);
 	}
 	else
 	{
@@ -190,6 +301,341 @@ static int network_acknowledge(Uint16 sync)
 	return 0;
 }
 
+static int compare_ticks(const void *a, const void *b)
+{
+	const Uint32 x = *(const Uint32 *)a, y = *(const Uint32 *)b;
+	return (x > y) - (x < y);
+}
+
+static void record_round_trip(Uint32 ms)
+{
+	NetworkStats *stats = &network_stats;
+
+	rtt_samples[stats->rtt_count % NET_RTT_SAMPLES] = ms;
+
+	// smoothed like TCP's, weighting each new sample 1/8
+	stats->rtt_ms = stats->rtt_count == 0 ? ms : stats->rtt_ms + ((float)ms - stats->rtt_ms) / 8;
+	stats->rtt_count++;
+
+	// few enough samples, and seldom enough, to sort each time
+	Uint32 sorted[NET_RTT_SAMPLES];
+	const size_t count = MIN(stats->rtt_count, NET_RTT_SAMPLES);
+	memcpy(sorted, rtt_samples, count * sizeof(*sorted));
+	qsort(sorted, count, sizeof(*sorted), compare_ticks);
+	stats->rtt_p95_ms = sorted[(count * 95 + 99) / 100 - 1];
+}
+
+// recompute the per-second figures once a second
+static void update_rates(void)
+{
+	const Uint32 now = SDL_GetTicks();
+	if (now - rate_tick < 1000)
+		return;
+
+	NetworkStats *stats = &network_stats;
+	const float seconds = (now - rate_tick) / 1000.0f;
+
+	stats->packets_sent_rate = (stats->packets_sent - rate_start.packets_sent) / seconds;
+	stats->packets_received_rate = (stats->packets_received - rate_start.packets_received) / seconds;
+	stats->bytes_sent_rate = (stats->bytes_sent - rate_start.bytes_sent) / seconds;
+	stats->bytes_received_rate = (stats->bytes_received - rate_start.bytes_received) / seconds;
+	stats->stalled_ms_rate = (stats->stalled_ms - rate_start.stalled_ms) / seconds;
+	stats->spectators = spectator_count;
+
+	rate_start = *stats;
+	rate_tick = now;
+}
+
+void network_reset_stats(void)
+{
+	memset(&network_stats, 0, sizeof(network_stats));
+
+	rate_start = network_stats;
+	rate_tick = SDL_GetTicks();
+}
+
+void network_draw_overlay(SDL_Surface *screen)
+{
+	const NetworkStats *stats = &network_stats;
+	char buffer[64];
+
+	snprintf(buffer, sizeof(buffer), "RTT %.0f ms  p95 %u ms", stats->rtt_ms, stats->rtt_p95_ms);
+	JE_outText(screen, 30, 20, buffer, 15, 3);
+
+	snprintf(buffer, sizeof(buffer), "Out %.0f/s %.1f KB/s  In %.0f/s %.1f KB/s",
+	         stats->packets_sent_rate, stats->bytes_sent_rate / 1024, stats->packets_received_rate, stats->bytes_received_rate / 1024);
+	JE_outText(screen, 30, 28, buffer, 15, 3);
+
+	snprintf(buffer, sizeof(buffer), "Blocked %.0f ms/s  Resends %u  Retries %u  XOR %u",
+	         stats->stalled_ms_rate, stats->resends, stats->retries, stats->xor_recoveries);
+	JE_outText(screen, 30, 36, buffer, 15, 3);
+}
+
+static Uint8 *write_player(Uint8 *data, const Player *this_player)
+{
+	const PlayerItems *items = &this_player->items;
+
+	SDLNet_Write32(this_player->cash,  &data[0]);
+	SDLNet_Write16(this_player->armor, &data[4]);
+	data[6] = this_player->weapon_mode;
+
+	// lives are kept in the items, too
+	data[7]  = items->ship;
+	data[8]  = items->generator;
+	data[9]  = items->shield;
+	data[10] = items->weapon[FRONT_WEAPON].id;
+	data[11] = items->weapon[FRONT_WEAPON].power;
+	data[12] = items->weapon[REAR_WEAPON].id;
+	data[13] = items->weapon[REAR_WEAPON].power;
+	data[14] = items->sidekick[LEFT_SIDEKICK];
+	data[15] = items->sidekick[RIGHT_SIDEKICK];
+	data[16] = items->special;
+	data[17] = items->sidekick_series;
+	data[18] = items->sidekick_level;
+
+	return data + 19;
+}
+
+static const Uint8 *read_player(const Uint8 *data, Player *this_player)
+{
+	PlayerItems *items = &this_player->items;
+
+	this_player->cash = SDLNet_Read32(&data[0]);
+	this_player->armor = SDLNet_Read16(&data[4]);
+	this_player->weapon_mode = data[6];
+
+	items->ship                       = data[7];
+	items->generator                  = data[8];
+	items->shield                     = data[9];
+	items->weapon[FRONT_WEAPON].id    = data[10];
+	items->weapon[FRONT_WEAPON].power = data[11];
+	items->weapon[REAR_WEAPON].id     = data[12];
+	items->weapon[REAR_WEAPON].power  = data[13];
+	items->sidekick[LEFT_SIDEKICK]    = data[14];
+	items->sidekick[RIGHT_SIDEKICK]   = data[15];
+	items->special                    = data[16];
+	items->sidekick_series            = data[17];
+	items->sidekick_level             = data[18];
+
+	return data + 19;
+}
+
+// what a spectator needs to start the level the host is starting: the game
+// replays the same from here given the same input
+static void write_keyframe(void)
+{
+	SDLNet_Write16(PACKET_SPECTATE_KEYFRAME, &keyframe[0]);
+	SDLNet_Write16(keyframe_id,              &keyframe[2]);
+	SDLNet_Write16(episodeNum,               &keyframe[4]);
+	SDLNet_Write16(mainLevel,                &keyframe[6]);
+	SDLNet_Write16(difficultyLevel,          &keyframe[8]);
+	SDLNet_Write16(initialDifficulty,        &keyframe[10]);
+	SDLNet_Write16(network_delay,            &keyframe[12]);
+	SDLNet_Write16(last_state_out_sync,      &keyframe[14]);  // not always reset between levels
+
+	Uint8 *data = &keyframe[16];
+	for (uint i = 0; i < COUNTOF(player); ++i)
+		data = write_player(data, &player[i]);
+}
+
+static void read_keyframe(void)
+{
+	memcpy(keyframe, latest_keyframe, sizeof(keyframe));
+	keyframe_id = SDLNet_Read16(&keyframe[2]);
+
+	JE_initEpisode(SDLNet_Read16(&keyframe[4]));
+	mainLevel         = SDLNet_Read16(&keyframe[6]);
+	difficultyLevel   = SDLNet_Read16(&keyframe[8]);
+	initialDifficulty = SDLNet_Read16(&keyframe[10]);
+	network_delay     = SDLNet_Read16(&keyframe[12]);
+
+	const Uint8 *data = &keyframe[16];
+	for (uint i = 0; i < COUNTOF(player); ++i)
+		data = read_player(data, &player[i]);
+}
+
+static SpectateLog *spectate_log(Uint16 id)
+{
+	for (uint i = 0; i < COUNTOF(spectate_logs); ++i)
+	{
+		if (id != 0 && spectate_logs[i].keyframe_id == id)
+			return &spectate_logs[i];
+	}
+	return NULL;
+}
+
+static void spectate_send_keyframe(const IPaddress *address)
+{
+	memcpy(packet_out_temp->data, keyframe, sizeof(keyframe));
+	packet_out_temp->len = sizeof(keyframe);
+
+	send_packet_to(packet_out_temp, address);
+}
+
+// send up to a packet's worth of ticks, starting at `first`
+static void spectate_send_ticks(const SpectateLog *log, Uint32 first, const IPaddress *address)
+{
+	if (first >= log->count)
+		return;
+
+	const Uint32 count = MIN(log->count - first, NET_SPECTATE_BATCH);
+
+	SDLNet_Write16(PACKET_SPECTATE_TICKS, &packet_out_temp->data[0]);
+	SDLNet_Write16(log->keyframe_id,      &packet_out_temp->data[2]);
+	SDLNet_Write32(first,                 &packet_out_temp->data[4]);
+	packet_out_temp->data[8] = count;
+	memcpy(&packet_out_temp->data[9], &log->ticks[first * NET_SPECTATE_TICK], count * NET_SPECTATE_TICK);
+	packet_out_temp->len = 9 + count * NET_SPECTATE_TICK;
+
+	send_packet_to(packet_out_temp, address);
+}
+
+static void spectate_send_quit(void)
+{
+	SDLNet_Write16(PACKET_QUIT, &packet_out_temp->data[0]);
+	SDLNet_Write16(0,           &packet_out_temp->data[2]);
+	packet_out_temp->len = 4;
+
+	for (int i = 0; i < spectator_count; ++i)
+		send_packet_to(packet_out_temp, &spectators[i].address);
+}
+
+// host: a packet from someone other than the opponent
+static int spectate_host_receive(UDPpacket *packet)
+{
+	Spectator *spectator = NULL;
+	for (int i = 0; i < spectator_count; ++i)
+	{
+		if (spectators[i].address.host == packet->address.host && spectators[i].address.port == packet->address.port)
+			spectator = &spectators[i];
+	}
+
+	switch (SDLNet_Read16(&packet->data[0]))
+	{
+		case PACKET_SPECTATE_JOIN:
+			if (packet->len < 6 || SDLNet_Read16(&packet->data[4]) != NET_VERSION)
+				return 0;
+
+			if (spectator == NULL)
+			{
+				if (spectator_count == network_spectators_max)
+					return 0;
+
+				spectator = &spectators[spectator_count++];
+				spectator->address = packet->address;
+			}
+			spectator->last_tick = SDL_GetTicks();
+
+			// answer with what it lacks, so it also knows the host is still there
+			if (keyframe_id == 0)
+				break;
+			if (SDLNet_Read16(&packet->data[2]) != keyframe_id)
+			{
+				spectate_send_keyframe(&spectator->address);
+			}
+			else
+			{
+				const SpectateLog *log = spectate_log(keyframe_id);
+				spectate_send_ticks(log, log->count - MIN(log->count, NET_SPECTATE_REPEAT), &spectator->address);
+			}
+			break;
+
+		case PACKET_SPECTATE_RESEND:
+			if (spectator == NULL || packet->len < 8)
+				return 0;
+
+			{
+				const SpectateLog *log = spectate_log(SDLNet_Read16(&packet->data[2]));
+				if (log == NULL)
+				{
+					// too far behind to finish that level; the keyframe says where the game went
+					spectate_send_keyframe(&spectator->address);
+					break;
+				}
+
+				Uint32 first = SDLNet_Read32(&packet->data[4]);
+				for (int i = 0; i < NET_SPECTATE_BURST && first < log->count; ++i, first += NET_SPECTATE_BATCH)
+					spectate_send_ticks(log, first, &spectator->address);
+			}
+			break;
+
+		default:
+			return 0;
+	}
+
+	return 1;
+}
+
+// spectator: a packet from the host
+static int spectate_receive(UDPpacket *packet)
+{
+	if (packet->channel != 0)
+		return 0;
+
+	switch (SDLNet_Read16(&packet->data[0]))
+	{
+		case PACKET_SPECTATE_KEYFRAME:
+			if (packet->len >= NET_KEYFRAME_SIZE)
+			{
+				const Uint16 latest_id = SDLNet_Read16(&latest_keyframe[2]);
+				if (latest_id == 0 || (Sint16)(SDLNet_Read16(&packet->data[2]) - latest_id) > 0)
+					memcpy(latest_keyframe, packet->data, sizeof(latest_keyframe));
+			}
+			break;
+
+		case PACKET_SPECTATE_TICKS:
+			if (packet->len >= 9 && SDLNet_Read16(&packet->data[2]) == played_id && played_id != 0)
+			{
+				const Uint32 first = SDLNet_Read32(&packet->data[4]);
+				const int count = MIN(packet->data[8], (packet->len - 9) / NET_SPECTATE_TICK);
+
+				for (int i = 0; i < count; ++i)
+				{
+					const Uint32 tick = first + i;
+					if (tick - spectate_next < NET_SPECTATE_RING)
+					{
+						const Uint32 slot = tick & (NET_SPECTATE_RING - 1);
+						memcpy(spectate_ring[slot], &packet->data[9 + i * NET_SPECTATE_TICK], NET_SPECTATE_TICK);
+						spectate_ring_tick[slot] = tick + 1;
+					}
+				}
+				spectate_host = MAX(spectate_host, first + count);
+			}
+			break;
+
+		case PACKET_QUIT:
+			if (!quit)
+				network_tyrian_halt(1, false);
+			break;
+
+		default:
+			return 0;
+	}
+
+	last_in_tick = SDL_GetTicks();
+
+	return 1;
+}
+
+// spectator: (re)join every so often; the host drops spectators that go quiet
+static void spectate_keep_alive(void)
+{
+	static Uint32 join_tick = 0;
+	if (SDL_GetTicks() - join_tick > NET_KEEP_ALIVE)
+	{
+		SDLNet_Write16(PACKET_SPECTATE_JOIN,                &packet_out_temp->data[0]);
+		SDLNet_Write16(SDLNet_Read16(&latest_keyframe[2]), &packet_out_temp->data[2]);
+		SDLNet_Write16(NET_VERSION,                         &packet_out_temp->data[4]);
+		network_send_no_ack(6);  // PACKET_SPECTATE_JOIN
+
+		join_tick = SDL_GetTicks();
+	}
+
+	// until the first keyframe, the players may simply not have started
+	if (keyframe_id != 0 && SDL_GetTicks() - last_in_tick > NET_TIME_OUT && !quit)
+		network_tyrian_halt(2, false);
+}
+
 // activity lately?
 static bool network_is_alive(void)
 {
@@ -202,6 +648,13 @@ int network_check(void)
 	if (!net_initialized)
 		return -1;
 
+	netsim_pump();
+
+	update_rates();
+
+	if (network_spectating)
+		spectate_keep_alive();
+
 	if (connected)
 	{
 		// timeout
@@ -216,22 +669,21 @@ int network_check(void)
 		if (SDL_GetTicks() - keep_alive_tick > NET_KEEP_ALIVE)
 		{
 			network_prepare(PACKET_KEEP_ALIVE);
-			network_send_no_ack(4);
+			SDLNet_Write32(SDL_GetTicks(), &packet_out_temp->data[4]);
+			network_send_no_ack(8);
 
 			keep_alive_tick = SDL_GetTicks();
 		}
 	}
 
 	// retry
-	if (packet_out[0] && SDL_GetTicks() - last_out_tick > NET_RETRY)
+	if (NET_PACKET(packet_out, 0) && SDL_GetTicks() - last_out_tick > NET_RETRY)
 	{
-		if (!SDLNet_UDP_Send(socket, 0, packet_out[0]))
-		{
-			printf("SDLNet_UDP_Send: %s\n", SDL_GetError());
+		if (!send_packet(NET_PACKET(packet_out, 0)))
 			return -1;
-		}
 
 		last_out_tick = SDL_GetTicks();
+		network_stats.retries++;
 	}
 
 	switch (SDLNet_UDP_Recv(socket, packet_temp))
@@ -243,6 +695,15 @@ int network_check(void)
 		case 0:
 			break;
 		default:
+			network_stats.packets_received++;
+			network_stats.bytes_received += packet_temp->len;
+
+			// a spectator hears only from the host; the host hears from spectators on no channel
+			if (network_spectating && packet_temp->len >= 4)
+				return spectate_receive(packet_temp);
+			if (packet_temp->channel == -1 && network_spectators_max > 0 && packet_temp->len >= 4)
+				return spectate_host_receive(packet_temp);
+
 			if (packet_temp->channel == 0 && packet_temp->len >= 4)
 			{
 				switch (SDLNet_Read16(&packet_temp->data[0]))
@@ -257,18 +718,18 @@ int network_check(void)
 							Uint16 i = SDLNet_Read16(&packet_temp->data[2]) - queue_out_sync;
 							if (i < NET_PACKET_QUEUE)
 							{
-								if (packet_out[i])
+								if (NET_PACKET(packet_out, i))
 								{
-									SDLNet_FreePacket(packet_out[i]);
-									packet_out[i] = NULL;
+									packet_free(NET_PACKET(packet_out, i));
+									NET_PACKET(packet_out, i) = NULL;
 								}
 							}
 						}
 
 						// remove acknowledged packets from queue
-						while (packet_out[0] == NULL && (Uint16)(last_ack_sync - queue_out_sync) < NET_PACKET_QUEUE)
+						while (NET_PACKET(packet_out, 0) == NULL && (Uint16)(last_ack_sync - queue_out_sync) < NET_PACKET_QUEUE)
 						{
-							packets_shift_up(packet_out, NET_PACKET_QUEUE);
+							packets_shift_up(&packet_out);
 
 							queue_out_sync++;
 						}
@@ -279,14 +740,7 @@ int network_check(void)
 					case PACKET_CONNECT:
 						queue_in_sync = SDLNet_Read16(&packet_temp->data[2]);
 
-						for (int i = 0; i < NET_PACKET_QUEUE; i++)
-						{
-							if (packet_in[i])
-							{
-								SDLNet_FreePacket(packet_in[i]);
-								packet_in[i] = NULL;
-							}
-						}
+						packets_clear(&packet_in);
 						// fall through
 
 					case PACKET_DETAILS:
@@ -299,9 +753,9 @@ int network_check(void)
 							Uint16 i = SDLNet_Read16(&packet_temp->data[2]) - queue_in_sync;
 							if (i < NET_PACKET_QUEUE)
 							{
-								if (packet_in[i] == NULL)
-									packet_in[i] = SDLNet_AllocPacket(NET_PACKET_SIZE);
-								packet_copy(packet_in[i], packet_temp);
+								if (NET_PACKET(packet_in, i) == NULL)
+									NET_PACKET(packet_in, i) = packet_alloc();
+								packet_copy(NET_PACKET(packet_in, i), packet_temp);
 							}
 							else
 							{
@@ -311,9 +765,27 @@ int network_check(void)
 						}
 
 						network_acknowledge(SDLNet_Read16(&packet_temp->data[2]));
-						// fall through
+
+						last_in_tick = SDL_GetTicks();
+						break;
 
 					case PACKET_KEEP_ALIVE:
+						// hand the sender's clock back so it can time the round trip
+						if (packet_temp->len >= 8)
+						{
+							SDLNet_Write16(PACKET_KEEP_ALIVE_ECHO, &packet_out_temp->data[0]);
+							SDLNet_Write16(0,                      &packet_out_temp->data[2]);
+							memcpy(&packet_out_temp->data[4], &packet_temp->data[4], 4);
+							network_send_no_ack(8);  // PACKET_KEEP_ALIVE_ECHO
+						}
+
+						last_in_tick = SDL_GetTicks();
+						break;
+
+					case PACKET_KEEP_ALIVE_ECHO:
+						if (packet_temp->len >= 8)
+							record_round_trip(SDL_GetTicks() - SDLNet_Read32(&packet_temp->data[4]));
+
 						last_in_tick = SDL_GetTicks();
 						break;
 
@@ -336,9 +808,9 @@ int network_check(void)
 							Uint16 i = SDLNet_Read16(&packet_temp->data[2]) - last_state_in_sync + 1;
 							if (i < NET_PACKET_QUEUE)
 							{
-								if (packet_state_in[i] == NULL)
-									packet_state_in[i] = SDLNet_AllocPacket(NET_PACKET_SIZE);
-								packet_copy(packet_state_in[i], packet_temp);
+								if (NET_PACKET(packet_state_in, i) == NULL)
+									NET_PACKET(packet_state_in, i) = packet_alloc();
+								packet_copy(NET_PACKET(packet_state_in, i), packet_temp);
 							}
 						}
 						break;
@@ -349,16 +821,16 @@ int network_check(void)
 							Uint16 i = SDLNet_Read16(&packet_temp->data[2]) - last_state_in_sync + 1;
 							if (i < NET_PACKET_QUEUE)
 							{
-								if (packet_state_in_xor[i] == NULL)
+								if (NET_PACKET(packet_state_in_xor, i) == NULL)
 								{
-									packet_state_in_xor[i] = SDLNet_AllocPacket(NET_PACKET_SIZE);
-									packet_copy(packet_state_in_xor[i], packet_temp);
+									NET_PACKET(packet_state_in_xor, i) = packet_alloc();
+									packet_copy(NET_PACKET(packet_state_in_xor, i), packet_temp);
 								}
-								else if (SDLNet_Read16(&packet_state_in_xor[i]->data[0]) != PACKET_STATE_XOR)
+								else if (SDLNet_Read16(&NET_PACKET(packet_state_in_xor, i)->data[0]) != PACKET_STATE_XOR)
 								{
-									for (int j = 4; j < packet_state_in_xor[i]->len; j++)
-										packet_state_in_xor[i]->data[j] ^= packet_temp->data[j];
-									SDLNet_Write16(PACKET_STATE_XOR, &packet_state_in_xor[i]->data[0]);
+									for (int j = 4; j < NET_PACKET(packet_state_in_xor, i)->len; j++)
+										NET_PACKET(packet_state_in_xor, i)->data[j] ^= packet_temp->data[j];
+									SDLNet_Write16(PACKET_STATE_XOR, &NET_PACKET(packet_state_in_xor, i)->data[0]);
 								}
 							}
 						}
@@ -370,13 +842,10 @@ int network_check(void)
 							Uint16 i = last_state_out_sync - SDLNet_Read16(&packet_temp->data[2]);
 							if (i > 0 && i < NET_PACKET_QUEUE)
 							{
-								if (packet_state_out[i])
+								if (NET_PACKET(packet_state_out, i))
 								{
-									if (!SDLNet_UDP_Send(socket, 0, packet_state_out[i]))
-									{
-										printf("SDLNet_UDP_Send: %s\n", SDL_GetError());
+									if (!send_packet(NET_PACKET(packet_state_out, i)))
 										return -1;
-									}
 								}
 							}
 						}
@@ -399,9 +868,9 @@ int network_check(void)
 // discard working packet, now processing next packet in queue
 bool network_update(void)
 {
-	if (packet_in[0])
+	if (NET_PACKET(packet_in, 0))
 	{
-		packets_shift_up(packet_in, NET_PACKET_QUEUE);
+		packets_shift_up(&packet_in);
 
 		queue_in_sync++;
 
@@ -420,98 +889,260 @@ bool network_is_sync(void)
 // prepare new state for sending
 void network_state_prepare(void)
 {
-	if (packet_state_out[0])
+	if (NET_PACKET(packet_state_out, 0))
 	{
 		fprintf(stderr, "warning: state packet overwritten (previous packet remains unsent)\n");
 	}
 	else
 	{
-		packet_state_out[0] = SDLNet_AllocPacket(NET_PACKET_SIZE);
-		packet_state_out[0]->len = 28;
+		NET_PACKET(packet_state_out, 0) = packet_alloc();
+		NET_PACKET(packet_state_out, 0)->len = 28;
 	}
 
-	SDLNet_Write16(PACKET_STATE, &packet_state_out[0]->data[0]);
-	SDLNet_Write16(last_state_out_sync, &packet_state_out[0]->data[2]);
-	memset(&packet_state_out[0]->data[4], 0, 28 - 4);
+	SDLNet_Write16(PACKET_STATE, &NET_PACKET(packet_state_out, 0)->data[0]);
+	SDLNet_Write16(last_state_out_sync, &NET_PACKET(packet_state_out, 0)->data[2]);
+	memset(&NET_PACKET(packet_state_out, 0)->data[4], 0, 28 - 4);
 }
 
 // send state packet, xor packet if applicable
 int network_state_send(void)
 {
-	if (!SDLNet_UDP_Send(socket, 0, packet_state_out[0]))
+	// a spectator has nothing to send, but counts along so network_state_is_reset() agrees with the
+	// players, and keeps what it would have sent to check its game against theirs
+	if (network_spectating)
 	{
-		printf("SDLNet_UDP_Send: %s\n", SDL_GetError());
-		return -1;
+		Uint8 *sent = spectate_sent[last_state_out_sync % NET_PACKET_QUEUE];
+		SDLNet_Write16(player[0].x, &sent[0]);
+		SDLNet_Write16(player[1].x, &sent[2]);
+		SDLNet_Write16(player[0].y, &sent[4]);
+		SDLNet_Write16(player[1].y, &sent[6]);
+		SDLNet_Write16(curLoc,      &sent[8]);
+
+		last_state_out_sync++;
+		return 0;
 	}
 
+	if (!send_packet(NET_PACKET(packet_state_out, 0)))
+		return -1;
+
 	// send xor of last network_delay packets
-	if (network_delay > 1 && (last_state_out_sync + 1) % network_delay == 0 && packet_state_out[network_delay - 1] != NULL)
+	if (network_delay > 1 && (last_state_out_sync + 1) % network_delay == 0 && NET_PACKET(packet_state_out, network_delay - 1) != NULL)
 	{
-		packet_copy(packet_temp, packet_state_out[0]);
+		packet_copy(packet_temp, NET_PACKET(packet_state_out, 0));
 		SDLNet_Write16(PACKET_STATE_XOR, &packet_temp->data[0]);
 		for (int i = 1; i < network_delay; i++)
 			for (int j = 4; j < packet_temp->len; j++)
-				packet_temp->data[j] ^= packet_state_out[i]->data[j];
+				packet_temp->data[j] ^= NET_PACKET(packet_state_out, i)->data[j];
 
-		if (!SDLNet_UDP_Send(socket, 0, packet_temp))
-		{
-			printf("SDLNet_UDP_Send: %s\n", SDL_GetError());
+		if (!send_packet(packet_temp))
 			return -1;
-		}
 	}
 
-	packets_shift_down(packet_state_out, NET_PACKET_QUEUE);
+	packets_shift_down(&packet_state_out);
 
 	last_state_out_sync++;
 
 	return 0;
 }
 
+// handle every datagram that has arrived, then sleep until one arrives or `ms` pass
+static void network_receive(Uint32 ms)
+{
+	int result;
+	while ((result = network_check()) > 0)
+		continue;
+
+	// wake up for packets the link simulator is holding back, too
+	ms = MIN(ms, netsim_pump());
+
+	if (result < 0 || socket_set == NULL || SDLNet_CheckSockets(socket_set, ms) < 0)
+		SDL_Delay(ms);
+}
+
+// soak run over: report, then stay around long enough to answer the peer's
+// resend requests, since it may still be a few ticks behind
+static void network_soak_end(void)
+{
+	netsim_soak_report();
+
+	const Uint32 linger_tick = SDL_GetTicks();
+	while (SDL_GetTicks() - linger_tick < 4 * NET_RESEND)
+		network_receive(NET_STATE_POLL);
+
+	quit = true;
+	SDLNet_Quit();
+
+	JE_tyrianHalt(0);
+}
+
+// complete the current state from what has arrived, if possible; never blocks
+static bool network_state_ready(int x)
+{
+	if (NET_PACKET(packet_state_in, 0))
+		return true;
+
+	// xor the packet from thin air, if possible
+	if (NET_PACKET(packet_state_in_xor, x) && SDLNet_Read16(&NET_PACKET(packet_state_in_xor, x)->data[0]) == PACKET_STATE_XOR)
+	{
+		// check for all other required packets
+		for (int i = 1; i <= x; i++)
+		{
+			if (NET_PACKET(packet_state_in, i) == NULL)
+				return false;
+		}
+
+		NET_PACKET(packet_state_in, 0) = packet_alloc();
+		packet_copy(NET_PACKET(packet_state_in, 0), NET_PACKET(packet_state_in_xor, x));
+		for (int i = 1; i <= x; i++)
+			for (int j = 4; j < NET_PACKET(packet_state_in, 0)->len; j++)
+				NET_PACKET(packet_state_in, 0)->data[j] ^= NET_PACKET(packet_state_in, i)->data[j];
+		network_stats.xor_recoveries++;
+		return true;
+	}
+
+	return false;
+}
+
+// host: pass the tick's states on to the spectators
+static void spectate_record(void)
+{
+	SpectateLog *log = spectate_log(keyframe_id);
+	if (log == NULL)
+		return;
+
+	if (log->count == log->cap)
+	{
+		const Uint32 cap = log->cap == 0 ? 2048 : log->cap * 2;
+		Uint8 *grown = realloc(log->ticks, cap * NET_SPECTATE_TICK);
+		if (grown == NULL)
+			return;
+		log->ticks = grown;
+		log->cap = cap;
+	}
+
+	Uint8 *tick = &log->ticks[log->count * NET_SPECTATE_TICK];
+	memcpy(tick,                      &network_state_of(1)->data[4], NET_SPECTATE_STATE);
+	memcpy(tick + NET_SPECTATE_STATE, &network_state_of(2)->data[4], NET_SPECTATE_STATE);
+	log->count++;
+
+	const Uint32 now = SDL_GetTicks();
+	for (int i = 0; i < spectator_count; )
+	{
+		if (now - spectators[i].last_tick > NET_TIME_OUT)
+		{
+			spectators[i] = spectators[--spectator_count];
+			continue;
+		}
+
+		spectate_send_ticks(log, log->count - MIN(log->count, NET_SPECTATE_REPEAT), &spectators[i].address);
+		++i;
+	}
+}
+
+// spectator: take the next tick's states from what the host has sent, waiting if need be
+static bool spectate_state_update(void)
+{
+	if (network_state_is_reset())
+		return 0;
+
+	const Uint32 tick = spectate_next;
+	const Uint32 slot = tick & (NET_SPECTATE_RING - 1);
+
+	if (network_stats.state_ticks == 0)
+		network_stats.started_tick = SDL_GetTicks();
+
+	// running flat out while catching up leaves no frame delay to take packets in
+	while (network_check() > 0)
+		continue;
+
+	const Uint32 wait_tick = SDL_GetTicks();
+	Uint32 resend_tick = wait_tick;
+	if (spectate_ring_tick[slot] != tick + 1)
+	{
+		network_stats.stalls++;
+
+		// only ask at once for what the host has played already
+		if (spectate_host > tick)
+			resend_tick -= NET_SPECTATE_RESEND + 1;
+	}
+
+	while (spectate_ring_tick[slot] != tick + 1)
+	{
+		// the host keeps only the last level's ticks besides this one's
+		if ((Uint16)(SDLNet_Read16(&latest_keyframe[2]) - played_id) >= 2)
+			network_tyrian_halt(7, false);
+
+		if (SDL_GetTicks() - resend_tick > NET_SPECTATE_RESEND)
+		{
+			SDLNet_Write16(PACKET_SPECTATE_RESEND, &packet_out_temp->data[0]);
+			SDLNet_Write16(played_id,              &packet_out_temp->data[2]);
+			SDLNet_Write32(tick,                   &packet_out_temp->data[4]);
+			network_send_no_ack(8);  // PACKET_SPECTATE_RESEND
+
+			resend_tick = SDL_GetTicks();
+			network_stats.resends++;
+		}
+
+		service_SDL_events(false);
+
+		if (newkey && lastkey_scan == SDL_SCANCODE_ESCAPE)
+			network_tyrian_halt(0, false);
+
+		network_receive(NET_STATE_POLL);
+	}
+
+	memcpy(&spectate_state[0]->data[4], &spectate_ring[slot][0],                  NET_SPECTATE_STATE);
+	memcpy(&spectate_state[1]->data[4], &spectate_ring[slot][NET_SPECTATE_STATE], NET_SPECTATE_STATE);
+	spectate_ring_tick[slot] = 0;
+	spectate_next++;
+
+	// the players' states carry where they had the ships when they sent them
+	const Uint16 sync = last_state_out_sync - network_delay;
+	if ((Sint16)(sync - spectate_first_sync) >= 0 &&
+	    memcmp(&spectate_state[0]->data[18], spectate_sent[sync % NET_PACKET_QUEUE], sizeof(*spectate_sent)) != 0)
+		network_stats.desyncs++;
+
+	network_stats.stalled_ms += SDL_GetTicks() - wait_tick;
+	network_stats.state_ticks++;
+
+	if (net_soak_frames > 0 && network_stats.state_ticks >= (Uint32)net_soak_frames)
+		network_soak_end();
+
+	return 1;
+}
+
 // receive state packet, wait until received
 bool network_state_update(void)
 {
+	if (network_spectating)
+		return spectate_state_update();
+
 	if (network_state_is_reset())
 	{
 		return 0;
 	}
 	else
 	{
-		packets_shift_up(packet_state_in, NET_PACKET_QUEUE);
+		packets_shift_up(&packet_state_in);
 
-		packets_shift_up(packet_state_in_xor, NET_PACKET_QUEUE);
+		packets_shift_up(&packet_state_in_xor);
 
 		last_state_in_sync++;
 
 		// current xor packet index
 		int x = network_delay - (last_state_in_sync - 1) % network_delay - 1;
 
+		if (network_stats.state_ticks == 0)
+			network_stats.started_tick = SDL_GetTicks();
+
+		const Uint32 wait_tick = SDL_GetTicks();
+		Uint32 present_tick = wait_tick;
+		if (!network_state_ready(x))
+			network_stats.stalls++;
+
 		// loop until needed packet is available
-		while (!packet_state_in[0])
+		while (!network_state_ready(x))
 		{
-			// xor the packet from thin air, if possible
-			if (packet_state_in_xor[x] && SDLNet_Read16(&packet_state_in_xor[x]->data[0]) == PACKET_STATE_XOR)
-			{
-				// check for all other required packets
-				bool okay = true;
-				for (int i = 1; i <= x; i++)
-				{
-					if (packet_state_in[i] == NULL)
-					{
-						okay = false;
-						break;
-					}
-				}
-				if (okay)
-				{
-					packet_state_in[0] = SDLNet_AllocPacket(NET_PACKET_SIZE);
-					packet_copy(packet_state_in[0], packet_state_in_xor[x]);
-					for (int i = 1; i <= x; i++)
-						for (int j = 4; j < packet_state_in[0]->len; j++)
-							packet_state_in[0]->data[j] ^= packet_state_in[i]->data[j];
-					break;
-				}
-			}
-
 			static Uint32 resend_tick = 0;
 			if (SDL_GetTicks() - last_state_in_tick > NET_RESEND && SDL_GetTicks() - resend_tick > NET_RESEND)
 			{
@@ -520,29 +1151,49 @@ bool network_state_update(void)
 				network_send_no_ack(4);  // PACKET_RESEND
 
 				resend_tick = SDL_GetTicks();
+				network_stats.resends++;
 			}
 
-			if (network_check() == 0)
-				SDL_Delay(1);
+			// Lockstep can only hold the tick until the packet comes; predicting the other
+			// player's input and rolling back would need a snapshot of the whole game, which
+			// lives in globals.  Keep the window and its input alive in the meantime.
+			if (SDL_GetTicks() - present_tick >= NET_STATE_PRESENT)
+			{
+				service_SDL_events(false);
+				video_present_last_frame();
+
+				present_tick = SDL_GetTicks();
+			}
+
+			network_receive(NET_STATE_POLL);
 		}
 
 		if (network_delay > 1)
 		{
 			// process the current in packet against the xor queue
-			if (packet_state_in_xor[x] == NULL)
+			if (NET_PACKET(packet_state_in_xor, x) == NULL)
 			{
-				packet_state_in_xor[x] = SDLNet_AllocPacket(NET_PACKET_SIZE);
-				packet_copy(packet_state_in_xor[x], packet_state_in[0]);
-				packet_state_in_xor[x]->status = 0;
+				NET_PACKET(packet_state_in_xor, x) = packet_alloc();
+				packet_copy(NET_PACKET(packet_state_in_xor, x), NET_PACKET(packet_state_in, 0));
+				NET_PACKET(packet_state_in_xor, x)->status = 0;
 			}
 			else
 			{
-				for (int j = 4; j < packet_state_in_xor[x]->len; j++)
-					packet_state_in_xor[x]->data[j] ^= packet_state_in[0]->data[j];
+				for (int j = 4; j < NET_PACKET(packet_state_in_xor, x)->len; j++)
+					NET_PACKET(packet_state_in_xor, x)->data[j] ^= NET_PACKET(packet_state_in, 0)->data[j];
 			}
 		}
 
 		last_state_in_tick = SDL_GetTicks();
+
+		network_stats.stalled_ms += last_state_in_tick - wait_tick;
+		network_stats.state_ticks++;
+
+		if (thisPlayerNum == 1 && network_spectators_max > 0)
+			spectate_record();
+
+		if (net_soak_frames > 0 && network_stats.state_ticks >= (Uint32)net_soak_frames)
+			network_soak_end();
 	}
 
 	return 1;
@@ -559,32 +1210,103 @@ void network_state_reset(void)
 {
 	last_state_in_sync = last_state_out_sync = 0;
 
-	for (int i = 0; i < NET_PACKET_QUEUE; i++)
+	packets_clear(&packet_state_in);
+	packets_clear(&packet_state_in_xor);
+	packets_clear(&packet_state_out);
+
+	last_state_in_tick = SDL_GetTicks();
+}
+
+// the state packet that moves player `playerNum` this tick
+UDPpacket *network_state_of(uint playerNum)
+{
+	if (network_spectating)
+		return spectate_state[playerNum - 1];
+
+	return playerNum == thisPlayerNum ? NET_PACKET(packet_state_out, network_delay) : NET_PACKET(packet_state_in, 0);
+}
+
+// is this spectator far enough behind the host that it should skip the frame delay?
+bool network_catching_up(void)
+{
+	return network_spectating && spectate_host > spectate_next + NET_SPECTATE_SLACK;
+}
+
+// spectator: wait for a keyframe it has not taken yet, and take it
+static void spectate_take_keyframe(void)
+{
+	while (SDLNet_Read16(&latest_keyframe[2]) == keyframe_id)
 	{
-		if (packet_state_in[i])
-		{
-			SDLNet_FreePacket(packet_state_in[i]);
-			packet_state_in[i] = NULL;
-		}
+		service_SDL_events(false);
+		JE_showVGA();
+
+		if (newkey && lastkey_scan == SDL_SCANCODE_ESCAPE)
+			network_tyrian_halt(0, false);
+
+		network_receive(16);
 	}
-	for (int i = 0; i < NET_PACKET_QUEUE; i++)
+
+	read_keyframe();
+}
+
+// a level is about to start: the host sends its spectators a keyframe; a
+// spectator lines up with the host's ticks for the level
+void network_level_start(void)
+{
+	if (network_spectating)
 	{
-		if (packet_state_in_xor[i])
-		{
-			SDLNet_FreePacket(packet_state_in_xor[i]);
-			packet_state_in_xor[i] = NULL;
-		}
+		// back at the start of a level without passing the item screen (a retry)
+		if (keyframe_id == played_id)
+			spectate_take_keyframe();
+
+		played_id = keyframe_id;
+
+		network_state_reset();
+		last_state_out_sync = SDLNet_Read16(&keyframe[14]);
+		spectate_first_sync = last_state_out_sync;
+
+		memset(spectate_ring_tick, 0, sizeof(spectate_ring_tick));
+		spectate_next = 0;
+		spectate_host = 0;
 	}
-	for (int i = 0; i < NET_PACKET_QUEUE; i++)
+	else if (thisPlayerNum == 1 && network_spectators_max > 0)
 	{
-		if (packet_state_out[i])
-		{
-			SDLNet_FreePacket(packet_state_out[i]);
-			packet_state_out[i] = NULL;
-		}
+		if (++keyframe_id == 0)
+			keyframe_id = 1;
+
+		SpectateLog *log = &spectate_logs[keyframe_id % COUNTOF(spectate_logs)];
+		log->keyframe_id = keyframe_id;
+		log->count = 0;
+
+		write_keyframe();
+
+		for (int i = 0; i < spectator_count; ++i)
+			spectate_send_keyframe(&spectators[i].address);
+	}
+}
+
+// spectator: find the host and take the game from its latest keyframe
+void network_spectate_join(void)
+{
+	thisPlayerNum = 0;
+
+	SDLNet_ResolveHost(&ip, network_opponent_host, network_opponent_port);
+	SDLNet_UDP_Bind(socket, 0, &ip);
+
+	for (uint i = 0; i < COUNTOF(spectate_state); ++i)
+	{
+		spectate_state[i] = packet_alloc();
+		memset(spectate_state[i]->data, 0, 28);
+		spectate_state[i]->len = 28;
 	}
 
-	last_state_in_tick = SDL_GetTicks();
+	spectate_take_keyframe();
+}
+
+// spectator: in place of the item screen, follow the players to their next level
+void network_spectate_next_level(void)
+{
+	spectate_take_keyframe();
 }
 
 // attempt to punch through firewall by firing off UDP packets at the opponent
@@ -629,7 +1351,7 @@ connect_reset:
 		// never timeout
 		last_in_tick = SDL_GetTicks();
 
-		if (packet_in[0] && SDLNet_Read16(&packet_in[0]->data[0]) == PACKET_CONNECT)
+		if (NET_PACKET(packet_in, 0) && SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[0]) == PACKET_CONNECT)
 			break;
 
 		network_update();
@@ -639,30 +1361,30 @@ connect_reset:
 	}
 
 connect_again:
-	if (SDLNet_Read16(&packet_in[0]->data[4]) != NET_VERSION)
+	if (SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[4]) != NET_VERSION)
 	{
 		fprintf(stderr, "error: network version did not match opponent's\n");
 		network_tyrian_halt(4, true);
 	}
-	if (SDLNet_Read16(&packet_in[0]->data[6]) != network_delay)
+	if (SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[6]) != network_delay)
 	{
 		fprintf(stderr, "error: network delay did not match opponent's\n");
 		network_tyrian_halt(5, true);
 	}
-	if (SDLNet_Read16(&packet_in[0]->data[10]) == thisPlayerNum)
+	if (SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[10]) == thisPlayerNum)
 	{
 		fprintf(stderr, "error: player number conflicts with opponent's\n");
 		network_tyrian_halt(6, true);
 	}
 
-	episodes = SDLNet_Read16(&packet_in[0]->data[8]);
+	episodes = SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[8]);
 	for (int i = 0; i < EPISODE_MAX; i++) {
 		episodeAvail[i] &= (episodes & 1);
 		episodes >>= 1;
 	}
 
-	network_opponent_name = malloc(packet_in[0]->len - 12 + 1);
-	strcpy(network_opponent_name, (char *)&packet_in[0]->data[12]);
+	network_opponent_name = malloc(NET_PACKET(packet_in, 0)->len - 12 + 1);
+	strcpy(network_opponent_name, (char *)&NET_PACKET(packet_in, 0)->data[12]);
 
 	network_update();
 
@@ -672,7 +1394,7 @@ connect_again:
 		service_SDL_events(false);
 
 		// got a duplicate packet; process it again (but why?)
-		if (packet_in[0] && SDLNet_Read16(&packet_in[0]->data[0]) == PACKET_CONNECT)
+		if (NET_PACKET(packet_in, 0) && SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[0]) == PACKET_CONNECT)
 			goto connect_again;
 
 		network_check();
@@ -710,8 +1432,12 @@ void network_tyrian_halt(unsigned int err, bool attempt_sync)
 		"Network version mismatch.",
 		"Network delay mismatch.",
 		"Network player number conflict.",
+		"Fell too far behind the game.",
 	};
 
+	if (!quit)
+		spectate_send_quit();
+
 	quit = true;
 
 	if (err >= COUNTOF(err_msg))
@@ -738,7 +1464,7 @@ void network_tyrian_halt(unsigned int err, bool attempt_sync)
 		}
 	}
 
-	if (err)
+	if (err && net_soak_frames == 0)
 	{
 		while (!JE_anyButton())
 			SDL_Delay(16);
@@ -774,6 +1500,14 @@ int network_init(void)
 		return -2;
 	}
 
+	// only used to wake up when a datagram arrives; without it we poll
+	socket_set = SDLNet_AllocSocketSet(1);
+	if (socket_set != NULL && SDLNet_UDP_AddSocket(socket_set, socket) < 0)
+	{
+		SDLNet_FreeSocketSet(socket_set);
+		socket_set = NULL;
+	}
+
 	packet_temp = SDLNet_AllocPacket(NET_PACKET_SIZE);
 	packet_out_temp = SDLNet_AllocPacket(NET_PACKET_SIZE);
 
@@ -783,6 +1517,18 @@ int network_init(void)
 		return -3;
 	}
 
+	// allocate every queued packet up front, so netplay never allocates mid-game
+	while (packet_pool_count < NET_PACKET_POOL)
+	{
+		UDPpacket *packet = SDLNet_AllocPacket(NET_PACKET_SIZE);
+		if (!packet)
+		{
+			printf("SDLNet_AllocPacket: %s\n", SDLNet_GetError());
+			return -3;
+		}
+		packet_pool[packet_pool_count++] = packet;
+	}
+
 	net_initialized = true;
 
 	return 0;
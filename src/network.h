@@ -27,7 +27,8 @@
 #endif
 
 #define PACKET_ACKNOWLEDGE   0x00    // 
-#define PACKET_KEEP_ALIVE    0x01    // 
+#define PACKET_KEEP_ALIVE    0x01    // time
+#define PACKET_KEEP_ALIVE_ECHO 0x02  // time  (the keep-alive's, sent straight back)
 
 #define PACKET_CONNECT       0x10    // version, delay, episodes, player_number, name
 #define PACKET_DETAILS       0x11    // episode, difficulty
@@ -44,6 +45,11 @@
 #define PACKET_STATE         0x41    // <state>  (not acknowledged)
 #define PACKET_STATE_XOR     0x42    // <xor state>  (not acknowledged)
 
+#define PACKET_SPECTATE_JOIN     0x50  // keyframe_id, version  (the spectator's keep-alive, too)
+#define PACKET_SPECTATE_KEYFRAME 0x51  // keyframe_id, <keyframe>
+#define PACKET_SPECTATE_TICKS    0x52  // keyframe_id, first_tick, count, <states>  (not acknowledged)
+#define PACKET_SPECTATE_RESEND   0x53  // keyframe_id, first_tick
+
 extern bool isNetworkGame;
 extern int network_delay;
 
@@ -51,10 +57,54 @@ extern char *network_opponent_host;
 extern Uint16 network_player_port, network_opponent_port;
 extern char *network_player_name, *network_opponent_name;
 
+extern bool network_spectating;     // watching the host's game rather than playing in it
+extern int network_spectators_max;  // spectators the host (player 1) will serve
+
 #ifdef WITH_NETWORK
+#define NET_PACKET_QUEUE  16  // power of two
+
+// A window of packets indexed by sequence number relative to the oldest one.
+// Sliding it along only moves `head`; empty slots are NULL.
+typedef struct
+{
+	UDPpacket *slot[NET_PACKET_QUEUE];
+	unsigned int head;  // slot of the oldest packet
+} PacketQueue;
+
+#define NET_PACKET(queue, i) ((queue).slot[((queue).head + (i)) & (NET_PACKET_QUEUE - 1)])
+
 extern UDPpacket *packet_out_temp;
-extern UDPpacket *packet_in[], *packet_out[],
-                 *packet_state_in[], *packet_state_out[];
+extern PacketQueue packet_in, packet_out,
+                   packet_state_in, packet_state_out;
+
+typedef struct
+{
+	Uint32 started_tick;    // of the first state tick
+	Uint32 state_ticks;     // state packets taken in
+	Uint32 stalls;          // state ticks that had to wait for their packet
+	Uint32 stalled_ms;
+	Uint32 resends;         // state packets asked for again
+	Uint32 retries;         // acknowledged packets sent again for want of an ack
+	Uint32 xor_recoveries;  // state packets rebuilt from an xor packet
+	Uint32 desyncs;         // state ticks where the peers disagreed on player positions
+
+	Uint32 packets_sent, packets_received;
+	Uint32 bytes_sent, bytes_received;  // UDP payload
+
+	// over the last second
+	float packets_sent_rate, packets_received_rate;
+	float bytes_sent_rate, bytes_received_rate;
+	float stalled_ms_rate;
+
+	Uint32 rtt_count;       // round trips timed, by keep-alive echo
+	float rtt_ms;           // smoothed
+	Uint32 rtt_p95_ms;      // of the last 64
+
+	Uint32 spectators;      // being served, by the host
+} NetworkStats;
+
+extern NetworkStats network_stats;
+extern bool network_overlay;  // draw network_stats over the game
 #endif
 
 extern uint thisPlayerNum;
@@ -77,12 +127,21 @@ int network_state_send(void);
 bool network_state_update(void);
 bool network_state_is_reset(void);
 void network_state_reset(void);
+UDPpacket *network_state_of(uint playerNum);
+bool network_catching_up(void);
+
+void network_level_start(void);
+void network_spectate_join(void);
+void network_spectate_next_level(void);
 
 int network_connect(void);
 void network_tyrian_halt(unsigned int err, bool attempt_sync);
 
 int network_init(void);
 
+void network_reset_stats(void);
+void network_draw_overlay(SDL_Surface *screen);
+
 void JE_clearSpecialRequests(void);
 
 #define NETWORK_KEEP_ALIVE() \
@@ -25,6 +25,8 @@
 #include "musmast.h"
 #include "opentyr.h"
 #include "params.h"
+#include "preload.h"
+#include "resample.h"
 #include "sndmast.h"
 #include "vga256d.h"
 
@@ -112,132 +114,135 @@ void wait_delayorinput(void)
 	}
 }
 
-void loadSndFile(bool xmas)
+// Finds sample i of a mapped .snd file; the end of the last sample is the end of the file.
+static bool sndFileSample(const FileView *view, size_t count, size_t i, const Uint8 **out_data, size_t *out_size)
 {
-	FILE *f;
+	if (view->size < 2 || view_read_u16(view->data) != count || view->size < 2 + count * 4)
+		return false;
 
-	f = dir_fopen_die(data_dir(), "tyrian.snd", "rb");
+	const Uint32 begin = view_read_u32(view->data + 2 + i * 4);
+	const Uint32 end = i + 1 < count
+		? view_read_u32(view->data + 2 + (i + 1) * 4)
+		: view->size;
 
-	Uint16 sfxCount;
-	Uint32 sfxPositions[SFX_COUNT + 1];
+	if (end < begin || end > view->size)
+		return false;
 
-	// Read number of sounds.
-	fread_u16_die(&sfxCount, 1, f);
-	if (sfxCount != SFX_COUNT)
-		goto die;
+	*out_data = view->data + begin;
+	*out_size = end - begin;
+	return true;
+}
 
-	// Read positions of sounds.
-	fread_u32_die(sfxPositions, sfxCount, f);
+void loadSndFile(bool xmas)
+{
+	// Raw samples point straight into the mapped files; only converted samples are allocated.
+	const Uint8 *rawSamples[SOUND_COUNT];
+	size_t rawSampleCount[SOUND_COUNT];
 
-	// Determine end of last sound.
-	fseek(f, 0, SEEK_END);
-	sfxPositions[sfxCount] = ftell(f);
+	const FileView sfxView = dir_map_die(data_dir(), "tyrian.snd");
 
-	// Read samples.
-	for (size_t i = 0; i < sfxCount; ++i)
+	for (size_t i = 0; i < SFX_COUNT; ++i)
 	{
-		soundSampleCount[i] = sfxPositions[i + 1] - sfxPositions[i];
+		size_t size;
+		if (!sndFileSample(&sfxView, SFX_COUNT, i, &rawSamples[i], &size))
+			goto die;
 
 		// Sound size cannot exceed 64 KiB.
-		if (soundSampleCount[i] > UINT16_MAX)
+		if (size > UINT16_MAX)
 			goto die;
 
-		free(soundSamples[i]);
-		soundSamples[i] = malloc(soundSampleCount[i]);
-
-		fseek(f, sfxPositions[i], SEEK_SET);
-		fread_u8_die((Uint8 *)soundSamples[i], soundSampleCount[i], f);
+		rawSampleCount[i] = size;
 	}
 
-	fclose(f);
-
-	f = dir_fopen_die(data_dir(), xmas ? "voicesc.snd" : "voices.snd", "rb");
+	const FileView voiceView = dir_map_die(data_dir(), xmas ? "voicesc.snd" : "voices.snd");
 
-	Uint16 voiceCount;
-	Uint32 voicePositions[VOICE_COUNT + 1];
-
-	// Read number of sounds.
-	fread_u16_die(&voiceCount, 1, f);
-	if (voiceCount != VOICE_COUNT)
-		goto die;
-
-	// Read positions of sounds.
-	fread_u32_die(voicePositions, voiceCount, f);
-
-	// Determine end of last sound.
-	fseek(f, 0, SEEK_END);
-	voicePositions[voiceCount] = ftell(f);
-
-	for (size_t vi = 0; vi < voiceCount; ++vi)
+	for (size_t vi = 0; vi < VOICE_COUNT; ++vi)
 	{
 		size_t i = SFX_COUNT + vi;
 
-		soundSampleCount[i] = voicePositions[vi + 1] - voicePositions[vi];
+		size_t size;
+		if (!sndFileSample(&voiceView, VOICE_COUNT, vi, &rawSamples[i], &size))
+			goto die;
 
 		// Voice sounds have some bad data at the end.
-		soundSampleCount[i] = soundSampleCount[i] >= 100
-			? soundSampleCount[i] - 100
+		size = size >= 100
+			? size - 100
 			: 0;
 
 		// Sound size cannot exceed 64 KiB.
-		if (soundSampleCount[i] > UINT16_MAX)
+		if (size > UINT16_MAX)
 			goto die;
 
-		free(soundSamples[i]);
-		soundSamples[i] = malloc(soundSampleCount[i]);
-
-		fseek(f, voicePositions[vi], SEEK_SET);
-		fread_u8_die((Uint8 *)soundSamples[i], soundSampleCount[i], f);
+		rawSampleCount[i] = size;
 	}
 
-	fclose(f);
+	// Convert samples to output sample format and rate.  This runs on a preload worker
+	// while the audio device is already open, so the converted table is built aside and
+	// only published once complete; nothing plays a sound until the preload is joined.
 
-	// Convert samples to output sample format and rate.
+	Sint16 *samples[SOUND_COUNT] = { NULL };
+	size_t sampleCount[SOUND_COUNT] = { 0 };
 
-	SDL_AudioCVT cvt;
-	if (SDL_BuildAudioCVT(&cvt, AUDIO_S8, 1, 11025, AUDIO_S16SYS, 1, audioSampleRate) < 0)
+	Resampler resampler;
+	if (!resampler_init(&resampler, 11025, audioSampleRate))
 	{
-		fprintf(stderr, "error: Failed to build audio converter: %s\n", SDL_GetError());
-
-		for (int i = 0; i < SOUND_COUNT; ++i)
-			soundSampleCount[i] = 0;
-
-		return;
+		fprintf(stderr, "error: Failed to build audio resampler\n");
 	}
-
-	size_t maxSampleSize = 0;
-	for (size_t i = 0; i < SOUND_COUNT; ++i)
-		maxSampleSize = MAX(maxSampleSize, soundSampleCount[i]);
-
-	cvt.buf = malloc(maxSampleSize * cvt.len_mult);
-
-	for (size_t i = 0; i < SOUND_COUNT; ++i)
+	else
 	{
-		cvt.len = soundSampleCount[i];
-		memcpy(cvt.buf, soundSamples[i], cvt.len);
+		size_t maxSampleSize = 0;
+		for (size_t i = 0; i < SOUND_COUNT; ++i)
+			maxSampleSize = MAX(maxSampleSize, rawSampleCount[i]);
+
+		Sint16 *widened = malloc(MAX(maxSampleSize, 1) * sizeof(*widened));
+		bool ok = widened != NULL;
 
-		if (SDL_ConvertAudio(&cvt))
+		for (size_t i = 0; ok && i < SOUND_COUNT; ++i)
 		{
-			fprintf(stderr, "error: Failed to convert audio: %s\n", SDL_GetError());
+			const size_t count = rawSampleCount[i];
+			for (size_t j = 0; j < count; ++j)
+				widened[j] = (Sint8)rawSamples[i][j] * 256;
+
+			sampleCount[i] = resampler_output_count(&resampler, count);
+			samples[i] = malloc(MAX(sampleCount[i], 1) * sizeof(Sint16));
+			if (samples[i] == NULL)
+			{
+				ok = false;
+				break;
+			}
+
+			resampler_run(&resampler, widened, count, samples[i]);
+		}
 
-			soundSampleCount[i] = 0;
+		free(widened);
+		resampler_free(&resampler);
 
-			continue;
+		if (!ok)
+		{
+			fprintf(stderr, "error: Not enough memory for the sound effects\n");
+
+			// play without sound effects, as when the resampler cannot be built
+			for (size_t i = 0; i < SOUND_COUNT; ++i)
+			{
+				free(samples[i]);
+				samples[i] = NULL;
+				sampleCount[i] = 0;
+			}
 		}
+	}
 
+	for (size_t i = 0; i < SOUND_COUNT; ++i)
+	{
 		free(soundSamples[i]);
-		soundSamples[i] = malloc(cvt.len_cvt);
-
-		memcpy(soundSamples[i], cvt.buf, cvt.len_cvt);
-		soundSampleCount[i] = cvt.len_cvt / sizeof (Sint16);
+		soundSamples[i] = samples[i];
+		soundSampleCount[i] = sampleCount[i];
 	}
 
-	free(cvt.buf);
-
 	return;
 
 die:
 	fprintf(stderr, "error: Unexpected data was read from a file.\n");
+	preload_halting();
 	SDL_Quit();
 	exit(EXIT_FAILURE);
 }
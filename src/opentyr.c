@@ -19,6 +19,7 @@
 #include "opentyr.h"
 
 #include "config.h"
+#include "demo_bench.h"
 #include "destruct.h"
 #include "editship.h"
 #include "episodes.h"
@@ -40,7 +41,9 @@
 #include "palette.h"
 #include "params.h"
 #include "picload.h"
+#include "preload.h"
 #include "sprite.h"
+#include "startup_report.h"
 #include "tyrian2.h"
 #include "varz.h"
 #include "vga256d.h"
@@ -982,19 +985,53 @@ int main(int argc, char *argv[])
 
 	JE_paramCheck(argc, argv);
 
+	startup_report_begin();
+
 	if (!override_xmas) // arg handler may override
 		xmas = xmas_time();
 
-	JE_loadHelpText();
+	data_dir();
+	startup_report_phase("data_dir");
+
+	if (xmas && (!dir_file_exists(data_dir(), "tyrianc.shp") || !dir_file_exists(data_dir(), "voicesc.snd")))
+	{
+		xmas = false;
+
+		fprintf(stderr, "warning: Christmas is missing.\n");
+	}
+	startup_report_phase("xmas_check");
+
+	if (renderSong > 0)
+	{
+		// headless; needs neither a window nor an audio device
+		const int song = renderSong == RENDER_ALL_SONGS ? -1 : (int)renderSong - 1;
+		const bool ok = render_song_offline(song, renderSongSeconds, renderSongPath, renderSongComparePath);
+		SDL_Quit();
+		return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// Independent loads overlap with configuration, window creation and the
+	// intro logos; each is joined right before its first use.
+	preload_init();
+	preload_start(PRELOAD_HELP_TEXT, xmas);
+	preload_start(PRELOAD_PALETTES, xmas);
+	preload_start(PRELOAD_MAIN_SHAPES, xmas);
+
+	preload_wait(PRELOAD_HELP_TEXT);
 	/*debuginfo("Help text complete");*/
+	startup_report_phase("help_text");
 
 	JE_loadConfiguration();
+	startup_report_phase("config");
 
 	JE_scanForEpisodes();
+	startup_report_phase("episode_scan");
 
 	init_video();
+	startup_report_phase("video_init");
 	init_keyboard();
 	init_joysticks();
+	startup_report_phase("input_init");
 
 	if (remote_control_is_enabled())
 	{
@@ -1004,23 +1041,21 @@ int main(int argc, char *argv[])
 	}
 	remote_control_set_ui_context("boot");
 	printf("assuming mouse detected\n"); // SDL can't tell us if there isn't one
+	startup_report_phase("remote_control");
 
-	if (xmas && (!dir_file_exists(data_dir(), "tyrianc.shp") || !dir_file_exists(data_dir(), "voicesc.snd")))
+	if (xmas && !override_xmas)
 	{
-		xmas = false;
-
-		fprintf(stderr, "warning: Christmas is missing.\n");
-	}
+		preload_wait(PRELOAD_PALETTES);
+		preload_wait(PRELOAD_MAIN_SHAPES);
 
-	JE_loadPals();
-	JE_loadMainShapeTables(xmas ? "tyrianc.shp" : "tyrian.shp");
-
-	if (xmas && !override_xmas && !xmas_prompt())
-	{
-		xmas = false;
+		if (!xmas_prompt())
+		{
+			xmas = false;
 
-		free_main_shape_tables();
-		JE_loadMainShapeTables("tyrian.shp");
+			free_main_shape_tables();
+			JE_loadMainShapeTables("tyrian.shp");
+		}
+		startup_report_phase("xmas_prompt");
 	}
 
 	/* Default Options */
@@ -1032,11 +1067,16 @@ int main(int argc, char *argv[])
 	{
 		printf("initializing SDL audio...\n");
 
-		init_audio();
+		const bool audio_ok = init_audio();
+		startup_report_phase("audio_init");
 
-		load_music();
+		// both are converted for the device, so they wait for it to open
+		if (audio_ok)
+		{
+			preload_start(PRELOAD_MUSIC, xmas);
 
-		loadSndFile(xmas);
+			preload_start(PRELOAD_SOUNDS, xmas);
+		}
 	}
 	else
 	{
@@ -1047,12 +1087,14 @@ int main(int argc, char *argv[])
 		printf("demo recording enabled (input limited to keyboard)\n");
 
 	JE_loadExtraShapes();  /*Editship*/
+	startup_report_phase("extra_shapes");
 
 	if (isNetworkGame)
 	{
 #ifdef WITH_NETWORK
 		if (network_init())
 		{
+			preload_shutdown();  // the quit screen needs the palettes, and nothing may still be loading
 			network_tyrian_halt(3, false);
 		}
 #else
@@ -1061,15 +1103,24 @@ int main(int argc, char *argv[])
 #endif
 	}
 
+	preload_wait(PRELOAD_PALETTES);
+	startup_report_phase("palettes_join");
+
 #ifdef NDEBUG
 	if (!isNetworkGame && !startInSetupMenu && !startInJukebox)
 		intro_logos();
 #endif
+	startup_report_phase("intro_logos");
+
+	preload_shutdown();
+	startup_report_phase("preload_join");
+	startup_report_print("startup");
 
 	for (; ; )
 	{
 		JE_initPlayerData();
 		JE_sortHighScores();
+		remote_control_on_game_start();
 
 		play_demo = false;
 		stopped_demo = false;
@@ -1104,6 +1155,14 @@ int main(int argc, char *argv[])
 		}
 		else
 #endif
+		if (demo_bench_passes > 0)
+		{
+			if (!demo_bench_next())
+				break;
+
+			play_demo = true;
+		}
+		else
 		{
 			if (!titleScreen())
 			{
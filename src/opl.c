@@ -188,6 +188,7 @@ static Bit32u generator_add;	// should be a chip parameter
 
 static fltype recipsamp;	// inverse of sampling rate
 static Bit16s wavtable[WAVEPREC*3];	// wave form table
+static fltype wavtable_fl[WAVEPREC*3];	// the same, for the block output loops
 
 // vibrato/tremolo tables
 static Bit32s vib_table[VIBTAB_SIZE];
@@ -195,6 +196,7 @@ static Bit32s trem_table[TREMTAB_SIZE*2];
 
 static Bit32s vibval_const[BLOCKBUF_SIZE];
 static Bit32s tremval_const[BLOCKBUF_SIZE];
+static fltype tremval_const_fl[BLOCKBUF_SIZE];
 
 // vibrato value tables (used per-operator)
 static Bit32s vibval_var1[BLOCKBUF_SIZE];
@@ -712,6 +714,7 @@ void adlib_init(Bit32u samplerate) {
 	tremtab_pos = 0;
 
 	for (i=0; i<BLOCKBUF_SIZE; i++) tremval_const[i] = FIXEDPT;
+	for (i=0; i<BLOCKBUF_SIZE; i++) tremval_const_fl[i] = FIXEDPT;
 
 
 	static Bitu initfirstime = 0;
@@ -732,6 +735,7 @@ void adlib_init(Bit32u samplerate) {
 			wavtable[i+(WAVEPREC<<1)]		= wavtable[i+(WAVEPREC>>3)]-16384;
 			wavtable[i+((WAVEPREC*17)>>3)]	= wavtable[i+(WAVEPREC>>2)]+16384;
 		}
+		for (i=0;i<WAVEPREC*3;i++) wavtable_fl[i] = wavtable[i];
 
 		// key scale level table verified ([table in book]*8/3)
 		kslev[7][0] = 0;	kslev[7][1] = 24;	kslev[7][2] = 32;	kslev[7][3] = 37;
@@ -1088,6 +1092,210 @@ OPL_INLINE static void clipit16(Bit32s ival, Bit16s* outval) {
 
 
 
+// Block processing for 2op channels.
+// The per-sample path interleaves phase, envelope and output of each operator.
+// Here each of them is a pass over the whole block instead, so that the output
+// pass is a plain loop without calls or state dispatch, and sustained or silent
+// operators update their envelope once per block. The result is identical: the
+// operators of a channel only interact through the modulator output, which the
+// carrier pass reads from the modulator's buffer.
+typedef struct {
+	Bit32u wfpos[BLOCKBUF_SIZE];	// waveform position per sample
+	fltype ampvol[BLOCKBUF_SIZE];	// step_amp*vol per sample (the first product in operator_output)
+	Bit8u active[BLOCKBUF_SIZE];	// op_state != OF_TYPE_OFF after the envelope step
+	Bits num_active;
+} opblock_type;
+
+// as operator_advance and opfuncs[op_state] for each sample of the block
+static void operator_block_advance(op_type* op_pt, const Bit32s* vib, Bits n, opblock_type* blk) {
+	Bits i;
+
+	Bit32u tcount = op_pt->tcount;
+	const Bit32u tinc = op_pt->tinc;
+	for (i=0;i<n;i++) {
+		blk->wfpos[i] = tcount;
+		tcount += tinc;
+		tcount += (Bit32s)(tinc)*vib[i]/FIXEDPT;
+	}
+	op_pt->tcount = tcount;
+	op_pt->wfpos = blk->wfpos[n-1];
+
+	if (op_pt->op_state == OF_TYPE_OFF) {
+		// operator_off leaves the generator position alone
+		op_pt->generator_pos += (Bit32u)n*generator_add;
+		blk->num_active = 0;
+	} else if (op_pt->op_state == OF_TYPE_SUS) {
+		// operator_sustain only counts (standardized) samples; after the first
+		// sample generator_pos is below FIXEDPT, so the rest of the block can be
+		// counted in one go
+		op_pt->generator_pos += generator_add;
+		Bit32u num_steps_add = op_pt->generator_pos/FIXEDPT;
+		op_pt->cur_env_step += num_steps_add;
+		op_pt->generator_pos -= num_steps_add*FIXEDPT;
+
+		op_pt->generator_pos += (Bit32u)(n-1)*generator_add;
+		num_steps_add = op_pt->generator_pos/FIXEDPT;
+		op_pt->cur_env_step += num_steps_add;
+		op_pt->generator_pos -= num_steps_add*FIXEDPT;
+
+		const fltype ampvol = op_pt->step_amp*op_pt->vol;
+		for (i=0;i<n;i++) blk->ampvol[i] = ampvol;
+		blk->num_active = n;
+	} else {
+		blk->num_active = 0;
+		for (i=0;i<n;i++) {
+			op_pt->generator_pos += generator_add;
+			opfuncs[op_pt->op_state](op_pt);
+
+			blk->active[i] = (op_pt->op_state != OF_TYPE_OFF);
+			blk->ampvol[i] = op_pt->step_amp*op_pt->vol;
+			blk->num_active += blk->active[i];
+		}
+	}
+}
+
+// as operator_output for each sample of the block; the modulator is either the
+// operator's own feedback, the output of another operator (times FIXEDPT), or none
+static void operator_block_output(op_type* op_pt, const opblock_type* blk, bool feedback, const Bit32s* modulator, const fltype* trem, Bits n, Bit32s* out) {
+	Bits i;
+	const fltype* wform = &wavtable_fl[op_pt->cur_wform-wavtable];
+	const Bit32u wmask = op_pt->cur_wmask;
+
+	if (blk->num_active == 0) {
+		// cval holds while the operator is off
+		for (i=0;i<n;i++) out[i] = op_pt->cval;
+		return;
+	}
+
+	if (feedback && (op_pt->mfbi == 0)) feedback = false;	// feedback term is zero
+
+	if ((blk->num_active == n) && !feedback) {
+		if (modulator == NULL) {
+			for (i=0;i<n;i++)
+				out[i] = (Bit32s)(blk->ampvol[i]*wform[(Bit32u)(blk->wfpos[i]/FIXEDPT)&wmask]*trem[i]/16.0);
+		} else {
+			for (i=0;i<n;i++)
+				out[i] = (Bit32s)(blk->ampvol[i]*wform[(Bit32u)((blk->wfpos[i]+modulator[i]*FIXEDPT)/FIXEDPT)&wmask]*trem[i]/16.0);
+		}
+		op_pt->lastcval = (n > 1) ? out[n-2] : op_pt->cval;
+		op_pt->cval = out[n-1];
+		return;
+	}
+
+	Bit32s cval = op_pt->cval;
+	Bit32s lastcval = op_pt->lastcval;
+	for (i=0;i<n;i++) {
+		Bit32s mod = 0;
+		if (feedback) mod = (lastcval+cval)*op_pt->mfbi/2;
+		else if (modulator != NULL) mod = modulator[i]*FIXEDPT;
+
+		if ((blk->num_active == n) || blk->active[i]) {
+			lastcval = cval;
+			cval = (Bit32s)(blk->ampvol[i]*wform[(Bit32u)((blk->wfpos[i]+mod)/FIXEDPT)&wmask]*trem[i]/16.0);
+		}
+		out[i] = cval;
+	}
+	op_pt->cval = cval;
+	op_pt->lastcval = lastcval;
+}
+
+// a 2op channel whose output is computed with the others in channel_batch_output
+typedef struct {
+	op_type *op_pt1, *op_pt2;
+	const opblock_type *blk1, *blk2;
+	const fltype *trem1, *trem2;
+	bool fm;
+	Bit32s* out;
+} chanbatch_type;
+
+static chanbatch_type chanbatch[NUM_CHANNELS];
+static Bits chanbatch_count;
+
+// block state and output of each channel
+static opblock_type chanblock[NUM_CHANNELS][2];
+static Bit32s chanbuf[NUM_CHANNELS][BLOCKBUF_SIZE];
+static Bit32s opbuf[BLOCKBUF_SIZE];
+
+// output of a 2op channel for a block, as the per-sample path computes chanval:
+// op_pt1 (with feedback) either frequency modulates op_pt2 or is added to it.
+// Channels with feedback that sound throughout the block are only queued for
+// channel_batch_output, and false is returned.
+static bool channel_block_output(op_type* op_pt1, const opblock_type* blk1, const fltype* trem1,
+		op_type* op_pt2, const opblock_type* blk2, const fltype* trem2, bool fm, Bits n, Bit32s* out, Bit32s* scratch) {
+	Bits i;
+
+	if ((blk1->num_active == n) && (blk2->num_active == n) && (op_pt1->mfbi != 0)) {
+		chanbatch_type* ch = &chanbatch[chanbatch_count++];
+		ch->op_pt1 = op_pt1;
+		ch->op_pt2 = op_pt2;
+		ch->blk1 = blk1;
+		ch->blk2 = blk2;
+		ch->trem1 = trem1;
+		ch->trem2 = trem2;
+		ch->fm = fm;
+		ch->out = out;
+		return false;
+	}
+
+	// one pass per operator; without feedback nothing needs to run serially
+	operator_block_output(op_pt1,blk1,true,NULL,trem1,n,scratch);
+	operator_block_output(op_pt2,blk2,false,fm ? scratch : NULL,trem2,n,out);
+	if (!fm) {
+		for (i=0;i<n;i++) out[i] += scratch[i];
+	}
+	return true;
+}
+
+// output of the queued channels; the feedback chain of a channel is serial from
+// sample to sample, so running the channels side by side lets them overlap
+static void channel_batch_output(Bits n) {
+	Bits i, c;
+
+	Bit32s cval1[NUM_CHANNELS], lastcval1[NUM_CHANNELS], cval2[NUM_CHANNELS], lastcval2[NUM_CHANNELS];
+	const fltype* wform1[NUM_CHANNELS];
+	const fltype* wform2[NUM_CHANNELS];
+	Bit32u wmask1[NUM_CHANNELS], wmask2[NUM_CHANNELS];
+
+	for (c=0;c<chanbatch_count;c++) {
+		const chanbatch_type* ch = &chanbatch[c];
+		cval1[c] = ch->op_pt1->cval;
+		lastcval1[c] = ch->op_pt1->lastcval;
+		cval2[c] = ch->op_pt2->cval;
+		lastcval2[c] = ch->op_pt2->lastcval;
+		wform1[c] = &wavtable_fl[ch->op_pt1->cur_wform-wavtable];
+		wform2[c] = &wavtable_fl[ch->op_pt2->cur_wform-wavtable];
+		wmask1[c] = ch->op_pt1->cur_wmask;
+		wmask2[c] = ch->op_pt2->cur_wmask;
+	}
+
+	for (i=0;i<n;i++) {
+		for (c=0;c<chanbatch_count;c++) {
+			const chanbatch_type* ch = &chanbatch[c];
+
+			const Bit32s mod = (lastcval1[c]+cval1[c])*ch->op_pt1->mfbi/2;
+			lastcval1[c] = cval1[c];
+			cval1[c] = (Bit32s)(ch->blk1->ampvol[i]*wform1[c][(Bit32u)((ch->blk1->wfpos[i]+mod)/FIXEDPT)&wmask1[c]]*ch->trem1[i]/16.0);
+
+			lastcval2[c] = cval2[c];
+			if (ch->fm) {
+				cval2[c] = (Bit32s)(ch->blk2->ampvol[i]*wform2[c][(Bit32u)((ch->blk2->wfpos[i]+cval1[c]*FIXEDPT)/FIXEDPT)&wmask2[c]]*ch->trem2[i]/16.0);
+				ch->out[i] = cval2[c];
+			} else {
+				cval2[c] = (Bit32s)(ch->blk2->ampvol[i]*wform2[c][(Bit32u)(ch->blk2->wfpos[i]/FIXEDPT)&wmask2[c]]*ch->trem2[i]/16.0);
+				ch->out[i] = cval2[c] + cval1[c];
+			}
+		}
+	}
+
+	for (c=0;c<chanbatch_count;c++) {
+		const chanbatch_type* ch = &chanbatch[c];
+		ch->op_pt1->cval = cval1[c];
+		ch->op_pt1->lastcval = lastcval1[c];
+		ch->op_pt2->cval = cval2[c];
+		ch->op_pt2->lastcval = lastcval2[c];
+	}
+}
+
 // be careful with this
 // uses cptr and chanval, outputs into outbufl(/outbufr)
 // for opl3 check if opl3-mode is enabled (which uses stereo panning)
@@ -1118,6 +1326,8 @@ void adlib_getsample(Bit16s* sndptr, Bits numsamples) {
 	// vibrato/tremolo lookup tables (global, to possibly be used by all operators)
 	Bit32s vib_lut[BLOCKBUF_SIZE];
 	Bit32s trem_lut[BLOCKBUF_SIZE];
+	fltype trem_lut_fl[BLOCKBUF_SIZE];
+
 
 	Bits samples_to_process = numsamples;
 
@@ -1133,6 +1343,7 @@ void adlib_getsample(Bit16s* sndptr, Bits numsamples) {
 
 		// tremolo value table pointers
 		Bit32s *tremval1, *tremval2, *tremval3, *tremval4;
+		fltype *tremval_fl1, *tremval_fl2;
 
 		// calculate vibrato/tremolo lookup tables
 		Bit32s vib_tshift = ((adlibreg[ARC_PERC_MODE]&0x40)==0) ? 1 : 0;	// 14cents/7cents switching
@@ -1148,6 +1359,7 @@ void adlib_getsample(Bit16s* sndptr, Bits numsamples) {
 			if (adlibreg[ARC_PERC_MODE]&0x80) trem_lut[i] = trem_table[tremtab_pos/FIXEDPT_LFO];
 			else trem_lut[i] = trem_table[TREMTAB_SIZE+tremtab_pos/FIXEDPT_LFO];
 		}
+		for (i=0;i<endsamples;i++) trem_lut_fl[i] = trem_lut[i];
 
 		if (adlibreg[ARC_PERC_MODE]&0x20) {
 			//BassDrum
@@ -1278,6 +1490,8 @@ void adlib_getsample(Bit16s* sndptr, Bits numsamples) {
 			}
 		}
 
+		chanbatch_count = 0;
+
 		Bitu max_channel = NUM_CHANNELS;
 #if defined(OPLTYPE_IS_OPL3)
 		if ((adlibreg[0x105]&1)==0) max_channel = NUM_CHANNELS/2;
@@ -1435,25 +1649,19 @@ void adlib_getsample(Bit16s* sndptr, Bits numsamples) {
 					for (i=0;i<endsamples;i++)
 						vibval2[i] = (Bit32s)((vib_lut[i]*cptr[9].freq_high/8)*FIXEDPT*VIBFAC);
 				} else vibval2 = vibval_const;
-				if (cptr[0].tremolo) tremval1 = trem_lut;	// tremolo enabled, use table
-				else tremval1 = tremval_const;
-				if (cptr[9].tremolo) tremval2 = trem_lut;	// tremolo enabled, use table
-				else tremval2 = tremval_const;
+				if (cptr[0].tremolo) tremval_fl1 = trem_lut_fl;	// tremolo enabled, use table
+				else tremval_fl1 = tremval_const_fl;
+				if (cptr[9].tremolo) tremval_fl2 = trem_lut_fl;	// tremolo enabled, use table
+				else tremval_fl2 = tremval_const_fl;
 
 				// calculate channel output
-				for (i=0;i<endsamples;i++) {
-					// carrier1
-					operator_advance(&cptr[0],vibval1[i]);
-					opfuncs[cptr[0].op_state](&cptr[0]);
-					operator_output(&cptr[0],(cptr[0].lastcval+cptr[0].cval)*cptr[0].mfbi/2,tremval1[i]);
-
-					// carrier2
-					operator_advance(&cptr[9],vibval2[i]);
-					opfuncs[cptr[9].op_state](&cptr[9]);
-					operator_output(&cptr[9],0,tremval2[i]);
-
-					Bit32s chanval = cptr[9].cval + cptr[0].cval;
-					CHANVAL_OUT
+				operator_block_advance(&cptr[0],vibval1,endsamples,&chanblock[cur_ch][0]);
+				operator_block_advance(&cptr[9],vibval2,endsamples,&chanblock[cur_ch][1]);
+				if (channel_block_output(&cptr[0],&chanblock[cur_ch][0],tremval_fl1,&cptr[9],&chanblock[cur_ch][1],tremval_fl2,false,endsamples,chanbuf[cur_ch],opbuf)) {
+					for (i=0;i<endsamples;i++) {
+						Bit32s chanval = chanbuf[cur_ch][i];
+						CHANVAL_OUT
+					}
 				}
 			} else {
 #if defined(OPLTYPE_IS_OPL3)
@@ -1573,29 +1781,33 @@ void adlib_getsample(Bit16s* sndptr, Bits numsamples) {
 					for (i=0;i<endsamples;i++)
 						vibval2[i] = (Bit32s)((vib_lut[i]*cptr[9].freq_high/8)*FIXEDPT*VIBFAC);
 				} else vibval2 = vibval_const;
-				if (cptr[0].tremolo) tremval1 = trem_lut;	// tremolo enabled, use table
-				else tremval1 = tremval_const;
-				if (cptr[9].tremolo) tremval2 = trem_lut;	// tremolo enabled, use table
-				else tremval2 = tremval_const;
+				if (cptr[0].tremolo) tremval_fl1 = trem_lut_fl;	// tremolo enabled, use table
+				else tremval_fl1 = tremval_const_fl;
+				if (cptr[9].tremolo) tremval_fl2 = trem_lut_fl;	// tremolo enabled, use table
+				else tremval_fl2 = tremval_const_fl;
 
 				// calculate channel output
-				for (i=0;i<endsamples;i++) {
-					// modulator
-					operator_advance(&cptr[0],vibval1[i]);
-					opfuncs[cptr[0].op_state](&cptr[0]);
-					operator_output(&cptr[0],(cptr[0].lastcval+cptr[0].cval)*cptr[0].mfbi/2,tremval1[i]);
-
-					// carrier
-					operator_advance(&cptr[9],vibval2[i]);
-					opfuncs[cptr[9].op_state](&cptr[9]);
-					operator_output(&cptr[9],cptr[0].cval*FIXEDPT,tremval2[i]);
-
-					Bit32s chanval = cptr[9].cval;
-					CHANVAL_OUT
+				operator_block_advance(&cptr[0],vibval1,endsamples,&chanblock[cur_ch][0]);
+				operator_block_advance(&cptr[9],vibval2,endsamples,&chanblock[cur_ch][1]);
+				if (channel_block_output(&cptr[0],&chanblock[cur_ch][0],tremval_fl1,&cptr[9],&chanblock[cur_ch][1],tremval_fl2,true,endsamples,chanbuf[cur_ch],opbuf)) {
+					for (i=0;i<endsamples;i++) {
+						Bit32s chanval = chanbuf[cur_ch][i];
+						CHANVAL_OUT
+					}
 				}
 			}
 		}
 
+		// channels queued by channel_block_output
+		channel_batch_output(endsamples);
+		for (Bits c=0; c<chanbatch_count; c++) {
+			cptr = chanbatch[c].op_pt1;
+			for (i=0;i<endsamples;i++) {
+				Bit32s chanval = chanbatch[c].out[i];
+				CHANVAL_OUT
+			}
+		}
+
 #if defined(OPLTYPE_IS_OPL3)
 		if (adlibreg[0x105]&1) {
 			// convert to 16bit samples (stereo)
@@ -21,6 +21,7 @@
 #include "file.h"
 #include "nortsong.h"
 #include "opentyr.h"
+#include "startup_report.h"
 #include "video.h"
 
 #include <assert.h>
@@ -39,6 +40,8 @@ Palette colors;
 
 void JE_loadPals(void)
 {
+	const Uint64 report_start = startup_report_clock();
+
 	FILE *f = dir_fopen_die(data_dir(), "palette.dat", "rb");
 	
 	palette_count = ftell_eof(f) / (256 * 3);
@@ -62,6 +65,7 @@ void JE_loadPals(void)
 		}
 	}
 	
+	startup_report_file("palette.dat", ftell(f), report_start);
 	fclose(f);
 }
 
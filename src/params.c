@@ -20,12 +20,16 @@
 
 #include "arg_parse.h"
 #include "debug_console.h"
+#include "demo_bench.h"
 #include "file.h"
 #include "joystick.h"
 #include "loudness.h"
+#include "netsim.h"
 #include "network.h"
 #include "opentyr.h"
 #include "remote_control.h"
+#include "sprite.h"
+#include "startup_report.h"
 #include "varz.h"
 #include "xmas.h"
 
@@ -41,6 +45,12 @@ JE_boolean startInJukebox = false;
 JE_boolean startMenuEnter = false;
 char startMenuOption[64] = "";
 
+// --render-song; 0 when not rendering
+unsigned int renderSong = 0;
+unsigned int renderSongSeconds = 60;
+const char *renderSongPath = NULL;
+const char *renderSongComparePath = NULL;
+
 /* YKS: Note: LOOT cheat had non letters removed. */
 const char pars[][9] = {
 	"LOOT", "RECORD", "NOJOY", "CONSTANT", "DEATH", "NOSOUND", "NOXMAS", "YESXMAS"
@@ -78,6 +88,20 @@ void JE_paramCheck(int argc, char *argv[])
 			{ 263, 0,   "start-menu-option", true },
 			{ 264, 0,   "start-menu-enter", false },
 			{ 265, 0,   "start-jukebox", false },
+			{ 266, 0,   "sheet-cache",   true },
+			{ 267, 0,   "startup-report", false },
+			{ 268, 0,   "prerender-music", false },
+			{ 269, 0,   "render-song",   true },
+			{ 270, 0,   "seconds",       true },
+			{ 271, 0,   "out",           true },
+			{ 272, 0,   "compare",       true },
+			{ 273, 0,   "audio-rate",    true },
+			{ 274, 0,   "net-sim",       true },
+			{ 275, 0,   "net-soak",      true },
+			{ 276, 0,   "net-spectate",  true },
+			{ 277, 0,   "net-spectators", true },
+			{ 278, 0,   "bench-demos",   true },
+			{ 279, 0,   "bench-crowd",   true },
 
 		{ 0, 0, NULL, false}
 	};
@@ -121,7 +145,32 @@ void JE_paramCheck(int argc, char *argv[])
 				       "  --start-graphics-menu        Start directly in Setup > Graphics\n"
 				       "  --start-jukebox              Start directly in Jukebox\n"
 				       "  --start-menu-option=NAME     Preselect menu item (e.g. scaler)\n"
-				       "  --start-menu-enter           Activate selected startup menu item\n", argv[0]);
+				       "  --start-menu-enter           Activate selected startup menu item\n"
+				       "  --sheet-cache=KIB            Memory budget for cached enemy sprite sheets\n"
+				       "                               (default is 1024)\n"
+				       "  --startup-report             Print startup and episode load timings\n"
+				       "  --prerender-music            Render each song to memory once instead of\n"
+				       "                               emulating the OPL chip during playback\n"
+				       "  --render-song=NUMBER|all     Render a song without audio output, report the\n"
+				       "                               synthesis speed and exit\n"
+				       "  --seconds=SECONDS            Length to render (default is 60)\n"
+				       "  --out=FILE                   Write the rendered song to a WAV file\n"
+				       "                               (a directory when rendering all songs)\n"
+				       "  --compare=FILE               Compare the rendered song with an earlier render\n"
+				       "                               (a directory when rendering all songs)\n"
+				       "  --audio-rate=HZ              Audio output rate (default is 48000)\n"
+				       "  --net-sim=SPEC               Simulate a bad link on outgoing packets, e.g.\n"
+				       "                               delay=60,jitter=20,loss=2,reorder=1,seed=7\n"
+				       "                               (milliseconds and percentages)\n"
+				       "  --net-soak=TICKS             Play a networked game with scripted input,\n"
+				       "                               print link statistics after TICKS and exit\n"
+				       "  --net-spectate=HOST[:PORT]   Watch the networked game player 1 is hosting\n"
+				       "  --net-spectators=COUNT       As player 1, let up to COUNT spectators watch\n"
+				       "                               (at most 8)\n"
+				       "  --bench-demos=PASSES         Replay the shipped demos PASSES times at full\n"
+				       "                               speed, report enemy pass timings and exit\n"
+				       "  --bench-crowd=COPIES         In the demo benchmark, spawn COPIES of every\n"
+				       "                               enemy (default is 1, at most 8)\n", argv[0]);
 			exit(0);
 			break;
 			
@@ -145,6 +194,10 @@ void JE_paramCheck(int argc, char *argv[])
 			custom_data_dir = option.arg;
 			break;
 			
+		case 276: // --net-spectate
+			network_spectating = true;
+			// fall through
+
 		case 'n':
 			isNetworkGame = true;
 			
@@ -276,12 +329,147 @@ void JE_paramCheck(int argc, char *argv[])
 				startInJukebox = true;
 				break;
 
+			case 266: // --sheet-cache
+			{
+				int temp;
+				if (sscanf(option.arg, "%d", &temp) == 1 && temp >= 0)
+					enemySheetCacheBudget = (size_t)temp * 1024;
+				else
+				{
+					fprintf(stderr, "%s: error: invalid sheet cache size\n", argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			}
+
+			case 267: // --startup-report
+				startup_report_enabled = true;
+				break;
+
+			case 268: // --prerender-music
+				music_prerender = true;
+				break;
+
+			case 269: // --render-song
+			{
+				int temp;
+				if (strcmp(option.arg, "all") == 0)
+					renderSong = RENDER_ALL_SONGS;
+				else if (sscanf(option.arg, "%d", &temp) == 1 && temp >= 1)
+					renderSong = temp;
+				else
+				{
+					fprintf(stderr, "%s: error: invalid song number\n", argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			}
+
+			case 270: // --seconds
+			{
+				int temp;
+				if (sscanf(option.arg, "%d", &temp) == 1 && temp >= 1 && temp <= 3600)
+					renderSongSeconds = temp;
+				else
+				{
+					fprintf(stderr, "%s: error: invalid number of seconds (1 to 3600)\n", argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			}
+
+			case 271: // --out
+				renderSongPath = option.arg;
+				break;
+
+			case 272: // --compare
+				renderSongComparePath = option.arg;
+				break;
+
+			case 273: // --audio-rate
+			{
+				int temp;
+				if (sscanf(option.arg, "%d", &temp) == 1 && temp >= 8000 && temp <= 192000)
+					audio_output_rate = temp;
+				else
+				{
+					fprintf(stderr, "%s: error: invalid audio rate (8000 to 192000)\n", argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			}
+
+			case 274: // --net-sim
+#ifdef WITH_NETWORK
+				if (!netsim_configure(option.arg))
+				{
+					fprintf(stderr, "%s: error: invalid link simulation '%s'\n", argv[0], option.arg);
+					exit(EXIT_FAILURE);
+				}
+#endif
+				break;
+
+			case 275: // --net-soak
+			{
+				int temp;
+				if (sscanf(option.arg, "%d", &temp) == 1 && temp > 0)
+					net_soak_frames = temp;
+				else
+				{
+					fprintf(stderr, "%s: error: invalid soak length\n", argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			}
+
+			case 277: // --net-spectators
+			{
+				int temp;
+				if (sscanf(option.arg, "%d", &temp) == 1 && temp >= 0 && temp <= 8)
+					network_spectators_max = temp;
+				else
+				{
+					fprintf(stderr, "%s: error: invalid number of spectators (0 to 8)\n", argv[0]);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			}
+
+			case 278: // --bench-demos
+			{
+				int temp;
+				if (sscanf(option.arg, "%d", &temp) == 1 && temp >= 1 && temp <= DEMO_BENCH_PASSES_MAX)
+					demo_bench_passes = temp;
+				else
+				{
+					fprintf(stderr, "%s: error: invalid number of passes (1 to %d)\n", argv[0], DEMO_BENCH_PASSES_MAX);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			}
+
+			case 279: // --bench-crowd
+			{
+				int temp;
+				if (sscanf(option.arg, "%d", &temp) == 1 && temp >= 1 && temp <= DEMO_BENCH_CROWD_MAX)
+					demo_bench_crowd = temp;
+				else
+				{
+					fprintf(stderr, "%s: error: invalid enemy crowd (1 to %d)\n", argv[0], DEMO_BENCH_CROWD_MAX);
+					exit(EXIT_FAILURE);
+				}
+				break;
+			}
+
 		default:
 			assert(false);
 			break;
 		}
 	}
 	
+	if (demo_bench_crowd > 1 && demo_bench_passes == 0)
+		fprintf(stderr, "%s: warning: --bench-crowd only applies with --bench-demos\n", argv[0]);
+
 	// legacy parameter support
 	for (int i = option.argn; i < argc; ++i)
 	{
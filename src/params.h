@@ -21,11 +21,16 @@
 
 #include "opentyr.h"
 
+#include <limits.h>
+
 extern JE_boolean richMode, constantPlay, constantDie;
 extern JE_boolean startInSetupMenu, startInGraphicsMenu;
 extern JE_boolean startInJukebox;
 extern JE_boolean startMenuEnter;
 extern char startMenuOption[64];
+#define RENDER_ALL_SONGS UINT_MAX
+extern unsigned int renderSong, renderSongSeconds;
+extern const char *renderSongPath, *renderSongComparePath;
 
 void JE_paramCheck(int argc, char *argv[]);
 
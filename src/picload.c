@@ -22,64 +22,136 @@
 #include "opentyr.h"
 #include "palette.h"
 #include "pcxmast.h"
+#include "varz.h"
 #include "video.h"
 
-#include <string.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-void JE_loadPic(SDL_Surface *screen, JE_byte PCXnumber, JE_boolean storepal)
+#define PIC_CACHE_SLOTS 6
+
+// Recently shown pictures, decoded, so re-entering a menu is just a copy.
+static struct
 {
-	PCXnumber--;
+	int number;  // -1 if slot is unused
+	Uint8 palette;
+	Uint32 last_used;
+	int covered;  // pixels the picture's data reaches; the rest of the screen is left alone
+	Uint8 pixels[320 * 200];
+} *pic_cache = NULL;
+static Uint32 pic_cache_clock = 0;
 
-	FILE *f = dir_fopen_die(data_dir(), "tyrian.pic", "rb");
+/* Decodes into `pixels` and returns how many (from the top left) the data covered, or -1. */
+static int pic_decode(const FileView *view, unsigned int PCXnumber, Uint8 *pixels)
+{
+	if (pcxpos[PCXnumber] < 0 || pcxpos[PCXnumber + 1] < pcxpos[PCXnumber] || (size_t)pcxpos[PCXnumber + 1] > view->size)
+		return -1;
 
-	static bool first = true;
-	if (first)
-	{
-		first = false;
+	// decode straight out of the mapped file
+	const Uint8 *p = view->data + pcxpos[PCXnumber];
+	const Uint8 * const p_end = view->data + pcxpos[PCXnumber + 1];
 
-		Uint16 temp;
-		fread_u16_die(&temp, 1, f);
+	int i = 0;
+	while (i < 320 * 200 && p < p_end)
+	{
+		if ((*p & 0xc0) == 0xc0)
+		{
+			if (p + 1 == p_end)
+				break;
 
-		fread_s32_die(pcxpos, PCX_NUM, f);
-		pcxpos[PCX_NUM] = ftell_eof(f);
+			const int count = MIN(*p & 0x3f, 320 * 200 - i);
+			memset(pixels + i, *(p + 1), count);
+			i += count; p += 2;
+		}
+		else
+		{
+			pixels[i++] = *p++;
+		}
 	}
 
-	unsigned int size = pcxpos[PCXnumber + 1] - pcxpos[PCXnumber];
-	Uint8 *buffer = malloc(size);
+	return i;
+}
+
+static const Uint8 *pic_cache_get(unsigned int PCXnumber, Uint8 *out_palette, int *out_covered)
+{
+	const FileView view = dir_map_die(data_dir(), "tyrian.pic");
 
-	fseek(f, pcxpos[PCXnumber], SEEK_SET);
-	fread_u8_die(buffer, size, f);
-	fclose(f);
+	if (pic_cache == NULL)
+	{
+		if (view.size < 2 + PCX_NUM * 4)
+			return NULL;
 
-	Uint8 *p = buffer;
-	Uint8 *s; /* screen pointer, 8-bit specific */
+		for (unsigned int i = 0; i < PCX_NUM; ++i)
+			pcxpos[i] = (Sint32)view_read_u32(view.data + 2 + i * 4);
+		pcxpos[PCX_NUM] = view.size;
 
-	s = (Uint8 *)screen->pixels;
+		pic_cache = malloc(PIC_CACHE_SLOTS * sizeof(*pic_cache));
+		if (pic_cache == NULL)
+			return NULL;
+		for (unsigned int i = 0; i < PIC_CACHE_SLOTS; ++i)
+			pic_cache[i].number = -1;
+	}
 
-	for (int i = 0; i < 320 * 200; )
+	unsigned int slot = 0;
+	for (unsigned int i = 0; i < PIC_CACHE_SLOTS; ++i)
 	{
-		if ((*p & 0xc0) == 0xc0)
+		if (pic_cache[i].number == (int)PCXnumber)
 		{
-			i += (*p & 0x3f);
-			memset(s, *(p + 1), (*p & 0x3f));
-			s += (*p & 0x3f); p += 2;
-		}
-		else
-		{
-			i++;
-			*s = *p;
-			s++; p++;
-		}
-		if (i && (i % 320 == 0))
-		{
-			s += screen->pitch - 320;
+			pic_cache[i].last_used = ++pic_cache_clock;
+			*out_palette = pic_cache[i].palette;
+			*out_covered = pic_cache[i].covered;
+			return pic_cache[i].pixels;
 		}
+
+		// prefer an unused slot, else the least recently used
+		if (pic_cache[slot].number >= 0 &&
+		    (pic_cache[i].number < 0 || (Sint32)(pic_cache[i].last_used - pic_cache[slot].last_used) < 0))
+			slot = i;
+	}
+
+	pic_cache[slot].number = -1;
+	const int covered = pic_decode(&view, PCXnumber, pic_cache[slot].pixels);
+	if (covered < 0)
+		return NULL;
+
+	pic_cache[slot].number = PCXnumber;
+	pic_cache[slot].palette = pcxpal[PCXnumber];
+	pic_cache[slot].last_used = ++pic_cache_clock;
+	pic_cache[slot].covered = covered;
+	*out_palette = pic_cache[slot].palette;
+	*out_covered = covered;
+	return pic_cache[slot].pixels;
+}
+
+void JE_loadPic(SDL_Surface *screen, JE_byte PCXnumber, JE_boolean storepal)
+{
+	PCXnumber--;
+
+	Uint8 palette;
+	int covered;
+	const Uint8 *pixels = pic_cache_get(PCXnumber, &palette, &covered);
+	if (pixels == NULL)
+	{
+		fprintf(stderr, "error: Unexpected data was read from a file.\n");
+		JE_tyrianHalt(1);
+		return;
 	}
 
-	free(buffer);
+	Uint8 *s = (Uint8 *)screen->pixels; /* screen pointer, 8-bit specific */
+
+	// like the original decoder, a short picture leaves the rest of the screen as it was
+	if (screen->pitch == 320)
+	{
+		memcpy(s, pixels, covered);
+	}
+	else
+	{
+		for (int y = 0; y * 320 < covered; ++y)
+			memcpy(s + y * screen->pitch, pixels + y * 320, MIN(320, covered - y * 320));
+	}
 
-	memcpy(colors, palettes[pcxpal[PCXnumber]], sizeof(colors));
+	memcpy(colors, palettes[palette], sizeof(colors));
 
 	if (storepal)
 		set_palette(colors, 0, 255);
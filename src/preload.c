@@ -0,0 +1,264 @@
+/*
+ * Tyrian 3000: Startup Asset Preloader
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#include "preload.h"
+
+#include "file.h"
+#include "helptext.h"
+#include "loudness.h"
+#include "nortsong.h"
+#include "palette.h"
+#include "sprite.h"
+#include "varz.h"
+
+#include "SDL.h"
+
+#include <setjmp.h>
+#include <stdio.h>
+
+#define PRELOAD_WORKERS 2
+
+typedef enum
+{
+	JOB_IDLE = 0,
+	JOB_QUEUED,
+	JOB_RUNNING,
+	JOB_DONE
+} JobState;
+
+static struct
+{
+	JobState state;
+	bool xmas;
+	bool failed;
+
+	// while JOB_RUNNING: the thread running the job and where preload_halting() returns it to
+	SDL_threadID runner;
+	jmp_buf *unwind;
+} jobs[PRELOAD_JOB_COUNT];
+
+static SDL_Thread *workers[PRELOAD_WORKERS];
+static SDL_mutex *jobs_mutex = NULL;
+static SDL_cond *jobs_cond = NULL;  // signalled on both queue and completion
+static bool workers_quit = false;
+
+static void run_job(PreloadJob job, bool xmas)
+{
+	switch (job)
+	{
+	case PRELOAD_HELP_TEXT:
+		JE_loadHelpText();
+		break;
+	case PRELOAD_PALETTES:
+		JE_loadPals();
+		break;
+	case PRELOAD_MAIN_SHAPES:
+		JE_loadMainShapeTables(xmas ? "tyrianc.shp" : "tyrian.shp");
+		break;
+	case PRELOAD_MUSIC:
+		load_music();
+		break;
+	case PRELOAD_SOUNDS:
+		loadSndFile(xmas);
+		break;
+	case PRELOAD_JOB_COUNT:
+		break;
+	}
+}
+
+/* Called with the lock held; returns with it held. */
+static void run_locked(PreloadJob job)
+{
+	jmp_buf unwind;
+	volatile bool ok = false;
+
+	jobs[job].state = JOB_RUNNING;
+	jobs[job].runner = SDL_ThreadID();
+	jobs[job].unwind = &unwind;
+	const bool xmas = jobs[job].xmas;
+	SDL_UnlockMutex(jobs_mutex);
+
+	// the loaders halt on missing or bad data; preload_halting() jumps back here instead
+	if (setjmp(unwind) == 0)
+	{
+		run_job(job, xmas);
+		ok = true;
+	}
+
+	SDL_LockMutex(jobs_mutex);
+	jobs[job].failed = !ok;
+	jobs[job].unwind = NULL;
+	jobs[job].state = JOB_DONE;
+	SDL_CondBroadcast(jobs_cond);
+}
+
+static int SDLCALL worker_main(void *data)
+{
+	(void)data;
+
+	SDL_LockMutex(jobs_mutex);
+	for (; ; )
+	{
+		int job = -1;
+		for (int i = 0; i < PRELOAD_JOB_COUNT; ++i)
+		{
+			if (jobs[i].state == JOB_QUEUED)
+			{
+				job = i;
+				break;
+			}
+		}
+
+		if (job >= 0)
+			run_locked(job);
+		else if (workers_quit)
+			break;
+		else
+			SDL_CondWait(jobs_cond, jobs_mutex);
+	}
+	SDL_UnlockMutex(jobs_mutex);
+
+	return 0;
+}
+
+void preload_init(void)
+{
+	if (jobs_mutex != NULL)
+		return;
+
+	(void)data_dir();  // resolve the data directory before workers race to
+
+	jobs_mutex = SDL_CreateMutex();
+	jobs_cond = SDL_CreateCond();
+	if (jobs_mutex == NULL || jobs_cond == NULL)
+	{
+		fprintf(stderr, "warning: assets will be loaded synchronously: %s\n", SDL_GetError());
+		preload_shutdown();
+		return;
+	}
+
+	workers_quit = false;
+	for (int i = 0; i < PRELOAD_WORKERS; ++i)
+	{
+		workers[i] = SDL_CreateThread(worker_main, "preload", NULL);
+		if (workers[i] == NULL)
+			fprintf(stderr, "warning: failed to create preload worker: %s\n", SDL_GetError());
+	}
+}
+
+void preload_start(PreloadJob job, bool xmas)
+{
+	if (jobs_mutex == NULL)
+	{
+		run_job(job, xmas);
+		jobs[job].state = JOB_DONE;
+		return;
+	}
+
+	SDL_LockMutex(jobs_mutex);
+	jobs[job].xmas = xmas;
+	jobs[job].state = JOB_QUEUED;
+	SDL_CondBroadcast(jobs_cond);
+	SDL_UnlockMutex(jobs_mutex);
+}
+
+/* Returns true if the job failed. */
+static bool join_job(PreloadJob job)
+{
+	if (jobs_mutex == NULL)
+		return jobs[job].failed;
+
+	SDL_LockMutex(jobs_mutex);
+	if (jobs[job].state == JOB_QUEUED)
+		run_locked(job);  // no worker has it yet (or there are none); don't sit idle
+	while (jobs[job].state == JOB_RUNNING)
+		SDL_CondWait(jobs_cond, jobs_mutex);
+	const bool failed = jobs[job].failed;
+	SDL_UnlockMutex(jobs_mutex);
+
+	return failed;
+}
+
+/* Returns true if any job failed. */
+static bool join_pool(void)
+{
+	bool failed = false;
+	for (int i = 0; i < PRELOAD_JOB_COUNT; ++i)
+		failed |= join_job(i);
+
+	if (jobs_mutex != NULL)
+	{
+		SDL_LockMutex(jobs_mutex);
+		workers_quit = true;
+		SDL_CondBroadcast(jobs_cond);
+		SDL_UnlockMutex(jobs_mutex);
+	}
+
+	for (int i = 0; i < PRELOAD_WORKERS; ++i)
+	{
+		if (workers[i] != NULL)
+		{
+			SDL_WaitThread(workers[i], NULL);
+			workers[i] = NULL;
+		}
+	}
+
+	if (jobs_cond != NULL)
+	{
+		SDL_DestroyCond(jobs_cond);
+		jobs_cond = NULL;
+	}
+	if (jobs_mutex != NULL)
+	{
+		SDL_DestroyMutex(jobs_mutex);
+		jobs_mutex = NULL;
+	}
+
+	return failed;
+}
+
+void preload_wait(PreloadJob job)
+{
+	if (join_job(job))
+		JE_tyrianHalt(1);
+}
+
+void preload_shutdown(void)
+{
+	if (join_pool())
+		JE_tyrianHalt(1);
+}
+
+void preload_halting(void)
+{
+	if (jobs_mutex == NULL)
+		return;
+
+	jmp_buf *unwind = NULL;
+
+	SDL_LockMutex(jobs_mutex);
+	for (int i = 0; i < PRELOAD_JOB_COUNT; ++i)
+	{
+		if (jobs[i].state == JOB_RUNNING && jobs[i].unwind != NULL && jobs[i].runner == SDL_ThreadID())
+			unwind = jobs[i].unwind;
+		else if (jobs[i].state == JOB_QUEUED)
+		{
+			// not worth loading any more, but whoever waits on it must not take it as loaded
+			jobs[i].failed = true;
+			jobs[i].state = JOB_DONE;
+		}
+	}
+	SDL_CondBroadcast(jobs_cond);
+	SDL_UnlockMutex(jobs_mutex);
+
+	if (unwind != NULL)
+		longjmp(*unwind, 1);
+
+	join_pool();
+}
@@ -0,0 +1,47 @@
+/*
+ * Tyrian 3000: Startup Asset Preloader
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#ifndef PRELOAD_H
+#define PRELOAD_H
+
+#include "opentyr.h"
+
+#include <stdbool.h>
+
+typedef enum
+{
+	PRELOAD_HELP_TEXT,
+	PRELOAD_PALETTES,
+	PRELOAD_MAIN_SHAPES,
+	PRELOAD_MUSIC,
+	PRELOAD_SOUNDS,
+
+	PRELOAD_JOB_COUNT
+} PreloadJob;
+
+/* Starts the worker pool.  Without threads, jobs run synchronously when started. */
+void preload_init(void);
+
+/* Queues an independent load.  `xmas` selects the Christmas shape and voice files. */
+void preload_start(PreloadJob job, bool xmas);
+
+/* Join barrier: returns once the job has finished.  A job that no worker has picked up
+   yet is run on the calling thread instead.  Jobs never started return immediately.
+   Halts the game if the job failed. */
+void preload_wait(PreloadJob job);
+
+/* Waits for every started job and stops the workers.  Halts the game if any job failed. */
+void preload_shutdown(void);
+
+/* Called first on every halt path.  Inside a preload job, abandons the job (the thread
+   that joins it reports the failure and halts); anywhere else, joins the pool so no
+   worker is still loading into data that is about to be torn down. */
+void preload_halting(void);
+
+#endif /* PRELOAD_H */
@@ -9,12 +9,22 @@
  */
 #include "remote_control.h"
 
+#include "config.h"
 #include "debug_console.h"
+#include "episodes.h"
+#include "loudness.h"
+#include "mainint.h"
+#include "network.h"
+#include "player.h"
+#include "screenshot.h"
+#include "tyrian2.h"
+#include "varz.h"
 #include "video.h"
 #include "video_scale.h"
 
 #if !defined(TARGET_WIN32) && !defined(__EMSCRIPTEN__)
 
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
@@ -29,37 +39,128 @@
 
 #define REMOTE_DEFAULT_SOCKET_PATH "/tmp/tyrian3000-remote.sock"
 #define REMOTE_RX_BUF_SIZE 4096
+#define REMOTE_TX_BUF_MAX (256 * 1024)
 #define REMOTE_CONTEXT_SIZE 64
+#define REMOTE_SESSION_SIZE 32
+#define REMOTE_MAX_CLIENTS 8
+#define REMOTE_MAX_SESSIONS 16
+#define REMOTE_COMMANDS_PER_PUMP 4
+#define REMOTE_JSON_MAX_FIELDS 16
+#define REMOTE_JSON_MAX_ITEMS 64
+
+#ifdef MSG_NOSIGNAL
+#define REMOTE_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define REMOTE_SEND_FLAGS 0
+#endif
 
 typedef enum
 {
 	REMOTE_PENDING_NONE = 0,
 	REMOTE_PENDING_WAIT_FRAMES,
-	REMOTE_PENDING_SCREENSHOT
+	REMOTE_PENDING_SCREENSHOT,         // waiting for a presented frame
+	REMOTE_PENDING_SCREENSHOT_ENCODE   // waiting for the encoder thread
 } RemotePendingType;
 
+enum
+{
+	REMOTE_EVENT_UI_CONTEXT = 1 << 0,
+	REMOTE_EVENT_LEVEL      = 1 << 1,
+	REMOTE_EVENT_DEATH      = 1 << 2,
+	REMOTE_EVENT_BOSS_BAR   = 1 << 3,
+	REMOTE_EVENT_CONSOLE    = 1 << 4,
+	REMOTE_EVENT_ALL        = (1 << 5) - 1
+};
+
+static const struct
+{
+	const char *name;
+	Uint32 mask;
+}
+remote_event_names[] =
+{
+	{ "ui_context", REMOTE_EVENT_UI_CONTEXT },
+	{ "level",      REMOTE_EVENT_LEVEL },
+	{ "death",      REMOTE_EVENT_DEATH },
+	{ "boss_bar",   REMOTE_EVENT_BOSS_BAR },
+	{ "console",    REMOTE_EVENT_CONSOLE },
+	{ "all",        REMOTE_EVENT_ALL },
+};
+
+// last reported player totals; replies carry deltas against these
+typedef struct
+{
+	Uint32 game;  // reward_game when taken; an older game (or 0) means no baseline yet
+	ulong score[2];
+	int armor[2];
+	int shield[2];
+} RewardBaseline;
+
+typedef struct
+{
+	int fd;
+	Uint32 serial;  // distinguishes reuses of the same slot
+	Uint32 subscriptions;  // REMOTE_EVENT_* mask
+
+	char rx_buf[REMOTE_RX_BUF_SIZE];
+	size_t rx_len;
+
+	// replies that did not fit in the socket buffer yet
+	char *tx_buf;
+	size_t tx_len;
+	size_t tx_cap;
+
+	bool closing;  // close once tx_buf drains
+
+	struct
+	{
+		RemotePendingType type;
+		int frames_left;
+		bool screenshot_async;
+		Uint32 screenshot_job;
+		char screenshot_path[PATH_MAX];
+		char session[REMOTE_SESSION_SIZE];  // of the pending wait_frames
+	} pending;
+
+	RewardBaseline reward_last;  // for commands without a session
+} RemoteClient;
+
 static bool remote_enabled = false;
 static bool remote_initialized = false;
+static bool screenshot_ready = false;
+
+// Baselines named by a command's "session" field, so that a client reconnecting for
+// every command (as gamectl does) keeps its own deltas and other clients polling
+// the game do not move them.  The least recently used name gives way when all are
+// taken.
+static struct
+{
+	char name[REMOTE_SESSION_SIZE];
+	Uint32 last_used;
+	RewardBaseline baseline;
+} reward_sessions[REMOTE_MAX_SESSIONS];
+static Uint32 reward_session_clock = 0;
+static Uint32 reward_game = 1;  // advanced by remote_control_on_game_start
 
 static int listen_fd = -1;
-static int client_fd = -1;
 
 static char socket_path[sizeof(((struct sockaddr_un *)0)->sun_path)] = REMOTE_DEFAULT_SOCKET_PATH;
 static char ui_context[REMOTE_CONTEXT_SIZE] = "unknown";
 
-static char rx_buf[REMOTE_RX_BUF_SIZE];
-static size_t rx_len = 0;
+static RemoteClient clients[REMOTE_MAX_CLIENTS];
+static uint next_client_turn = 0;
+static Uint32 next_client_serial = 1;
 
 static Uint64 frame_counter = 0;
 static SDL_Surface *last_presented_surface = NULL;
-static Uint32 next_accept_poll_ticks = 0;
 
+/* Game state as of the last frame, for edge-triggered events. */
 static struct
 {
-	RemotePendingType type;
-	int frames_left;
-	char screenshot_path[PATH_MAX];
-} pending = { REMOTE_PENDING_NONE, 0, { 0 } };
+	bool level_active;
+	bool alive[2];
+	uint boss_bars;
+} event_state = { false, { false, false }, 0 };
 
 static int set_nonblocking(const int fd)
 {
@@ -69,58 +170,111 @@ static int set_nonblocking(const int fd)
 	return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
 }
 
-static void close_client(void)
+static void reset_client(RemoteClient *client)
 {
-	if (client_fd >= 0)
-	{
-		close(client_fd);
-		client_fd = -1;
-	}
+	client->fd = -1;
+	client->rx_len = 0;
+	client->tx_len = 0;
+	client->closing = false;
+	client->pending.type = REMOTE_PENDING_NONE;
+	client->pending.frames_left = 0;
+	client->pending.screenshot_async = false;
+	client->pending.screenshot_job = 0;
+	client->pending.screenshot_path[0] = '\0';
+	client->pending.session[0] = '\0';
+	client->reward_last.game = 0;
+	client->subscriptions = 0;
+}
+
+static void close_client(RemoteClient *client)
+{
+	if (client->fd >= 0)
+		close(client->fd);
 
-	rx_len = 0;
-	pending.type = REMOTE_PENDING_NONE;
-	pending.frames_left = 0;
-	pending.screenshot_path[0] = '\0';
+	free(client->tx_buf);
+	client->tx_buf = NULL;
+	client->tx_cap = 0;
+
+	reset_client(client);
 }
 
-static bool write_all(const char *data, size_t len)
+/* Sends as much queued output as the socket accepts without blocking. */
+static void flush_client(RemoteClient *client)
 {
-	while (len > 0)
+	size_t sent = 0;
+	while (sent < client->tx_len)
 	{
-		const ssize_t wrote = send(client_fd, data, len, 0);
+		const ssize_t wrote = send(client->fd, client->tx_buf + sent, client->tx_len - sent, REMOTE_SEND_FLAGS);
 		if (wrote < 0)
 		{
 			if (errno == EINTR)
 				continue;
 			if (errno == EAGAIN || errno == EWOULDBLOCK)
-				return false;
-			close_client();
-			return false;
+				break;
+			close_client(client);
+			return;
 		}
 
-		data += wrote;
-		len -= (size_t)wrote;
+		sent += (size_t)wrote;
 	}
 
-	return true;
+	memmove(client->tx_buf, client->tx_buf + sent, client->tx_len - sent);
+	client->tx_len -= sent;
+
+	if (client->closing && client->tx_len == 0)
+		close_client(client);
+}
+
+static void queue_client_output(RemoteClient *client, const char *data, size_t len)
+{
+	if (client->fd < 0)
+		return;
+
+	if (client->tx_len + len > client->tx_cap)
+	{
+		if (client->tx_len + len > REMOTE_TX_BUF_MAX)
+		{
+			// client is not reading its replies
+			close_client(client);
+			return;
+		}
+
+		size_t new_cap = MAX(client->tx_cap * 2, (size_t)REMOTE_RX_BUF_SIZE);
+		while (new_cap < client->tx_len + len)
+			new_cap *= 2;
+
+		char *new_buf = realloc(client->tx_buf, new_cap);
+		if (new_buf == NULL)
+		{
+			close_client(client);
+			return;
+		}
+		client->tx_buf = new_buf;
+		client->tx_cap = new_cap;
+	}
+
+	memcpy(client->tx_buf + client->tx_len, data, len);
+	client->tx_len += len;
 }
 
-static void remote_reply_raw(const char *json_line)
+static void remote_reply_raw(RemoteClient *client, const char *json_line)
 {
-	if (client_fd < 0)
+	if (client->fd < 0)
 		return;
 
-	write_all(json_line, strlen(json_line));
-	write_all("\n", 1);
-	close_client();
+	queue_client_output(client, json_line, strlen(json_line));
+	queue_client_output(client, "\n", 1);
+
+	if (client->fd >= 0)
+		flush_client(client);
 }
 
-static void remote_reply_ok(void)
+static void remote_reply_ok(RemoteClient *client)
 {
-	remote_reply_raw("{\"ok\":true}");
+	remote_reply_raw(client, "{\"ok\":true}");
 }
 
-static void remote_reply_error(const char *msg)
+static void remote_reply_error(RemoteClient *client, const char *msg)
 {
 	char safe_msg[200];
 	size_t j = 0;
@@ -135,78 +289,348 @@ static void remote_reply_error(const char *msg)
 
 	char json[256];
 	snprintf(json, sizeof(json), "{\"ok\":false,\"error\":\"%s\"}", safe_msg);
-	remote_reply_raw(json);
+	remote_reply_raw(client, json);
 }
 
-static bool json_extract_string(const char *json, const char *key, char *out, size_t out_size)
+typedef enum
 {
-	char pattern[64];
-	snprintf(pattern, sizeof(pattern), "\"%s\"", key);
-
-	const char *p = strstr(json, pattern);
-	if (p == NULL)
-		return false;
+	JSON_NULL = 0,
+	JSON_BOOL,
+	JSON_NUMBER,
+	JSON_STRING,
+	JSON_ARRAY
+} JsonType;
+
+typedef struct
+{
+	const char *key;
+	JsonType type;
+	const char *string;  // JSON_STRING
+	long number;         // JSON_NUMBER, JSON_BOOL
+	uint first_item;     // JSON_ARRAY: strings in JsonCommand.items
+	uint item_count;
+} JsonField;
+
+/* One command line, tokenized in a single pass; strings point into the (unescaped) line. */
+typedef struct
+{
+	JsonField fields[REMOTE_JSON_MAX_FIELDS];
+	uint field_count;
+	const char *items[REMOTE_JSON_MAX_ITEMS];
+	uint item_count;
+} JsonCommand;
 
-	p += strlen(pattern);
-	while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
-		++p;
-	if (*p != ':')
-		return false;
-	++p;
+static char *json_skip_ws(char *p)
+{
 	while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
 		++p;
-	if (*p != '"')
-		return false;
-	++p;
+	return p;
+}
 
-	size_t j = 0;
-	for (; *p != '\0' && *p != '"'; ++p)
+static int json_hex_digit(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+/* Unescapes the string starting at the opening quote in place; returns the position after the closing quote. */
+static char *json_parse_string(char *p, const char **out)
+{
+	char *w = ++p;
+	*out = w;
+
+	for (;;)
 	{
-		if (*p == '\\')
+		char c = *p++;
+		if (c == '\0')
+			return NULL;
+		if (c == '"')
+			break;
+
+		if (c == '\\')
 		{
-			++p;
-			if (*p == '\0')
+			c = *p++;
+			switch (c)
+			{
+			case '"':
+			case '\\':
+			case '/':
+				break;
+			case 'b': c = '\b'; break;
+			case 'f': c = '\f'; break;
+			case 'n': c = '\n'; break;
+			case 'r': c = '\r'; break;
+			case 't': c = '\t'; break;
+			case 'u':
+			{
+				uint code = 0;
+				for (int i = 0; i < 4; ++i)
+				{
+					const int digit = json_hex_digit(*p++);
+					if (digit < 0)
+						return NULL;
+					code = (code << 4) | (uint)digit;
+				}
+
+				// a NUL would silently cut the unescaped string short
+				if (code == 0)
+					return NULL;
+
+				// encode as UTF-8; never longer than the six-character escape
+				if (code >= 0x800)
+				{
+					*w++ = (char)(0xe0 | (code >> 12));
+					*w++ = (char)(0x80 | ((code >> 6) & 0x3f));
+					c = (char)(0x80 | (code & 0x3f));
+				}
+				else if (code >= 0x80)
+				{
+					*w++ = (char)(0xc0 | (code >> 6));
+					c = (char)(0x80 | (code & 0x3f));
+				}
+				else
+				{
+					c = (char)code;
+				}
 				break;
+			}
+			default:
+				return NULL;
+			}
 		}
 
-		if (j + 1 < out_size)
-			out[j++] = *p;
+		*w++ = c;
 	}
 
-	if (*p != '"')
-		return false;
+	*w = '\0';
+	return p;
+}
 
-	out[j] = '\0';
-	return true;
+static char *json_parse_value(char *p, JsonCommand *cmd, JsonField *field)
+{
+	if (*p == '"')
+	{
+		field->type = JSON_STRING;
+		return json_parse_string(p, &field->string);
+	}
+
+	if (*p == '[')
+	{
+		field->type = JSON_ARRAY;
+		field->first_item = cmd->item_count;
+		field->item_count = 0;
+
+		p = json_skip_ws(p + 1);
+		if (*p == ']')
+			return p + 1;
+
+		for (;;)
+		{
+			// arrays carry key names and similar batches, so only strings are accepted
+			if (*p != '"' || cmd->item_count == COUNTOF(cmd->items))
+				return NULL;
+
+			p = json_parse_string(p, &cmd->items[cmd->item_count]);
+			if (p == NULL)
+				return NULL;
+			++cmd->item_count;
+			++field->item_count;
+
+			p = json_skip_ws(p);
+			if (*p == ']')
+				return p + 1;
+			if (*p != ',')
+				return NULL;
+			p = json_skip_ws(p + 1);
+		}
+	}
+
+	if (strncmp(p, "true", 4) == 0 || strncmp(p, "false", 5) == 0)
+	{
+		field->type = JSON_BOOL;
+		field->number = (*p == 't');
+		return p + (*p == 't' ? 4 : 5);
+	}
+
+	if (strncmp(p, "null", 4) == 0)
+	{
+		field->type = JSON_NULL;
+		return p + 4;
+	}
+
+	char *end = NULL;
+	field->type = JSON_NUMBER;
+	field->number = strtol(p, &end, 10);
+	if (end == p)
+		return NULL;
+
+	// integers only; drop any fraction or exponent
+	while (*end == '.' || *end == 'e' || *end == 'E' || *end == '+' || *end == '-' || (*end >= '0' && *end <= '9'))
+		++end;
+	return end;
 }
 
-static bool json_extract_int(const char *json, const char *key, int *out)
+/* Tokenizes a flat JSON object into `cmd`, unescaping strings in place. */
+static bool json_parse_command(char *line, JsonCommand *cmd)
 {
-	char pattern[64];
-	snprintf(pattern, sizeof(pattern), "\"%s\"", key);
+	cmd->field_count = 0;
+	cmd->item_count = 0;
 
-	const char *p = strstr(json, pattern);
-	if (p == NULL)
+	char *p = json_skip_ws(line);
+	if (*p != '{')
 		return false;
 
-	p += strlen(pattern);
-	while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
-		++p;
-	if (*p != ':')
+	p = json_skip_ws(p + 1);
+	if (*p == '}')
+		return true;
+
+	for (;;)
+	{
+		if (*p != '"' || cmd->field_count == COUNTOF(cmd->fields))
+			return false;
+
+		JsonField *field = &cmd->fields[cmd->field_count++];
+
+		p = json_parse_string(p, &field->key);
+		if (p == NULL)
+			return false;
+
+		p = json_skip_ws(p);
+		if (*p != ':')
+			return false;
+
+		p = json_parse_value(json_skip_ws(p + 1), cmd, field);
+		if (p == NULL)
+			return false;
+
+		p = json_skip_ws(p);
+		if (*p == '}')
+			return true;
+		if (*p != ',')
+			return false;
+		p = json_skip_ws(p + 1);
+	}
+}
+
+static const JsonField *json_find(const JsonCommand *cmd, const char *key, JsonType type)
+{
+	for (uint i = 0; i < cmd->field_count; ++i)
+	{
+		if (cmd->fields[i].type == type && strcmp(cmd->fields[i].key, key) == 0)
+			return &cmd->fields[i];
+	}
+	return NULL;
+}
+
+static const char *json_get_string(const JsonCommand *cmd, const char *key)
+{
+	const JsonField *field = json_find(cmd, key, JSON_STRING);
+	return field != NULL ? field->string : NULL;
+}
+
+static bool json_get_int(const JsonCommand *cmd, const char *key, int *out)
+{
+	const JsonField *field = json_find(cmd, key, JSON_NUMBER);
+	if (field == NULL)
 		return false;
-	++p;
-	while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
-		++p;
 
-	char *end = NULL;
-	long value = strtol(p, &end, 10);
-	if (end == p)
+	*out = (int)field->number;
+	return true;
+}
+
+static bool json_get_bool(const JsonCommand *cmd, const char *key, bool *out)
+{
+	const JsonField *field = json_find(cmd, key, JSON_BOOL);
+	if (field == NULL)
 		return false;
 
-	*out = (int)value;
+	*out = field->number != 0;
 	return true;
 }
 
+/* Copies a string for embedding in a JSON reply, escaping quotes, backslashes and
+   control characters.  Truncates at out_size without splitting an escape. */
+static void json_copy_safe(char *out, const char *in, size_t out_size)
+{
+	size_t len = 0;
+	for (; *in != '\0'; ++in)
+	{
+		const unsigned char c = (unsigned char)*in;
+
+		char escaped[8];
+		if (c == '"' || c == '\\')
+			snprintf(escaped, sizeof(escaped), "\\%c", c);
+		else if (c < 0x20)
+			snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+		else
+			snprintf(escaped, sizeof(escaped), "%c", c);
+
+		const size_t escaped_len = strlen(escaped);
+		if (len + escaped_len >= out_size)
+			break;
+		memcpy(out + len, escaped, escaped_len);
+		len += escaped_len;
+	}
+	if (out_size > 0)
+		out[len] = '\0';
+}
+
+static Uint32 subscribed_events(void)
+{
+	Uint32 mask = 0;
+	for (uint i = 0; i < COUNTOF(clients); ++i)
+	{
+		if (clients[i].fd >= 0)
+			mask |= clients[i].subscriptions;
+	}
+	return mask;
+}
+
+/* Pushes one event line to every client subscribed to `mask`. */
+static void broadcast_event(Uint32 mask, const char *json_line)
+{
+	for (uint i = 0; i < COUNTOF(clients); ++i)
+	{
+		if (clients[i].fd >= 0 && (clients[i].subscriptions & mask) != 0)
+			remote_reply_raw(&clients[i], json_line);
+	}
+}
+
+/* Parses a comma-separated event list such as "level,death"; returns 0 on an unknown name. */
+static Uint32 parse_event_mask(const char *list)
+{
+	Uint32 mask = 0;
+
+	while (*list != '\0')
+	{
+		while (*list == ',' || *list == ' ')
+			++list;
+
+		const size_t len = strcspn(list, ", ");
+		if (len == 0)
+			break;
+
+		Uint32 found = 0;
+		for (uint i = 0; i < COUNTOF(remote_event_names); ++i)
+		{
+			if (strlen(remote_event_names[i].name) == len && strncmp(list, remote_event_names[i].name, len) == 0)
+				found = remote_event_names[i].mask;
+		}
+		if (found == 0)
+			return 0;
+
+		mask |= found;
+		list += len;
+	}
+
+	return mask;
+}
+
 static SDL_Scancode parse_scancode_name(const char *name)
 {
 	char lower[64];
@@ -274,237 +698,688 @@ static bool push_text_event(const char *text)
 	ev.text.windowID = main_window ? SDL_GetWindowID(main_window) : 0;
 	SDL_strlcpy(ev.text.text, text, sizeof(ev.text.text));
 
-	return SDL_PushEvent(&ev) == 1;
-}
+	return SDL_PushEvent(&ev) == 1;
+}
+
+static ulong player_score(const Player *this_player)
+{
+	// JE_getValue() walks weapon power levels, which are zero until
+	// JE_initPlayerData() has run; fall back to cash before then.
+	if (player[0].items.weapon[FRONT_WEAPON].power == 0 ||
+	    player[twoPlayerMode ? 1 : 0].items.weapon[REAR_WEAPON].power == 0)
+		return this_player->cash;
+
+	return JE_totalScore(this_player);
+}
+
+/* Copies the command's optional "session" id into `out` (empty without one).  Replies
+   with an error and returns false if the id is too long to keep. */
+static bool get_session(RemoteClient *client, const JsonCommand *cmd, char *out)
+{
+	const char *session = json_get_string(cmd, "session");
+	if (session == NULL)
+		session = "";
+
+	if (strlen(session) >= REMOTE_SESSION_SIZE)
+	{
+		remote_reply_error(client, "session too long");
+		return false;
+	}
+
+	strcpy(out, session);
+	return true;
+}
+
+/* Returns the delta baseline of the named session, or of the client's connection
+   when `session` is empty. */
+static RewardBaseline *reward_baseline(RemoteClient *client, const char *session)
+{
+	if (session[0] == '\0')
+		return &client->reward_last;
+
+	uint slot = COUNTOF(reward_sessions);
+	for (uint i = 0; i < COUNTOF(reward_sessions); ++i)
+	{
+		if (reward_sessions[i].last_used != 0 && strcmp(reward_sessions[i].name, session) == 0)
+		{
+			slot = i;
+			break;
+		}
+	}
+
+	if (slot == COUNTOF(reward_sessions))
+	{
+		slot = 0;
+		for (uint i = 1; i < COUNTOF(reward_sessions); ++i)
+			if (reward_sessions[i].last_used < reward_sessions[slot].last_used)
+				slot = i;
+
+		strcpy(reward_sessions[slot].name, session);
+		reward_sessions[slot].baseline.game = 0;
+	}
+
+	reward_sessions[slot].last_used = ++reward_session_clock;
+	return &reward_sessions[slot].baseline;
+}
+
+/* Appends reward/episode fields (starting with a comma) and advances `last` to the totals reported. */
+static void format_episode_signals(RewardBaseline *last, char *out, size_t out_size)
+{
+	const uint player_count = twoPlayerMode ? 2 : 1;
+
+	int len = snprintf(
+		out,
+		out_size,
+		",\"game\":%u,\"episode\":%u,\"main_level\":%u,\"cur_loc\":%u,\"enemies_killed\":%u,\"enemies_total\":%u,"
+		"\"level_ended\":%s,\"players_dead\":%s,\"players\":[",
+		reward_game,
+		episodeNum,
+		mainLevel,
+		curLoc,
+		enemyKilled,
+		totalEnemy,
+		endLevel ? "true" : "false",
+		all_players_dead() ? "true" : "false"
+	);
+
+	for (uint i = 0; i < player_count; ++i)
+	{
+		const ulong score = player_score(&player[i]);
+		const int armor = (int)player[i].armor;
+		const int shield = (int)player[i].shield;
+
+		const bool valid = last->game == reward_game;
+		const long score_delta = valid ? (long)(score - last->score[i]) : 0;
+		const int armor_delta = valid ? armor - last->armor[i] : 0;
+		const int shield_delta = valid ? shield - last->shield[i] : 0;
+
+		if (len >= 0 && (size_t)len < out_size)
+		{
+			len += snprintf(
+				out + len,
+				out_size - (size_t)len,
+				"%s{\"score\":%lu,\"score_delta\":%ld,\"armor\":%d,\"armor_delta\":%d,"
+				"\"shield\":%d,\"shield_delta\":%d,\"alive\":%s}",
+				i > 0 ? "," : "",
+				score,
+				score_delta,
+				armor,
+				armor_delta,
+				shield,
+				shield_delta,
+				player[i].is_alive ? "true" : "false"
+			);
+		}
+
+		last->score[i] = score;
+		last->armor[i] = armor;
+		last->shield[i] = shield;
+	}
+	last->game = reward_game;
+
+	if (len >= 0 && (size_t)len < out_size)
+		snprintf(out + len, out_size - (size_t)len, "]");
+}
+
+/* Appends the netplay link counters (starting with a comma) during a network game. */
+static void format_network_stats(char *out, size_t out_size)
+{
+	out[0] = '\0';
+
+#ifdef WITH_NETWORK
+	if (!isNetworkGame)
+		return;
+
+	const NetworkStats *stats = &network_stats;
+	snprintf(
+		out,
+		out_size,
+		",\"net\":{\"rtt_ms\":%.1f,\"rtt_p95_ms\":%u,\"rtt_samples\":%u,"
+		"\"packets_sent\":%u,\"packets_received\":%u,\"bytes_sent\":%u,\"bytes_received\":%u,"
+		"\"packets_sent_per_s\":%.1f,\"packets_received_per_s\":%.1f,\"bytes_sent_per_s\":%.1f,\"bytes_received_per_s\":%.1f,"
+		"\"resends\":%u,\"retries\":%u,\"xor_recoveries\":%u,"
+		"\"stalls\":%u,\"blocked_ms\":%u,\"blocked_ms_per_s\":%.1f,\"desyncs\":%u,"
+		"\"spectating\":%s,\"spectators\":%u}",
+		stats->rtt_ms, stats->rtt_p95_ms, stats->rtt_count,
+		stats->packets_sent, stats->packets_received, stats->bytes_sent, stats->bytes_received,
+		stats->packets_sent_rate, stats->packets_received_rate, stats->bytes_sent_rate, stats->bytes_received_rate,
+		stats->resends, stats->retries, stats->xor_recoveries,
+		stats->stalls, stats->stalled_ms, stats->stalled_ms_rate, stats->desyncs,
+		network_spectating ? "true" : "false", stats->spectators
+	);
+#else
+	(void)out_size;
+#endif
+}
+
+static void remote_reply_state(RemoteClient *client, const char *session)
+{
+	char context_safe[REMOTE_CONTEXT_SIZE];
+	json_copy_safe(context_safe, ui_context, sizeof(context_safe));
+
+	char signals[512];
+	format_episode_signals(reward_baseline(client, session), signals, sizeof(signals));
+
+	char net[512];
+	format_network_stats(net, sizeof(net));
+
+	char json[1536];
+	snprintf(
+		json,
+		sizeof(json),
+		"{\"ok\":true,\"frame\":%" PRIu64 ",\"context\":\"%s\",\"console_active\":%s,"
+		"\"scaler_index\":%u,\"scaler_name\":\"%s\",\"scaling_mode\":\"%s\",\"fullscreen_display\":%d%s%s}",
+		frame_counter,
+		context_safe,
+		debug_console_is_active() ? "true" : "false",
+		scaler,
+		scalers[scaler].name,
+		scaling_mode_names[scaling_mode],
+		fullscreen_display,
+		signals,
+		net
+	);
+	remote_reply_raw(client, json);
+}
+
+static void remote_reply_screenshot(RemoteClient *client, const char *path)
+{
+	char safe_path[PATH_MAX];
+	json_copy_safe(safe_path, path, sizeof(safe_path));
+
+	char json[PATH_MAX + 64];
+	snprintf(json, sizeof(json), "{\"ok\":true,\"path\":\"%s\"}", safe_path);
+	remote_reply_raw(client, json);
+}
+
+/* Hands the frame to the encoder; the game thread only pays for the copy. */
+static void start_screenshot(RemoteClient *client, SDL_Surface *surface, const char *path, bool async)
+{
+	if (!screenshot_ready)
+	{
+		remote_reply_error(client, "screenshot encoder unavailable");
+		return;
+	}
+
+	const Uint32 job = screenshot_queue(surface, path, client->serial);
+	if (job == 0)
+	{
+		remote_reply_error(client, "screenshot queue full");
+		return;
+	}
+
+	if (async)
+	{
+		char json[96];
+		snprintf(json, sizeof(json), "{\"ok\":true,\"queued\":true,\"id\":%" PRIu32 "}", job);
+		remote_reply_raw(client, json);
+		return;
+	}
+
+	client->pending.type = REMOTE_PENDING_SCREENSHOT_ENCODE;
+	client->pending.screenshot_job = job;
+}
+
+/* Routes finished encoder jobs back to the client that asked for them. */
+static void deliver_screenshots(void)
+{
+	Uint32 job, owner;
+	bool ok;
+	char path[PATH_MAX];
+
+	while (screenshot_poll_done(&job, &owner, &ok, path, sizeof(path)))
+	{
+		RemoteClient *client = NULL;
+		for (uint i = 0; i < COUNTOF(clients); ++i)
+		{
+			if (clients[i].fd >= 0 && clients[i].serial == owner)
+			{
+				client = &clients[i];
+				break;
+			}
+		}
+
+		if (client == NULL)
+			continue;  // client went away; the file is still written
+
+		if (client->pending.type == REMOTE_PENDING_SCREENSHOT_ENCODE && client->pending.screenshot_job == job)
+		{
+			client->pending.type = REMOTE_PENDING_NONE;
+			client->pending.screenshot_job = 0;
+
+			if (ok)
+				remote_reply_screenshot(client, path);
+			else
+				remote_reply_error(client, "screenshot failed");
+		}
+		else
+		{
+			char safe_path[PATH_MAX];
+			json_copy_safe(safe_path, path, sizeof(safe_path));
+
+			char json[PATH_MAX + 96];
+			snprintf(json, sizeof(json), "{\"event\":\"screenshot\",\"id\":%" PRIu32 ",\"ok\":%s,\"path\":\"%s\"}",
+			         job, ok ? "true" : "false", safe_path);
+			remote_reply_raw(client, json);
+		}
+	}
+}
+
+static void cmd_ping(RemoteClient *client, const JsonCommand *cmd)
+{
+	(void)cmd;
+
+	remote_reply_raw(client, "{\"ok\":true,\"pong\":true}");
+}
+
+static void cmd_audio_stats(RemoteClient *client, const JsonCommand *cmd)
+{
+	AudioStats stats;
+	if (!audio_get_stats(&stats))
+	{
+		remote_reply_error(client, "audio disabled");
+		return;
+	}
+
+	bool reset = false;
+	(void)json_get_bool(cmd, "reset", &reset);
+	if (reset)
+		audio_reset_stats();
+
+	char json[512];
+	snprintf(json, sizeof(json),
+		"{\"ok\":true,\"rate\":%d,\"channels\":%d,\"frames\":%d,\"callbacks\":%u,\"underruns\":%u,\"dropped\":%u,"
+		"\"callback_ms\":{\"avg\":%.3f,\"max\":%.3f,\"last\":%.3f},"
+		"\"interval_ms\":{\"avg\":%.3f,\"max\":%.3f},"
+		"\"total_ms\":{\"lds\":%.3f,\"opl\":%.3f,\"mix\":%.3f}}",
+		stats.rate, stats.channels, stats.frames, stats.callbacks, stats.underruns, stats.dropped,
+		stats.callback_ms_avg, stats.callback_ms_max, stats.callback_ms_last,
+		stats.interval_ms_avg, stats.interval_ms_max,
+		stats.lds_ms, stats.synth_ms, stats.mix_ms);
+	remote_reply_raw(client, json);
+}
+
+static void cmd_get_state(RemoteClient *client, const JsonCommand *cmd)
+{
+	char session[REMOTE_SESSION_SIZE];
+	if (!get_session(client, cmd, session))
+		return;
+
+	remote_reply_state(client, session);
+}
+
+static bool push_key_action(const char *action, SDL_Scancode scan)
+{
+	if (strcmp(action, "down") == 0)
+		return push_key_event(SDL_KEYDOWN, scan);
+	if (strcmp(action, "up") == 0)
+		return push_key_event(SDL_KEYUP, scan);
+
+	const bool pushed = push_key_event(SDL_KEYDOWN, scan);
+	return push_key_event(SDL_KEYUP, scan) && pushed;
+}
+
+static void cmd_send_key(RemoteClient *client, const JsonCommand *cmd)
+{
+	const char *key_name = json_get_string(cmd, "key");
+	const char *action = json_get_string(cmd, "action");
+	int repeat = 1;
+
+	if (key_name == NULL)
+	{
+		remote_reply_error(client, "missing key");
+		return;
+	}
+	if (action == NULL)
+		action = "tap";
+	(void)json_get_int(cmd, "repeat", &repeat);
+	repeat = MAX(1, repeat);
+
+	const SDL_Scancode scan = parse_scancode_name(key_name);
+	if (scan == SDL_SCANCODE_UNKNOWN)
+	{
+		remote_reply_error(client, "unknown key");
+		return;
+	}
+
+	bool pushed = true;
+	for (int i = 0; i < repeat; ++i)
+		pushed = push_key_action(action, scan) && pushed;
+
+	if (!pushed)
+	{
+		remote_reply_error(client, "failed to push key event");
+		return;
+	}
+
+	remote_reply_ok(client);
+}
+
+static void cmd_send_keys(RemoteClient *client, const JsonCommand *cmd)
+{
+	const JsonField *keys = json_find(cmd, "keys", JSON_ARRAY);
+	const char *action = json_get_string(cmd, "action");
+
+	if (keys == NULL)
+	{
+		remote_reply_error(client, "missing keys");
+		return;
+	}
+	if (action == NULL)
+		action = "tap";
+
+	SDL_Scancode scans[REMOTE_JSON_MAX_ITEMS];
+	for (uint i = 0; i < keys->item_count; ++i)
+	{
+		scans[i] = parse_scancode_name(cmd->items[keys->first_item + i]);
+		if (scans[i] == SDL_SCANCODE_UNKNOWN)
+		{
+			remote_reply_error(client, "unknown key");
+			return;
+		}
+	}
+
+	bool pushed = true;
+	for (uint i = 0; i < keys->item_count; ++i)
+		pushed = push_key_action(action, scans[i]) && pushed;
 
-static void remote_reply_state(void)
-{
-	char context_safe[REMOTE_CONTEXT_SIZE];
-	SDL_strlcpy(context_safe, ui_context, sizeof(context_safe));
-	for (size_t i = 0; context_safe[i] != '\0'; ++i)
+	if (!pushed)
 	{
-		if (context_safe[i] == '"' || context_safe[i] == '\\')
-			context_safe[i] = '_';
+		remote_reply_error(client, "failed to push key event");
+		return;
 	}
 
-	char json[512];
-	snprintf(
-		json,
-		sizeof(json),
-		"{\"ok\":true,\"frame\":%" PRIu64 ",\"context\":\"%s\",\"console_active\":%s,"
-		"\"scaler_index\":%u,\"scaler_name\":\"%s\",\"scaling_mode\":\"%s\",\"fullscreen_display\":%d}",
-		frame_counter,
-		context_safe,
-		debug_console_is_active() ? "true" : "false",
-		scaler,
-		scalers[scaler].name,
-		scaling_mode_names[scaling_mode],
-		fullscreen_display
-	);
-	remote_reply_raw(json);
+	remote_reply_ok(client);
 }
 
-static void handle_command(const char *line)
+static void cmd_send_text(RemoteClient *client, const JsonCommand *cmd)
 {
-	if (client_fd < 0)
+	const char *text = json_get_string(cmd, "text");
+	if (text == NULL)
+	{
+		remote_reply_error(client, "missing text");
 		return;
+	}
 
-	if (pending.type != REMOTE_PENDING_NONE)
+	if (!push_text_event(text))
 	{
-		remote_reply_error("busy");
+		remote_reply_error(client, "failed to push text event");
 		return;
 	}
 
-	char cmd[64];
-	if (!json_extract_string(line, "cmd", cmd, sizeof(cmd)))
+	remote_reply_ok(client);
+}
+
+static void cmd_console_exec(RemoteClient *client, const JsonCommand *cmd)
+{
+	const char *command = json_get_string(cmd, "command");
+	if (command == NULL)
 	{
-		remote_reply_error("missing cmd");
+		remote_reply_error(client, "missing command");
 		return;
 	}
 
-	if (strcmp(cmd, "ping") == 0)
+	char command_line[256];
+	SDL_strlcpy(command_line, command, sizeof(command_line));
+	debug_console_execute_command(command_line);
+
+	char output[160];
+	json_copy_safe(output, debug_console_get_last_line(), sizeof(output));
+
+	char json[240];
+	snprintf(json, sizeof(json), "{\"ok\":true,\"output\":\"%s\"}", output);
+	remote_reply_raw(client, json);
+}
+
+static void cmd_wait_frames(RemoteClient *client, const JsonCommand *cmd)
+{
+	int frames = 1;
+	(void)json_get_int(cmd, "frames", &frames);
+	if (frames <= 0)
 	{
-		remote_reply_raw("{\"ok\":true,\"pong\":true}");
+		remote_reply_ok(client);
 		return;
 	}
 
-	if (strcmp(cmd, "get_state") == 0)
+	if (!get_session(client, cmd, client->pending.session))
+		return;
+
+	client->pending.type = REMOTE_PENDING_WAIT_FRAMES;
+	client->pending.frames_left = frames;
+}
+
+static void cmd_screenshot(RemoteClient *client, const JsonCommand *cmd)
+{
+	const char *path = json_get_string(cmd, "path");
+	bool async = false;
+	if (path == NULL)
+		path = "/tmp/tyrian3000-remote.png";
+	(void)json_get_bool(cmd, "async", &async);
+
+	if (last_presented_surface != NULL)
 	{
-		remote_reply_state();
+		start_screenshot(client, last_presented_surface, path, async);
 		return;
 	}
 
-	if (strcmp(cmd, "send_key") == 0)
-	{
-		char key_name[64];
-		char action[16] = "tap";
-		int repeat = 1;
+	client->pending.type = REMOTE_PENDING_SCREENSHOT;
+	client->pending.frames_left = 1;
+	client->pending.screenshot_async = async;
+	SDL_strlcpy(client->pending.screenshot_path, path, sizeof(client->pending.screenshot_path));
+}
 
-		if (!json_extract_string(line, "key", key_name, sizeof(key_name)))
-		{
-			remote_reply_error("missing key");
-			return;
-		}
-		(void)json_extract_string(line, "action", action, sizeof(action));
-		(void)json_extract_int(line, "repeat", &repeat);
-		repeat = MAX(1, repeat);
+static void update_subscriptions(RemoteClient *client, const JsonCommand *cmd, bool subscribe)
+{
+	Uint32 mask = REMOTE_EVENT_ALL;
 
-		const SDL_Scancode scan = parse_scancode_name(key_name);
-		if (scan == SDL_SCANCODE_UNKNOWN)
+	const char *events = json_get_string(cmd, "events");
+	if (events != NULL)
+	{
+		mask = parse_event_mask(events);
+		if (mask == 0)
 		{
-			remote_reply_error("unknown key");
+			remote_reply_error(client, "unknown event");
 			return;
 		}
+	}
 
-		bool pushed = true;
-		for (int i = 0; i < repeat; ++i)
-		{
-			if (strcmp(action, "down") == 0)
-			{
-				pushed = push_key_event(SDL_KEYDOWN, scan) && pushed;
-			}
-			else if (strcmp(action, "up") == 0)
-			{
-				pushed = push_key_event(SDL_KEYUP, scan) && pushed;
-			}
-			else
-			{
-				pushed = push_key_event(SDL_KEYDOWN, scan) && pushed;
-				pushed = push_key_event(SDL_KEYUP, scan) && pushed;
-			}
-		}
+	if (subscribe)
+		client->subscriptions |= mask;
+	else
+		client->subscriptions &= ~mask;
 
-		if (!pushed)
-		{
-			remote_reply_error("failed to push key event");
-			return;
-		}
+	char json[256];
+	int len = snprintf(json, sizeof(json), "{\"ok\":true,\"events\":[");
+	bool first = true;
+	for (uint i = 0; i < COUNTOF(remote_event_names); ++i)
+	{
+		if (remote_event_names[i].mask == REMOTE_EVENT_ALL || (client->subscriptions & remote_event_names[i].mask) == 0)
+			continue;
+		len += snprintf(json + len, sizeof(json) - (size_t)len, "%s\"%s\"", first ? "" : ",", remote_event_names[i].name);
+		first = false;
+	}
+	snprintf(json + len, sizeof(json) - (size_t)len, "]}");
+	remote_reply_raw(client, json);
+}
+
+static void cmd_subscribe(RemoteClient *client, const JsonCommand *cmd)
+{
+	update_subscriptions(client, cmd, true);
+}
+
+static void cmd_unsubscribe(RemoteClient *client, const JsonCommand *cmd)
+{
+	update_subscriptions(client, cmd, false);
+}
 
-		remote_reply_ok();
+static void cmd_quit(RemoteClient *client, const JsonCommand *cmd)
+{
+	(void)cmd;
+
+	SDL_Event quit;
+	SDL_memset(&quit, 0, sizeof(quit));
+	quit.type = SDL_QUIT;
+	SDL_PushEvent(&quit);
+	remote_reply_ok(client);
+}
+
+typedef struct
+{
+	const char *name;
+	void (*handler)(RemoteClient *client, const JsonCommand *cmd);
+} RemoteCommand;
+
+/* Sorted by name for bsearch(). */
+static const RemoteCommand remote_commands[] =
+{
+	{ "audio_stats",  cmd_audio_stats },
+	{ "console_exec", cmd_console_exec },
+	{ "get_state",    cmd_get_state },
+	{ "ping",         cmd_ping },
+	{ "quit",         cmd_quit },
+	{ "screenshot",   cmd_screenshot },
+	{ "send_key",     cmd_send_key },
+	{ "send_keys",    cmd_send_keys },
+	{ "send_text",    cmd_send_text },
+	{ "subscribe",    cmd_subscribe },
+	{ "unsubscribe",  cmd_unsubscribe },
+	{ "wait_frames",  cmd_wait_frames },
+};
+
+static int compare_command_name(const void *key, const void *element)
+{
+	return strcmp((const char *)key, ((const RemoteCommand *)element)->name);
+}
+
+static void handle_command(RemoteClient *client, char *line)
+{
+	JsonCommand cmd;
+	if (!json_parse_command(line, &cmd))
+	{
+		remote_reply_error(client, "invalid json");
 		return;
 	}
 
-	if (strcmp(cmd, "send_text") == 0)
+	const char *name = json_get_string(&cmd, "cmd");
+	if (name == NULL)
 	{
-		char text[SDL_TEXTINPUTEVENT_TEXT_SIZE];
-		if (!json_extract_string(line, "text", text, sizeof(text)))
-		{
-			remote_reply_error("missing text");
-			return;
-		}
-
-		if (!push_text_event(text))
-		{
-			remote_reply_error("failed to push text event");
-			return;
-		}
+		remote_reply_error(client, "missing cmd");
+		return;
+	}
 
-		remote_reply_ok();
+	const RemoteCommand *command = bsearch(name, remote_commands, COUNTOF(remote_commands), sizeof(*remote_commands), compare_command_name);
+	if (command == NULL)
+	{
+		remote_reply_error(client, "unknown cmd");
 		return;
 	}
 
-	if (strcmp(cmd, "console_exec") == 0)
+	command->handler(client, &cmd);
+}
+
+/* Runs up to `budget` complete lines; a command waiting on frames holds back the rest. */
+static void consume_rx(RemoteClient *client, int budget)
+{
+	size_t consumed = 0;
+
+	while (budget > 0 && client->fd >= 0 && !client->closing && client->pending.type == REMOTE_PENDING_NONE)
 	{
-		char command[256];
-		if (!json_extract_string(line, "command", command, sizeof(command)))
-		{
-			remote_reply_error("missing command");
-			return;
-		}
+		char *line = client->rx_buf + consumed;
+		char *newline = memchr(line, '\n', client->rx_len - consumed);
+		if (newline == NULL)
+			break;
 
-		debug_console_execute_command(command);
+		*newline = '\0';
+		consumed += (size_t)(newline - line) + 1;
 
-		char output[160];
-		SDL_strlcpy(output, debug_console_get_last_line(), sizeof(output));
-		for (size_t i = 0; output[i] != '\0'; ++i)
+		if (line[0] != '\0')
 		{
-			if (output[i] == '"' || output[i] == '\\')
-				output[i] = '_';
+			// parsed in place; the client may be closed by its own reply
+			handle_command(client, line);
+			--budget;
 		}
+	}
 
-		char json[240];
-		snprintf(json, sizeof(json), "{\"ok\":true,\"output\":\"%s\"}", output);
-		remote_reply_raw(json);
-		return;
+	if (client->fd >= 0 && consumed > 0)
+	{
+		memmove(client->rx_buf, client->rx_buf + consumed, client->rx_len - consumed);
+		client->rx_len -= consumed;
 	}
+}
 
-	if (strcmp(cmd, "wait_frames") == 0)
+static void receive_client(RemoteClient *client)
+{
+	while (client->fd >= 0 && client->rx_len < sizeof(client->rx_buf))
 	{
-		int frames = 1;
-		(void)json_extract_int(line, "frames", &frames);
-		if (frames <= 0)
+		const ssize_t got = recv(client->fd, client->rx_buf + client->rx_len, sizeof(client->rx_buf) - client->rx_len, 0);
+		if (got < 0)
 		{
-			remote_reply_ok();
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				close_client(client);
 			return;
 		}
 
-		pending.type = REMOTE_PENDING_WAIT_FRAMES;
-		pending.frames_left = frames;
-		return;
-	}
-
-	if (strcmp(cmd, "screenshot") == 0)
-	{
-		char path[PATH_MAX];
-		if (!json_extract_string(line, "path", path, sizeof(path)))
-			SDL_strlcpy(path, "/tmp/tyrian3000-remote.bmp", sizeof(path));
-
-		if (last_presented_surface != NULL && video_save_surface_rgb(last_presented_surface, path))
+		if (got == 0)
 		{
-			char safe_path[PATH_MAX];
-			SDL_strlcpy(safe_path, path, sizeof(safe_path));
-			for (size_t i = 0; safe_path[i] != '\0'; ++i)
-			{
-				if (safe_path[i] == '"' || safe_path[i] == '\\')
-					safe_path[i] = '_';
-			}
-
-			char json[PATH_MAX + 64];
-			snprintf(json, sizeof(json), "{\"ok\":true,\"path\":\"%s\"}", safe_path);
-			remote_reply_raw(json);
+			close_client(client);
 			return;
 		}
 
-		pending.type = REMOTE_PENDING_SCREENSHOT;
-		pending.frames_left = 1;
-		SDL_strlcpy(pending.screenshot_path, path, sizeof(pending.screenshot_path));
-		return;
+		client->rx_len += (size_t)got;
 	}
 
-	if (strcmp(cmd, "quit") == 0)
+	// a full buffer without a complete line can never make progress
+	if (client->fd >= 0 && client->rx_len == sizeof(client->rx_buf) &&
+	    memchr(client->rx_buf, '\n', client->rx_len) == NULL)
 	{
-		SDL_Event quit;
-		SDL_memset(&quit, 0, sizeof(quit));
-		quit.type = SDL_QUIT;
-		SDL_PushEvent(&quit);
-		remote_reply_ok();
-		return;
+		client->rx_len = 0;
+		remote_reply_error(client, "rx overflow");
+		client->closing = true;
+		if (client->fd >= 0)
+			flush_client(client);
 	}
-
-	remote_reply_error("unknown cmd");
 }
 
-static void consume_rx(void)
+static void accept_clients(void)
 {
-	while (true)
+	for (;;)
 	{
-		char *newline = memchr(rx_buf, '\n', rx_len);
-		if (newline == NULL)
-			break;
-
-		const size_t line_len = (size_t)(newline - rx_buf);
-		char line[REMOTE_RX_BUF_SIZE];
+		const int fd = accept(listen_fd, NULL, NULL);
+		if (fd < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return;
+		}
 
-		const size_t copy_len = MIN(line_len, sizeof(line) - 1);
-		memcpy(line, rx_buf, copy_len);
-		line[copy_len] = '\0';
+		RemoteClient *client = NULL;
+		for (uint i = 0; i < COUNTOF(clients); ++i)
+		{
+			if (clients[i].fd < 0)
+			{
+				client = &clients[i];
+				break;
+			}
+		}
 
-		const size_t consume = line_len + 1;
-		memmove(rx_buf, rx_buf + consume, rx_len - consume);
-		rx_len -= consume;
+		if (client == NULL)
+		{
+			static const char reply[] = "{\"ok\":false,\"error\":\"too many clients\"}\n";
+			(void)send(fd, reply, sizeof(reply) - 1, REMOTE_SEND_FLAGS);
+			close(fd);
+			continue;
+		}
 
-		if (line[0] != '\0')
-			handle_command(line);
+		(void)set_nonblocking(fd);
+#ifdef SO_NOSIGPIPE
+		int one = 1;
+		(void)setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+		reset_client(client);
+		client->fd = fd;
+		client->serial = next_client_serial++;
 	}
 }
 
@@ -564,7 +1439,7 @@ bool remote_control_init(void)
 		return false;
 	}
 
-	if (listen(listen_fd, 1) < 0)
+	if (listen(listen_fd, REMOTE_MAX_CLIENTS) < 0)
 	{
 		fprintf(stderr, "remote: listen() failed: %s\n", strerror(errno));
 		close(listen_fd);
@@ -573,6 +1448,15 @@ bool remote_control_init(void)
 		return false;
 	}
 
+	for (uint i = 0; i < COUNTOF(clients); ++i)
+	{
+		clients[i].tx_buf = NULL;
+		clients[i].tx_cap = 0;
+		reset_client(&clients[i]);
+	}
+
+	screenshot_ready = screenshot_init();
+
 	remote_initialized = true;
 	printf("remote control listening on %s\n", socket_path);
 
@@ -581,8 +1465,14 @@ bool remote_control_init(void)
 
 void remote_control_shutdown(void)
 {
-	if (client_fd >= 0)
-		close_client();
+	if (remote_initialized)
+	{
+		for (uint i = 0; i < COUNTOF(clients); ++i)
+		{
+			if (clients[i].fd >= 0)
+				close_client(&clients[i]);
+		}
+	}
 
 	if (listen_fd >= 0)
 	{
@@ -591,7 +1481,11 @@ void remote_control_shutdown(void)
 	}
 
 	if (remote_initialized)
+	{
+		screenshot_shutdown();
+		screenshot_ready = false;
 		unlink(socket_path);
+	}
 
 	remote_initialized = false;
 }
@@ -601,131 +1495,219 @@ void remote_control_pump(void)
 	if (!remote_initialized)
 		return;
 
-	if (client_fd < 0)
-	{
-		const Uint32 now = SDL_GetTicks();
-		if ((Sint32)(now - next_accept_poll_ticks) < 0)
-			return;
+	struct pollfd fds[1 + REMOTE_MAX_CLIENTS];
+	RemoteClient *fd_clients[1 + REMOTE_MAX_CLIENTS];
+	nfds_t nfds = 0;
 
-		next_accept_poll_ticks = now + 8;
+	fds[nfds].fd = listen_fd;
+	fds[nfds].events = POLLIN;
+	fds[nfds].revents = 0;
+	fd_clients[nfds] = NULL;
+	++nfds;
 
-		client_fd = accept(listen_fd, NULL, NULL);
-		if (client_fd >= 0)
-		{
-			(void)set_nonblocking(client_fd);
-#ifdef SO_NOSIGPIPE
-			int one = 1;
-			(void)setsockopt(client_fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
-#endif
-			rx_len = 0;
-			next_accept_poll_ticks = now;
-		}
+	for (uint i = 0; i < COUNTOF(clients); ++i)
+	{
+		RemoteClient *client = &clients[i];
+		if (client->fd < 0)
+			continue;
+
+		fds[nfds].fd = client->fd;
+		fds[nfds].events = (client->tx_len > 0 ? POLLOUT : 0) |
+		                   (client->rx_len < sizeof(client->rx_buf) ? POLLIN : 0);
+		fds[nfds].revents = 0;
+		fd_clients[nfds] = client;
+		++nfds;
 	}
 
-	if (client_fd < 0)
-		return;
-
-	char buf[512];
-	for (;;)
+	if (poll(fds, nfds, 0) > 0)
 	{
-		const ssize_t got = recv(client_fd, buf, sizeof(buf), 0);
-		if (got < 0)
+		for (nfds_t i = 1; i < nfds; ++i)
 		{
-			if (errno == EINTR)
-				continue;
-			if (errno == EAGAIN || errno == EWOULDBLOCK)
-				break;
-			close_client();
-			break;
-		}
+			RemoteClient *client = fd_clients[i];
 
-		if (got == 0)
-		{
-			close_client();
-			break;
+			if ((fds[i].revents & POLLOUT) && client->fd >= 0)
+				flush_client(client);
+			if ((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) && client->fd >= 0)
+				receive_client(client);
 		}
 
-		const size_t copy_len = MIN((size_t)got, sizeof(rx_buf) - 1 - rx_len);
-		memcpy(rx_buf + rx_len, buf, copy_len);
-		rx_len += copy_len;
-		rx_buf[rx_len] = '\0';
+		if (fds[0].revents & POLLIN)
+			accept_clients();
+	}
 
-		consume_rx();
+	deliver_screenshots();
 
-		if ((size_t)got > copy_len)
-		{
-			remote_reply_error("rx overflow");
-			close_client();
-			break;
-		}
+	// Give every client the same command budget per pump, rotating who goes first,
+	// so a chatty client cannot hold up the game tick or starve the others.
+	for (uint i = 0; i < COUNTOF(clients); ++i)
+	{
+		RemoteClient *client = &clients[(next_client_turn + i) % COUNTOF(clients)];
+		if (client->fd >= 0)
+			consume_rx(client, REMOTE_COMMANDS_PER_PUMP);
 	}
+	next_client_turn = (next_client_turn + 1) % COUNTOF(clients);
 }
 
-void remote_control_on_frame(SDL_Surface *presented_surface)
+static void emit_level_end(void)
 {
-	if (!remote_initialized)
+	event_state.level_active = false;
+
+	if ((subscribed_events() & REMOTE_EVENT_LEVEL) == 0)
 		return;
 
-	++frame_counter;
-	last_presented_surface = presented_surface;
+	char json[192];
+	snprintf(json, sizeof(json),
+	         "{\"event\":\"level_end\",\"frame\":%" PRIu64 ",\"episode\":%u,\"main_level\":%u,\"players_dead\":%s}",
+	         frame_counter, episodeNum, mainLevel, all_players_dead() ? "true" : "false");
+	broadcast_event(REMOTE_EVENT_LEVEL, json);
+}
 
-	if (pending.type == REMOTE_PENDING_NONE)
-		return;
+/* Compares the per-frame game state against the previous frame and emits transitions. */
+static void emit_level_events(void)
+{
+	const Uint32 subscribed = subscribed_events();
+	char json[192];
+
+	for (uint i = 0; i < COUNTOF(player); ++i)
+	{
+		if (event_state.alive[i] && !player[i].is_alive && (subscribed & REMOTE_EVENT_DEATH))
+		{
+			snprintf(json, sizeof(json), "{\"event\":\"player_death\",\"frame\":%" PRIu64 ",\"player\":%u}",
+			         frame_counter, i + 1);
+			broadcast_event(REMOTE_EVENT_DEATH, json);
+		}
+		event_state.alive[i] = player[i].is_alive;
+	}
+
+	const uint bars = (boss_bar[0].link_num != 0 ? 1 : 0) + (boss_bar[1].link_num != 0 ? 1 : 0);
+	if (bars != event_state.boss_bars && (subscribed & REMOTE_EVENT_BOSS_BAR))
+	{
+		snprintf(json, sizeof(json), "{\"event\":\"boss_bar\",\"frame\":%" PRIu64 ",\"bars\":%u}",
+		         frame_counter, bars);
+		broadcast_event(REMOTE_EVENT_BOSS_BAR, json);
+	}
+	event_state.boss_bars = bars;
 
-	if (pending.type == REMOTE_PENDING_WAIT_FRAMES)
+	if (endLevel)
+		emit_level_end();
+}
+
+static void service_pending(RemoteClient *client, SDL_Surface *presented_surface)
+{
+	if (client->pending.type == REMOTE_PENDING_WAIT_FRAMES)
 	{
-		if (--pending.frames_left <= 0)
+		if (--client->pending.frames_left <= 0)
 		{
-			char json[96];
-			snprintf(json, sizeof(json), "{\"ok\":true,\"frame\":%" PRIu64 "}", frame_counter);
-			remote_reply_raw(json);
-			pending.type = REMOTE_PENDING_NONE;
+			char signals[512];
+			format_episode_signals(reward_baseline(client, client->pending.session), signals, sizeof(signals));
+
+			char json[640];
+			snprintf(json, sizeof(json), "{\"ok\":true,\"frame\":%" PRIu64 "%s}", frame_counter, signals);
+			client->pending.type = REMOTE_PENDING_NONE;
+			remote_reply_raw(client, json);
 		}
 		return;
 	}
 
-	if (pending.type == REMOTE_PENDING_SCREENSHOT)
+	if (client->pending.type == REMOTE_PENDING_SCREENSHOT)
 	{
-		if (--pending.frames_left > 0)
+		if (--client->pending.frames_left > 0)
 			return;
 
+		client->pending.type = REMOTE_PENDING_NONE;
+
 		if (presented_surface == NULL)
-		{
-			remote_reply_error("no frame available");
-		}
-		else if (!video_save_surface_rgb(presented_surface, pending.screenshot_path))
-		{
-			remote_reply_error("screenshot failed");
-		}
+			remote_reply_error(client, "no frame available");
 		else
-		{
-			char safe_path[PATH_MAX];
-			SDL_strlcpy(safe_path, pending.screenshot_path, sizeof(safe_path));
-			for (size_t i = 0; safe_path[i] != '\0'; ++i)
-			{
-				if (safe_path[i] == '"' || safe_path[i] == '\\')
-					safe_path[i] = '_';
-			}
+			start_screenshot(client, presented_surface, client->pending.screenshot_path, client->pending.screenshot_async);
 
-			char json[PATH_MAX + 64];
-			snprintf(json, sizeof(json), "{\"ok\":true,\"path\":\"%s\"}", safe_path);
-			remote_reply_raw(json);
-		}
+		client->pending.screenshot_path[0] = '\0';
+	}
+}
+
+void remote_control_on_frame(SDL_Surface *presented_surface)
+{
+	if (!remote_initialized)
+		return;
+
+	++frame_counter;
+	last_presented_surface = presented_surface;
 
-		pending.type = REMOTE_PENDING_NONE;
-		pending.screenshot_path[0] = '\0';
+	for (uint i = 0; i < COUNTOF(clients); ++i)
+	{
+		if (clients[i].fd >= 0 && clients[i].pending.type != REMOTE_PENDING_NONE)
+			service_pending(&clients[i], presented_surface);
 	}
+
+	if (event_state.level_active)
+		emit_level_events();
 }
 
 void remote_control_set_ui_context(const char *context)
 {
 	if (context == NULL || context[0] == '\0')
-	{
-		SDL_strlcpy(ui_context, "unknown", sizeof(ui_context));
+		context = "unknown";
+
+	if (strcmp(ui_context, context) == 0)
 		return;
-	}
 
 	SDL_strlcpy(ui_context, context, sizeof(ui_context));
+
+	if (!remote_initialized || (subscribed_events() & REMOTE_EVENT_UI_CONTEXT) == 0)
+		return;
+
+	char context_safe[REMOTE_CONTEXT_SIZE];
+	json_copy_safe(context_safe, ui_context, sizeof(context_safe));
+
+	char json[160];
+	snprintf(json, sizeof(json), "{\"event\":\"ui_context\",\"frame\":%" PRIu64 ",\"context\":\"%s\"}",
+	         frame_counter, context_safe);
+	broadcast_event(REMOTE_EVENT_UI_CONTEXT, json);
+}
+
+void remote_control_on_game_start(void)
+{
+	++reward_game;
+}
+
+void remote_control_on_level_start(void)
+{
+	if (!remote_initialized)
+		return;
+
+	event_state.level_active = true;
+	for (uint i = 0; i < COUNTOF(player); ++i)
+		event_state.alive[i] = player[i].is_alive;
+	event_state.boss_bars = 0;
+
+	if ((subscribed_events() & REMOTE_EVENT_LEVEL) == 0)
+		return;
+
+	char json[160];
+	snprintf(json, sizeof(json), "{\"event\":\"level_start\",\"frame\":%" PRIu64 ",\"episode\":%u,\"main_level\":%u}",
+	         frame_counter, episodeNum, mainLevel);
+	broadcast_event(REMOTE_EVENT_LEVEL, json);
+}
+
+void remote_control_on_level_end(void)
+{
+	// covers levels left without endLevel being raised (quit, demo end)
+	if (remote_initialized && event_state.level_active)
+		emit_level_end();
+}
+
+void remote_control_on_console_line(const char *line)
+{
+	if (!remote_initialized || (subscribed_events() & REMOTE_EVENT_CONSOLE) == 0)
+		return;
+
+	char line_safe[160];
+	json_copy_safe(line_safe, line, sizeof(line_safe));
+
+	char json[256];
+	snprintf(json, sizeof(json), "{\"event\":\"console\",\"frame\":%" PRIu64 ",\"line\":\"%s\"}",
+	         frame_counter, line_safe);
+	broadcast_event(REMOTE_EVENT_CONSOLE, json);
 }
 
 #else
@@ -768,4 +1750,21 @@ void remote_control_set_ui_context(const char *context)
 	(void)context;
 }
 
+void remote_control_on_game_start(void)
+{
+}
+
+void remote_control_on_level_start(void)
+{
+}
+
+void remote_control_on_level_end(void)
+{
+}
+
+void remote_control_on_console_line(const char *line)
+{
+	(void)line;
+}
+
 #endif
@@ -30,4 +30,10 @@ void remote_control_on_frame(SDL_Surface *presented_surface);
 /* Optional context string shown in get_state responses. */
 void remote_control_set_ui_context(const char *context);
 
+/* Game hooks that feed the events pushed to subscribed clients. */
+void remote_control_on_game_start(void);
+void remote_control_on_level_start(void);
+void remote_control_on_level_end(void);
+void remote_control_on_console_line(const char *line);
+
 #endif /* REMOTE_CONTROL_H */
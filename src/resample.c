@@ -0,0 +1,153 @@
+/*
+ * Tyrian 3000: Polyphase Resampler
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#include "resample.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ZERO_CROSSINGS 8    // each side of the filter, at the lower of the two rates
+#define MAX_PHASES 4096     // beyond this, positions are rounded to the nearest phase
+#define PASSBAND 0.95       // of the lower Nyquist frequency
+
+static unsigned int gcd(unsigned int a, unsigned int b)
+{
+	while (b != 0)
+	{
+		const unsigned int t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+static double sinc(double x)
+{
+	return x == 0.0 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+}
+
+static double blackman(double x)  // x in [-1, 1]
+{
+	return 0.42 + 0.5 * cos(M_PI * x) + 0.08 * cos(2 * M_PI * x);
+}
+
+bool resampler_init(Resampler *resampler, int in_rate, int out_rate)
+{
+	resampler->bank = NULL;
+
+	// a device that reports a rate of 0 would divide by zero below
+	if (in_rate <= 0 || out_rate <= 0)
+		return false;
+
+	const unsigned int g = gcd(in_rate, out_rate);
+	resampler->up = out_rate / g;
+	resampler->down = in_rate / g;
+	resampler->phases = MIN(resampler->up, MAX_PHASES);
+
+	// cutoff in cycles per input sample; when downsampling, the filter widens
+	// to keep the same number of zero crossings at the output rate
+	const double cutoff = 0.5 * PASSBAND * MIN(1.0, (double)out_rate / in_rate);
+	const double half_width = ZERO_CROSSINGS * 0.5 / cutoff;
+	resampler->taps = 2 * (unsigned int)ceil(half_width);
+
+	resampler->bank = malloc((size_t)resampler->phases * resampler->taps * sizeof(*resampler->bank));
+	if (resampler->bank == NULL)
+		return false;
+
+	const int first = 1 - (int)resampler->taps / 2;  // input offset of tap 0
+
+	for (unsigned int p = 0; p < resampler->phases; ++p)
+	{
+		float *filter = &resampler->bank[p * resampler->taps];
+		const double frac = (double)p / resampler->phases;
+
+		double sum = 0;
+		for (unsigned int k = 0; k < resampler->taps; ++k)
+		{
+			const double t = first + (int)k - frac;  // distance from the output position
+			const double w = fabs(t) < half_width ? blackman(t / half_width) : 0.0;
+			const double h = 2 * cutoff * sinc(2 * cutoff * t) * w;
+
+			filter[k] = h;
+			sum += h;
+		}
+
+		// unity gain at DC for every phase, so a constant input stays constant
+		for (unsigned int k = 0; k < resampler->taps; ++k)
+			filter[k] /= sum;
+	}
+
+	return true;
+}
+
+void resampler_free(Resampler *resampler)
+{
+	free(resampler->bank);
+	resampler->bank = NULL;
+}
+
+size_t resampler_output_count(const Resampler *resampler, size_t count)
+{
+	return (count * resampler->up + resampler->down - 1) / resampler->down;
+}
+
+void resampler_run(const Resampler *resampler, const Sint16 *in, size_t count, Sint16 *out)
+{
+	if (resampler->up == resampler->down)
+	{
+		memcpy(out, in, count * sizeof(*in));
+		return;
+	}
+
+	const size_t out_count = resampler_output_count(resampler, count);
+	const ptrdiff_t first = 1 - (ptrdiff_t)resampler->taps / 2;
+
+	// output n sits at input position n * down / up; step it exactly
+	size_t base = 0;
+	unsigned int rem = 0;
+
+	for (size_t n = 0; n < out_count; ++n)
+	{
+		const unsigned int phase = resampler->phases == resampler->up
+			? rem
+			: (unsigned int)((Uint64)rem * resampler->phases / resampler->up);
+		const float *filter = &resampler->bank[phase * resampler->taps];
+
+		const ptrdiff_t start = (ptrdiff_t)base + first;
+
+		float acc = 0;
+		if (start >= 0 && start + (ptrdiff_t)resampler->taps <= (ptrdiff_t)count)
+		{
+			const Sint16 *src = &in[start];
+			for (unsigned int k = 0; k < resampler->taps; ++k)
+				acc += filter[k] * src[k];
+		}
+		else
+		{
+			// the ends; everything outside the input is silence
+			for (unsigned int k = 0; k < resampler->taps; ++k)
+			{
+				const ptrdiff_t i = start + (ptrdiff_t)k;
+				if (i >= 0 && i < (ptrdiff_t)count)
+					acc += filter[k] * in[i];
+			}
+		}
+
+		const long sample = lrintf(acc);
+		out[n] = MIN(MAX(INT16_MIN, sample), INT16_MAX);
+
+		rem += resampler->down;
+		while (rem >= resampler->up)
+		{
+			rem -= resampler->up;
+			base += 1;
+		}
+	}
+}
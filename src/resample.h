@@ -0,0 +1,39 @@
+/*
+ * Tyrian 3000: Polyphase Resampler
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#ifndef RESAMPLE_H
+#define RESAMPLE_H
+
+#include "opentyr.h"
+
+#include "SDL.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct
+{
+	unsigned int up, down;  // output/input rate ratio, reduced
+	unsigned int phases;    // filters in the bank; `up` unless that is too many
+	unsigned int taps;      // per filter
+	float *bank;            // phases * taps
+} Resampler;
+
+/* Builds the windowed-sinc filter bank for converting `in_rate` to `out_rate`. */
+bool resampler_init(Resampler *resampler, int in_rate, int out_rate);
+
+void resampler_free(Resampler *resampler);
+
+/* The number of output samples for `count` input samples. */
+size_t resampler_output_count(const Resampler *resampler, size_t count);
+
+/* Resamples mono 16-bit audio.  `out` must hold resampler_output_count(count). */
+void resampler_run(const Resampler *resampler, const Sint16 *in, size_t count, Sint16 *out);
+
+#endif /* RESAMPLE_H */
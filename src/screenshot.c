@@ -0,0 +1,283 @@
+/*
+ * Tyrian 3000: Screenshot Encoder
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#include "screenshot.h"
+
+#include "palette.h"
+#include "video.h"
+
+#include "SDL_image.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef PATH_MAX
+#define PATH_MAX 4096
+#endif
+
+#define SCREENSHOT_QUEUE_SIZE 4
+
+typedef enum
+{
+	JOB_FREE = 0,
+	JOB_QUEUED,
+	JOB_ENCODING,
+	JOB_DONE
+} JobState;
+
+typedef struct
+{
+	JobState state;
+	Uint32 id;
+	Uint32 owner;
+	bool ok;
+
+	int w, h;
+	Uint8 pixels[vga_width * vga_height];
+	SDL_Color palette[256];
+	char path[PATH_MAX];
+} ScreenshotJob;
+
+static ScreenshotJob jobs[SCREENSHOT_QUEUE_SIZE];
+static Uint32 next_job_id = 1;
+
+static SDL_Thread *encoder_thread = NULL;
+static SDL_mutex *jobs_mutex = NULL;
+static SDL_cond *jobs_cond = NULL;
+static bool encoder_quit = false;
+
+static bool has_suffix(const char *path, const char *suffix)
+{
+	const size_t path_len = strlen(path);
+	const size_t suffix_len = strlen(suffix);
+
+	return path_len >= suffix_len && SDL_strcasecmp(path + path_len - suffix_len, suffix) == 0;
+}
+
+/* Runs without the queue lock; the job is owned by the caller while JOB_ENCODING. */
+static bool encode_job(ScreenshotJob *job)
+{
+	SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom(job->pixels, job->w, job->h, 8, job->w, SDL_PIXELFORMAT_INDEX8);
+	if (surface == NULL)
+		return false;
+
+	SDL_SetPaletteColors(surface->format->palette, job->palette, 0, COUNTOF(job->palette));
+
+	// write beside the target and rename, so readers never see a partial file
+	char temp_path[PATH_MAX + 8];
+	snprintf(temp_path, sizeof(temp_path), "%s.tmp", job->path);
+
+	const int result = has_suffix(job->path, ".bmp")
+		? SDL_SaveBMP(surface, temp_path)
+		: IMG_SavePNG(surface, temp_path);
+	SDL_FreeSurface(surface);
+
+	if (result != 0)
+	{
+		fprintf(stderr, "warning: failed to save screenshot '%s': %s\n", job->path, SDL_GetError());
+		remove(temp_path);
+		return false;
+	}
+
+	if (rename(temp_path, job->path) != 0)
+	{
+		remove(temp_path);
+		return false;
+	}
+
+	return true;
+}
+
+static ScreenshotJob *oldest_job(JobState state)
+{
+	ScreenshotJob *oldest = NULL;
+	for (uint i = 0; i < COUNTOF(jobs); ++i)
+	{
+		if (jobs[i].state == state && (oldest == NULL || (Sint32)(jobs[i].id - oldest->id) < 0))
+			oldest = &jobs[i];
+	}
+	return oldest;
+}
+
+static int SDLCALL encoder_main(void *data)
+{
+	(void)data;
+
+	SDL_LockMutex(jobs_mutex);
+	for (;;)
+	{
+		ScreenshotJob *job = oldest_job(JOB_QUEUED);
+		if (job == NULL)
+		{
+			if (encoder_quit)
+				break;
+
+			SDL_CondWait(jobs_cond, jobs_mutex);
+			continue;
+		}
+
+		job->state = JOB_ENCODING;
+		SDL_UnlockMutex(jobs_mutex);
+
+		const bool ok = encode_job(job);
+
+		SDL_LockMutex(jobs_mutex);
+		job->ok = ok;
+		job->state = JOB_DONE;
+	}
+	SDL_UnlockMutex(jobs_mutex);
+
+	return 0;
+}
+
+bool screenshot_init(void)
+{
+	if (jobs_mutex != NULL)
+		return true;
+
+	for (uint i = 0; i < COUNTOF(jobs); ++i)
+		jobs[i].state = JOB_FREE;
+
+	jobs_mutex = SDL_CreateMutex();
+	jobs_cond = SDL_CreateCond();
+	if (jobs_mutex == NULL || jobs_cond == NULL)
+	{
+		fprintf(stderr, "warning: failed to create screenshot queue: %s\n", SDL_GetError());
+		screenshot_shutdown();
+		return false;
+	}
+
+	encoder_quit = false;
+	encoder_thread = SDL_CreateThread(encoder_main, "screenshot", NULL);
+	if (encoder_thread == NULL)
+		fprintf(stderr, "warning: screenshots will be encoded synchronously: %s\n", SDL_GetError());
+
+	return true;
+}
+
+void screenshot_shutdown(void)
+{
+	if (encoder_thread != NULL)
+	{
+		// the encoder drains queued jobs before exiting
+		SDL_LockMutex(jobs_mutex);
+		encoder_quit = true;
+		SDL_CondSignal(jobs_cond);
+		SDL_UnlockMutex(jobs_mutex);
+
+		SDL_WaitThread(encoder_thread, NULL);
+		encoder_thread = NULL;
+	}
+
+	if (jobs_cond != NULL)
+	{
+		SDL_DestroyCond(jobs_cond);
+		jobs_cond = NULL;
+	}
+	if (jobs_mutex != NULL)
+	{
+		SDL_DestroyMutex(jobs_mutex);
+		jobs_mutex = NULL;
+	}
+}
+
+Uint32 screenshot_queue(SDL_Surface *surface, const char *path, Uint32 owner)
+{
+	if (jobs_mutex == NULL || surface == NULL || path == NULL || path[0] == '\0')
+		return 0;
+
+	if (surface->format->BytesPerPixel != 1 || surface->w > vga_width || surface->h > vga_height)
+		return 0;
+
+	SDL_LockMutex(jobs_mutex);
+
+	ScreenshotJob *job = NULL;
+	for (uint i = 0; i < COUNTOF(jobs); ++i)
+	{
+		if (jobs[i].state == JOB_FREE)
+		{
+			job = &jobs[i];
+			break;
+		}
+	}
+
+	if (job == NULL)
+	{
+		SDL_UnlockMutex(jobs_mutex);
+		return 0;
+	}
+
+	job->id = next_job_id++;
+	if (next_job_id == 0)
+		next_job_id = 1;
+	job->owner = owner;
+	job->ok = false;
+	job->w = surface->w;
+	job->h = surface->h;
+	SDL_strlcpy(job->path, path, sizeof(job->path));
+	memcpy(job->palette, colors, sizeof(job->palette));
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_LockSurface(surface);
+
+	if (surface->pitch == surface->w)
+	{
+		memcpy(job->pixels, surface->pixels, (size_t)surface->w * surface->h);
+	}
+	else
+	{
+		for (int y = 0; y < surface->h; ++y)
+			memcpy(job->pixels + y * surface->w, (const Uint8 *)surface->pixels + y * surface->pitch, (size_t)surface->w);
+	}
+
+	if (SDL_MUSTLOCK(surface))
+		SDL_UnlockSurface(surface);
+
+	const Uint32 id = job->id;
+
+	if (encoder_thread != NULL)
+	{
+		job->state = JOB_QUEUED;
+		SDL_CondSignal(jobs_cond);
+		SDL_UnlockMutex(jobs_mutex);
+	}
+	else
+	{
+		job->state = JOB_ENCODING;
+		SDL_UnlockMutex(jobs_mutex);
+
+		job->ok = encode_job(job);
+		job->state = JOB_DONE;
+	}
+
+	return id;
+}
+
+bool screenshot_poll_done(Uint32 *out_id, Uint32 *out_owner, bool *out_ok, char *out_path, size_t out_path_size)
+{
+	if (jobs_mutex == NULL)
+		return false;
+
+	SDL_LockMutex(jobs_mutex);
+
+	ScreenshotJob *job = oldest_job(JOB_DONE);
+	if (job != NULL)
+	{
+		*out_id = job->id;
+		*out_owner = job->owner;
+		*out_ok = job->ok;
+		SDL_strlcpy(out_path, job->path, out_path_size);
+		job->state = JOB_FREE;
+	}
+
+	SDL_UnlockMutex(jobs_mutex);
+
+	return job != NULL;
+}
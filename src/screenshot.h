@@ -0,0 +1,31 @@
+/*
+ * Tyrian 3000: Screenshot Encoder
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#ifndef SCREENSHOT_H
+#define SCREENSHOT_H
+
+#include "opentyr.h"
+
+#include "SDL.h"
+
+#include <stdbool.h>
+
+/* Background encoder lifecycle.  Without a thread, jobs are encoded synchronously. */
+bool screenshot_init(void);
+void screenshot_shutdown(void);
+
+/* Copies an 8-bit frame and the current palette into the encode queue.  Files ending
+   in ".bmp" are written as 8-bit BMP, anything else as indexed PNG.  Returns a nonzero
+   job id, or 0 if the frame is unusable or the queue is full. */
+Uint32 screenshot_queue(SDL_Surface *surface, const char *path, Uint32 owner);
+
+/* Pops one finished job; returns false when none are ready. */
+bool screenshot_poll_done(Uint32 *out_id, Uint32 *out_owner, bool *out_ok, char *out_path, size_t out_path_size);
+
+#endif /* SCREENSHOT_H */
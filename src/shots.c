@@ -23,92 +23,104 @@
 #include "video.h"
 #include "varz.h"
 
+#include <string.h>
+
 // I'm pretty sure the last extra entry is never used.
 PlayerShotDataType playerShotData[MAX_PWEAPON + 1]; /* [1..MaxPWeapon+1] */
 JE_byte shotAvail[MAX_PWEAPON]; /* [1..MaxPWeapon] */   /*0:Avail 1-255:Duration left*/
+SlotPool playerShotPool;  /* shotAvail != 0 */
+
+void player_shot_set_avail(int shot_id, JE_byte duration)
+{
+	shotAvail[shot_id] = duration;
+	slot_pool_set(&playerShotPool, shot_id, duration != 0);
+}
+
+void player_shot_free_all(void)
+{
+	memset(shotAvail, 0, sizeof(shotAvail));
+	slot_pool_clear(&playerShotPool);
+}
 
 void simulate_player_shots(void)
 {
 	/* Player Shot Images */
-	for (int z = 0; z < MAX_PWEAPON; z++)
+	for (int z = slot_pool_next_live(&playerShotPool, 0, MAX_PWEAPON); z < MAX_PWEAPON; z = slot_pool_next_live(&playerShotPool, z + 1, MAX_PWEAPON))
 	{
-		if (shotAvail[z] != 0)
+		player_shot_set_avail(z, shotAvail[z] - 1);
+		if (z != MAX_PWEAPON - 1)
 		{
-			shotAvail[z]--;
-			if (z != MAX_PWEAPON - 1)
-			{
-				PlayerShotDataType* shot = &playerShotData[z];
+			PlayerShotDataType* shot = &playerShotData[z];
 
-				shot->shotXM += shot->shotXC;
+			shot->shotXM += shot->shotXC;
 
-				if (shot->shotXM <= 100)
-					shot->shotX += shot->shotXM;
+			if (shot->shotXM <= 100)
+				shot->shotX += shot->shotXM;
 
-				shot->shotYM += shot->shotYC;
-				shot->shotY += shot->shotYM;
+			shot->shotYM += shot->shotYC;
+			shot->shotY += shot->shotYM;
 
-				if (shot->shotYM > 100)
-				{
-					shot->shotY -= 120;
-					shot->shotY += player[0].delta_y_shot_move;
-				}
+			if (shot->shotYM > 100)
+			{
+				shot->shotY -= 120;
+				shot->shotY += player[0].delta_y_shot_move;
+			}
 
-				if (shot->shotComplicated != 0)
-				{
-					shot->shotDevX += shot->shotDirX;
-					shot->shotX += shot->shotDevX;
+			if (shot->shotComplicated != 0)
+			{
+				shot->shotDevX += shot->shotDirX;
+				shot->shotX += shot->shotDevX;
 
-					if (abs(shot->shotDevX) == shot->shotCirSizeX)
-						shot->shotDirX = -shot->shotDirX;
+				if (abs(shot->shotDevX) == shot->shotCirSizeX)
+					shot->shotDirX = -shot->shotDirX;
 
-					shot->shotDevY += shot->shotDirY;
-					shot->shotY += shot->shotDevY;
+				shot->shotDevY += shot->shotDirY;
+				shot->shotY += shot->shotDevY;
 
-					if (abs(shot->shotDevY) == shot->shotCirSizeY)
-						shot->shotDirY = -shot->shotDirY;
-					/*Double Speed Circle Shots - add a second copy of above loop*/
-				}
+				if (abs(shot->shotDevY) == shot->shotCirSizeY)
+					shot->shotDirY = -shot->shotDirY;
+				/*Double Speed Circle Shots - add a second copy of above loop*/
+			}
 
-				int tempShotX = shot->shotX;
-				int tempShotY = shot->shotY;
+			int tempShotX = shot->shotX;
+			int tempShotY = shot->shotY;
 
-				if (shot->shotX < 0 || shot->shotX > 140 ||
-				    shot->shotY < 0 || shot->shotY > 170)
-				{
-					shotAvail[z] = 0;
-					goto draw_player_shot_loop_end;
-				}
+			if (shot->shotX < 0 || shot->shotX > 140 ||
+			    shot->shotY < 0 || shot->shotY > 170)
+			{
+				player_shot_set_avail(z, 0);
+				goto draw_player_shot_loop_end;
+			}
 
 /*				if (shot->shotTrail != 255)
+			{
+				if (shot->shotTrail == 98)
 				{
-					if (shot->shotTrail == 98)
-					{
-						JE_setupExplosion(shot->shotX - shot->shotXM, shot->shotY - shot->shotYM, shot->shotTrail);
-					}
-					else
-					{
-						JE_setupExplosion(shot->shotX, shot->shotY, shot->shotTrail);
-					}
-				}*/
-
-				JE_word anim_frame = shot->shotGr + shot->shotAni;
-				if (++shot->shotAni == shot->shotAniMax)
-					shot->shotAni = 0;
-
-				if (anim_frame < 60000)
+					JE_setupExplosion(shot->shotX - shot->shotXM, shot->shotY - shot->shotYM, shot->shotTrail);
+				}
+				else
 				{
-					if (anim_frame > 1000)
-						anim_frame = anim_frame % 1000;
-					if (anim_frame > 500)
-						blit_sprite2(VGAScreen, tempShotX+1, tempShotY, spriteSheet12, anim_frame - 500);
-					else
-						blit_sprite2(VGAScreen, tempShotX+1, tempShotY, spriteSheet8, anim_frame);
+					JE_setupExplosion(shot->shotX, shot->shotY, shot->shotTrail);
 				}
+			}*/
+
+			JE_word anim_frame = shot->shotGr + shot->shotAni;
+			if (++shot->shotAni == shot->shotAniMax)
+				shot->shotAni = 0;
+
+			if (anim_frame < 60000)
+			{
+				if (anim_frame > 1000)
+					anim_frame = anim_frame % 1000;
+				if (anim_frame > 500)
+					blit_sprite2(VGAScreen, tempShotX+1, tempShotY, spriteSheet12, anim_frame - 500);
+				else
+					blit_sprite2(VGAScreen, tempShotX+1, tempShotY, spriteSheet8, anim_frame);
 			}
+		}
 
 draw_player_shot_loop_end:
-			;
-		}
+		;
 	}
 }
 
@@ -168,7 +180,7 @@ bool player_shot_move_and_draw(
 {
 	PlayerShotDataType* shot = &playerShotData[shot_id];
 
-	shotAvail[shot_id]--;
+	player_shot_set_avail(shot_id, shotAvail[shot_id] - 1);
 	if (shot_id != MAX_PWEAPON - 1)
 	{
 		shot->shotXM += shot->shotXC;
@@ -222,7 +234,7 @@ bool player_shot_move_and_draw(
 		if (shot->shotX < -34 || shot->shotX > 290 ||
 			shot->shotY < -15 || shot->shotY > 190)
 		{
-			shotAvail[shot_id] = 0;
+			player_shot_set_avail(shot_id, 0);
 			return false;
 		}
 
@@ -326,9 +338,7 @@ JE_integer player_shot_create(JE_word portNum, uint bay_i, JE_word PX, JE_word P
 	/*Rot*/
 	for (int multi_i = 1; multi_i <= weapon->multi; multi_i++)
 	{
-		for (shot_id = 0; shot_id < MAX_PWEAPON; shot_id++)
-			if (shotAvail[shot_id] == 0)
-				break;
+		shot_id = slot_pool_next_free(&playerShotPool, 0, MAX_PWEAPON);
 		if (shot_id == MAX_PWEAPON)
 			return MAX_PWEAPON;
 
@@ -423,10 +433,7 @@ JE_integer player_shot_create(JE_word portNum, uint bay_i, JE_word PX, JE_word P
 		}
 
 		shot->shotGr = weapon->sg[shotMultiPos[bay_i]-1];
-		if (shot->shotGr == 0)
-			shotAvail[shot_id] = 0;
-		else
-			shotAvail[shot_id] = del;
+		player_shot_set_avail(shot_id, shot->shotGr == 0 ? 0 : del);
 
 		if (del > 100 && del < 120)
 			shot->shotAniMax = (del - 100 + 1);
@@ -480,9 +487,9 @@ JE_integer player_shot_create(JE_word portNum, uint bay_i, JE_word PX, JE_word P
 			uint best_dist = 65000;
 			JE_byte closest_enemy = 0;
 			/*Find Closest Enemy*/
-			for (x = 0; x < 100; x++)
+			for (x = slot_pool_next_live(&enemyPool, 0, 100); x < 100; x = slot_pool_next_live(&enemyPool, x + 1, 100))
 			{
-				if (enemyAvail[x] != 1 && !enemy[x].scoreitem)
+				if (!enemy[x].scoreitem)
 				{
 					y = abs(enemy[x].ex - shot->shotX) + abs(enemy[x].ey - shot->shotY);
 					if (y < best_dist)
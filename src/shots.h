@@ -19,6 +19,7 @@
 #ifndef SHOTS_H
 #define SHOTS_H
 #include "opentyr.h"
+#include "slot_pool.h"
 
 typedef struct {
 	JE_integer shotX, shotY, shotXM, shotYM, shotXC, shotYC;
@@ -33,6 +34,13 @@ typedef struct {
 #define MAX_PWEAPON     81 /* 81*/
 extern PlayerShotDataType playerShotData[MAX_PWEAPON + 1];
 extern JE_byte shotAvail[MAX_PWEAPON];
+extern SlotPool playerShotPool;
+
+/** Sets how many frames a shot has left; 0 frees it. Keeps playerShotPool in step with shotAvail. */
+void player_shot_set_avail(int shot_id, JE_byte duration);
+
+/** Frees every player shot. */
+void player_shot_free_all(void);
 
 /** Used in the shop to show weapon previews. */
 void simulate_player_shots(void);
@@ -0,0 +1,102 @@
+/*
+ * Tyrian 3000: Object Slot Pools
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#ifndef SLOT_POOL_H
+#define SLOT_POOL_H
+
+#include "opentyr.h"
+
+#include "SDL.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#define SLOT_POOL_MAX   256
+#define SLOT_POOL_WORDS (SLOT_POOL_MAX / 32)
+
+/* Tracks which slots of a fixed array of game objects (enemies, shots, explosions)
+   are in use, one bit per slot.  The owning array stays where it is; the pool only
+   answers "lowest free slot" and "next live slot" a word at a time instead of by
+   testing every entry.
+
+   Both answers come out in slot order, exactly as the linear scans they replace,
+   so the same slots are taken and objects are updated in the same order.  Demos
+   and netplay depend on that: a free list handing out the most recently freed slot
+   would change which object draws over which and when mt_rand is called. */
+typedef struct
+{
+	Uint32 live[SLOT_POOL_WORDS];
+} SlotPool;
+
+static inline unsigned int slot_pool_lowest_bit(Uint32 word)
+{
+#if defined(__GNUC__)
+	return __builtin_ctz(word);
+#else
+	unsigned int bit = 0;
+	while ((word & 1) == 0)
+	{
+		word >>= 1;
+		++bit;
+	}
+	return bit;
+#endif
+}
+
+static inline void slot_pool_clear(SlotPool *pool)
+{
+	memset(pool->live, 0, sizeof(pool->live));
+}
+
+static inline bool slot_pool_is_live(const SlotPool *pool, unsigned int slot)
+{
+	return (pool->live[slot / 32] >> (slot % 32)) & 1;
+}
+
+static inline void slot_pool_set(SlotPool *pool, unsigned int slot, bool live)
+{
+	if (live)
+		pool->live[slot / 32] |= 1u << (slot % 32);
+	else
+		pool->live[slot / 32] &= ~(1u << (slot % 32));
+}
+
+/* Returns the lowest live slot in [slot, end), or end if there is none. */
+static inline unsigned int slot_pool_next_live(const SlotPool *pool, unsigned int slot, unsigned int end)
+{
+	while (slot < end)
+	{
+		const Uint32 word = pool->live[slot / 32] >> (slot % 32);
+		if (word != 0)
+		{
+			slot += slot_pool_lowest_bit(word);
+			return slot < end ? slot : end;
+		}
+		slot = (slot / 32 + 1) * 32;
+	}
+	return end;
+}
+
+/* Returns the lowest free slot in [slot, end), or end if there is none. */
+static inline unsigned int slot_pool_next_free(const SlotPool *pool, unsigned int slot, unsigned int end)
+{
+	while (slot < end)
+	{
+		const Uint32 word = ~pool->live[slot / 32] >> (slot % 32);
+		if (word != 0)
+		{
+			slot += slot_pool_lowest_bit(word);
+			return slot < end ? slot : end;
+		}
+		slot = (slot / 32 + 1) * 32;
+	}
+	return end;
+}
+
+#endif /* SLOT_POOL_H */
@@ -20,10 +20,12 @@
 
 #include "file.h"
 #include "opentyr.h"
+#include "varz.h"
 #include "video.h"
 
 #include <assert.h>
 #include <ctype.h>
+#include <stdio.h>
 #include <stdlib.h>
 
 Sprite_array sprite_table[SPRITE_TABLES_MAX];
@@ -35,6 +37,20 @@ Sprite2_array explosionSpriteSheet;
 Sprite2_array enemySpriteSheets[4];
 Uint8 enemySpriteSheetIds[4];
 
+#define ENEMY_SHEET_CACHE_SLOTS 36
+
+size_t enemySheetCacheBudget = 1024 * 1024;
+
+// Recently used enemy sheets, keyed by shape file letter, so level restarts and
+// levels sharing banks don't go back to disk.
+static struct
+{
+	char letter;  // 0 if slot is unused
+	FileView view;
+	Uint32 last_used;
+} enemy_sheet_cache[ENEMY_SHEET_CACHE_SLOTS];
+static Uint32 enemy_sheet_cache_clock = 0;
+
 Sprite2_array destructSpriteSheet;
 
 Sprite2_array spriteSheet8;
@@ -46,23 +62,28 @@ Sprite2_array spriteSheetT2000;
 
 void load_sprites_file(unsigned int table, const char *filename)
 {
-	free_sprites(table);
-	
-	FILE *f = dir_fopen_die(data_dir(), filename, "rb");
+	const FileView view = dir_map_die(data_dir(), filename);
 	
-	load_sprites(table, f);
-	
-	fclose(f);
+	load_sprites(table, view.data, view.size);
+}
+
+static void sprites_truncated_die(void)
+{
+	fprintf(stderr, "error: sprite data is truncated\n");
+	JE_tyrianHalt(1);
 }
 
-void load_sprites(unsigned int table, FILE *f)
+// sprites point into the mapped file; nothing is copied
+void load_sprites(unsigned int table, const Uint8 *data, size_t size)
 {
 	free_sprites(table);
 	
-	Uint16 temp;
-	fread_u16_die(&temp, 1, f);
+	const Uint8 * const data_end = data + size;
 	
-	sprite_table[table].count = temp;
+	if (data_end - data < 2)
+		sprites_truncated_die();
+	sprite_table[table].count = view_read_u16(data);
+	data += 2;
 	
 	assert(sprite_table[table].count <= SPRITES_PER_TABLE_MAX);
 	
@@ -70,18 +91,23 @@ void load_sprites(unsigned int table, FILE *f)
 	{
 		Sprite * const cur_sprite = sprite(table, i);
 
-		bool populated;
-		fread_bool_die(&populated, f);
+		if (data_end - data < 1)
+			sprites_truncated_die();
+		const bool populated = *data++ != 0;
 		if (!populated) // sprite is empty
 			continue;
 		
-		fread_u16_die(&cur_sprite->width,  1, f);
-		fread_u16_die(&cur_sprite->height, 1, f);
-		fread_u16_die(&cur_sprite->size,   1, f);
+		if (data_end - data < 6)
+			sprites_truncated_die();
+		cur_sprite->width  = view_read_u16(data);
+		cur_sprite->height = view_read_u16(data + 2);
+		cur_sprite->size   = view_read_u16(data + 4);
+		data += 6;
 		
-		cur_sprite->data = malloc(cur_sprite->size);
-		
-		fread_u8_die(cur_sprite->data, cur_sprite->size, f);
+		if (data_end - data < cur_sprite->size)
+			sprites_truncated_die();
+		cur_sprite->data = data;
+		data += cur_sprite->size;
 	}
 }
 
@@ -95,8 +121,7 @@ void free_sprites(unsigned int table)
 		cur_sprite->height = 0;
 		cur_sprite->size   = 0;
 		
-		free(cur_sprite->data);
-		cur_sprite->data = NULL;
+		cur_sprite->data = NULL;  // owned by the file mapping
 	}
 	
 	sprite_table[table].count = 0;
@@ -489,27 +514,110 @@ void JE_loadCompShapes(Sprite2_array *sprite2s, char s)
 	char buffer[20];
 	snprintf(buffer, sizeof(buffer), "newsh%c.shp", tolower((unsigned char)s));
 	
-	FILE *f = dir_fopen_die(data_dir(), buffer, "rb");
-	
-	sprite2s->size = ftell_eof(f);
+	const FileView view = dir_map_die(data_dir(), buffer);
 	
-	JE_loadCompShapesB(sprite2s, f);
-	
-	fclose(f);
+	sprite2s->data = view.data;
+	sprite2s->size = view.size;
 }
 
-void JE_loadCompShapesB(Sprite2_array *sprite2s, FILE *f)
+static bool enemy_sheet_in_use(const FileView *view)
 {
-	assert(sprite2s->data == NULL);
+	for (uint i = 0; i < COUNTOF(enemySpriteSheets); ++i)
+		if (enemySpriteSheets[i].data == view->data)
+			return true;
+	return false;
+}
 
-	sprite2s->data = malloc(sprite2s->size);
-	fread_u8_die(sprite2s->data, sprite2s->size, f);
+// evict least recently used sheets that aren't bound to a bank until under budget
+static void trim_enemy_sheet_cache(void)
+{
+	for (; ; )
+	{
+		size_t total = 0;
+		int lru = -1;
+
+		for (uint i = 0; i < COUNTOF(enemy_sheet_cache); ++i)
+		{
+			if (enemy_sheet_cache[i].letter == 0)
+				continue;
+
+			total += enemy_sheet_cache[i].view.size;
+
+			if (!enemy_sheet_in_use(&enemy_sheet_cache[i].view) &&
+			    (lru < 0 || (Sint32)(enemy_sheet_cache[i].last_used - enemy_sheet_cache[lru].last_used) < 0))
+				lru = i;
+		}
+
+		if (total <= enemySheetCacheBudget || lru < 0)
+			break;
+
+		file_view_release(&enemy_sheet_cache[lru].view);
+		enemy_sheet_cache[lru].letter = 0;
+	}
+}
+
+void load_enemy_sprite2s(Sprite2_array *sprite2s, char s)
+{
+	const char letter = tolower((unsigned char)s);
+
+	free_sprite2s(sprite2s);
+
+	int slot = -1;
+	for (uint i = 0; i < COUNTOF(enemy_sheet_cache); ++i)
+	{
+		if (enemy_sheet_cache[i].letter == letter)
+		{
+			slot = i;
+			break;
+		}
+	}
+
+	if (slot < 0)
+	{
+		trim_enemy_sheet_cache();
+
+		for (uint i = 0; i < COUNTOF(enemy_sheet_cache); ++i)
+		{
+			if (enemy_sheet_cache[i].letter == 0)
+			{
+				slot = i;
+				break;
+			}
+		}
+		assert(slot >= 0);  // more slots than shape files
+
+		char buffer[20];
+		snprintf(buffer, sizeof(buffer), "newsh%c.shp", letter);
+
+		if (!dir_map(data_dir(), buffer, &enemy_sheet_cache[slot].view))
+			JE_tyrianHalt(1);
+
+		enemy_sheet_cache[slot].letter = letter;
+	}
+
+	enemy_sheet_cache[slot].last_used = ++enemy_sheet_cache_clock;
+
+	sprite2s->data = enemy_sheet_cache[slot].view.data;
+	sprite2s->size = enemy_sheet_cache[slot].view.size;
+
+	trim_enemy_sheet_cache();
+}
+
+void free_enemy_sheet_cache(void)
+{
+	for (uint i = 0; i < COUNTOF(enemySpriteSheets); ++i)
+		free_sprite2s(&enemySpriteSheets[i]);
+
+	for (uint i = 0; i < COUNTOF(enemy_sheet_cache); ++i)
+	{
+		file_view_release(&enemy_sheet_cache[i].view);
+		enemy_sheet_cache[i].letter = 0;
+	}
 }
 
 void free_sprite2s(Sprite2_array *sprite2s)
 {
-	free(sprite2s->data);
-	sprite2s->data = NULL;
+	sprite2s->data = NULL;  // owned by the file mapping
 
 	sprite2s->size = 0;
 }
@@ -522,7 +630,7 @@ void blit_sprite2(SDL_Surface *surface, int x, int y, Sprite2_array sprite2s, un
 	const Uint8 * const pixels_ll = (Uint8 *)surface->pixels,  // lower limit
 	            * const pixels_ul = (Uint8 *)surface->pixels + (surface->h * surface->pitch);  // upper limit
 	
-	const Uint8 *data = sprite2s.data + SDL_SwapLE16(((Uint16 *)sprite2s.data)[index - 1]);
+	const Uint8 *data = sprite2s.data + view_read_u16(sprite2s.data + (index - 1) * 2);
 	
 	for (; *data != 0x0f; ++data)
 	{
@@ -554,7 +662,7 @@ void blit_sprite2_clip(SDL_Surface *surface, int x, int y, Sprite2_array sprite2
 {
 	assert(surface->format->BitsPerPixel == 8);
 
-	const Uint8 *data = sprite2s.data + SDL_SwapLE16(((Uint16 *)sprite2s.data)[index - 1]);
+	const Uint8 *data = sprite2s.data + view_read_u16(sprite2s.data + (index - 1) * 2);
 
 	for (; *data != 0x0f; ++data)
 	{
@@ -599,7 +707,7 @@ void blit_sprite2_blend(SDL_Surface *surface,  int x, int y, Sprite2_array sprit
 	const Uint8 * const pixels_ll = (Uint8 *)surface->pixels,  // lower limit
 	            * const pixels_ul = (Uint8 *)surface->pixels + (surface->h * surface->pitch);  // upper limit
 	
-	const Uint8 *data = sprite2s.data + SDL_SwapLE16(((Uint16 *)sprite2s.data)[index - 1]);
+	const Uint8 *data = sprite2s.data + view_read_u16(sprite2s.data + (index - 1) * 2);
 	
 	for (; *data != 0x0f; ++data)
 	{
@@ -635,7 +743,7 @@ void blit_sprite2_darken(SDL_Surface *surface, int x, int y, Sprite2_array sprit
 	const Uint8 * const pixels_ll = (Uint8 *)surface->pixels,  // lower limit
 	            * const pixels_ul = (Uint8 *)surface->pixels + (surface->h * surface->pitch);  // upper limit
 	
-	const Uint8 *data = sprite2s.data + SDL_SwapLE16(((Uint16 *)sprite2s.data)[index - 1]);
+	const Uint8 *data = sprite2s.data + view_read_u16(sprite2s.data + (index - 1) * 2);
 	
 	for (; *data != 0x0f; ++data)
 	{
@@ -671,7 +779,7 @@ void blit_sprite2_filter(SDL_Surface *surface, int x, int y, Sprite2_array sprit
 	const Uint8 * const pixels_ll = (Uint8 *)surface->pixels,  // lower limit
 	            * const pixels_ul = (Uint8 *)surface->pixels + (surface->h * surface->pitch);  // upper limit
 	
-	const Uint8 *data = sprite2s.data + SDL_SwapLE16(((Uint16 *)sprite2s.data)[index - 1]);
+	const Uint8 *data = sprite2s.data + view_read_u16(sprite2s.data + (index - 1) * 2);
 	
 	for (; *data != 0x0f; ++data)
 	{
@@ -703,7 +811,7 @@ void blit_sprite2_filter_clip(SDL_Surface *surface, int x, int y, Sprite2_array
 {
 	assert(surface->format->BitsPerPixel == 8);
 
-	const Uint8 *data = sprite2s.data + SDL_SwapLE16(((Uint16 *)sprite2s.data)[index - 1]);
+	const Uint8 *data = sprite2s.data + view_read_u16(sprite2s.data + (index - 1) * 2);
 
 	for (; *data != 0x0f; ++data)
 	{
@@ -792,62 +900,67 @@ void blit_sprite2x2_filter_clip(SDL_Surface *surface, int x, int y, Sprite2_arra
 	blit_sprite2_filter_clip(surface, x + 12, y + 14, sprite2s, index + 20, filter);
 }
 
+static void set_sprite2s(Sprite2_array *sprite2s, const FileView *view, JE_longint begin, JE_longint end)
+{
+	if (begin < 0 || end < begin || (size_t)end > view->size)
+		sprites_truncated_die();
+
+	sprite2s->data = view->data + begin;
+	sprite2s->size = end - begin;
+}
+
 void JE_loadMainShapeTables(const char *shpfile)
 {
 	enum { SHP_NUM = 13 };
 	
-	FILE *f = dir_fopen_die(data_dir(), shpfile, "rb");
+	const FileView view = dir_map_die(data_dir(), shpfile);
 	
-	JE_word shpNumb;
 	JE_longint shpPos[SHP_NUM + 1]; // +1 for storing file length
 	
-	fread_u16_die(&shpNumb, 1, f);
+	if (view.size < 2)
+		sprites_truncated_die();
+	const JE_word shpNumb = view_read_u16(view.data);
 	assert(shpNumb + 1u == COUNTOF(shpPos));
 	
-	fread_s32_die(shpPos, shpNumb, f);
+	if (view.size < 2 + shpNumb * 4u)
+		sprites_truncated_die();
+	for (unsigned int i = 0; i < shpNumb; ++i)
+		shpPos[i] = (Sint32)view_read_u32(view.data + 2 + i * 4);
 	
-	fseek(f, 0, SEEK_END);
 	for (unsigned int i = shpNumb; i < COUNTOF(shpPos); ++i)
-		shpPos[i] = ftell(f);
+		shpPos[i] = view.size;
 	
 	int i;
 	// fonts, interface, option sprites
 	for (i = 0; i < 7; i++)
 	{
-		fseek(f, shpPos[i], SEEK_SET);
-		load_sprites(i, f);
+		if (shpPos[i] < 0 || (size_t)shpPos[i] > view.size)
+			sprites_truncated_die();
+		load_sprites(i, view.data + shpPos[i], view.size - shpPos[i]);
 	}
 	
 	// player shot sprites
-	spriteSheet8.size = shpPos[i + 1] - shpPos[i];
-	JE_loadCompShapesB(&spriteSheet8, f);
+	set_sprite2s(&spriteSheet8, &view, shpPos[i], shpPos[i + 1]);
 	i++;
 	
 	// player ship sprites
-	spriteSheet9.size = shpPos[i + 1] - shpPos[i];
-	JE_loadCompShapesB(&spriteSheet9 , f);
+	set_sprite2s(&spriteSheet9, &view, shpPos[i], shpPos[i + 1]);
 	i++;
 	
 	// power-up sprites
-	spriteSheet10.size = shpPos[i + 1] - shpPos[i];
-	JE_loadCompShapesB(&spriteSheet10, f);
+	set_sprite2s(&spriteSheet10, &view, shpPos[i], shpPos[i + 1]);
 	i++;
 	
 	// coins, datacubes, etc sprites
-	spriteSheet11.size = shpPos[i + 1] - shpPos[i];
-	JE_loadCompShapesB(&spriteSheet11, f);
+	set_sprite2s(&spriteSheet11, &view, shpPos[i], shpPos[i + 1]);
 	i++;
 	
 	// more player shot sprites
-	spriteSheet12.size = shpPos[i + 1] - shpPos[i];
-	JE_loadCompShapesB(&spriteSheet12, f);
+	set_sprite2s(&spriteSheet12, &view, shpPos[i], shpPos[i + 1]);
 	i++;
 
 	// tyrian 2000 ship sprites
-	spriteSheetT2000.size = shpPos[i + 1] - shpPos[i];
-	JE_loadCompShapesB(&spriteSheetT2000, f);
-	
-	fclose(f);
+	set_sprite2s(&spriteSheetT2000, &view, shpPos[i], shpPos[i + 1]);
 }
 
 void free_main_shape_tables(void)
@@ -860,4 +973,5 @@ void free_main_shape_tables(void)
 	free_sprite2s(&spriteSheet10);
 	free_sprite2s(&spriteSheet11);
 	free_sprite2s(&spriteSheet12);
+	free_sprite2s(&spriteSheetT2000);
 }
@@ -42,7 +42,7 @@ typedef struct
 {
 	Uint16 width, height;
 	Uint16 size;
-	Uint8 *data;
+	const Uint8 *data;  // points into a mapped data file
 }
 Sprite;
 
@@ -76,7 +76,7 @@ static inline Uint16 get_sprite_height(unsigned int table, unsigned int index)
 }
 
 void load_sprites_file(unsigned int table, const char *filename);
-void load_sprites(unsigned int table, FILE *f);
+void load_sprites(unsigned int table, const Uint8 *data, size_t size);
 void free_sprites(unsigned int table);
 
 void blit_sprite(SDL_Surface *, int x, int y, unsigned int table, unsigned int index); // JE_newDrawCShapeNum
@@ -89,7 +89,7 @@ void blit_sprite_dark(SDL_Surface *, int x, int y, unsigned int table, unsigned
 typedef struct
 {
 	size_t size;
-	Uint8 *data;
+	const Uint8 *data;  // points into a mapped data file
 }
 Sprite2_array;
 
@@ -115,7 +115,12 @@ extern Sprite2_array spriteSheet12;  // fka shapesW2
 extern Sprite2_array spriteSheetT2000; // fka shapesT2k
 
 void JE_loadCompShapes(Sprite2_array *, char s);
-void JE_loadCompShapesB(Sprite2_array *, FILE *f);
+
+// Enemy banks come from an LRU cache of shape files bounded by enemySheetCacheBudget
+// (bytes); sheets bound to a bank are never evicted.
+extern size_t enemySheetCacheBudget;
+void load_enemy_sprite2s(Sprite2_array *, char s);
+void free_enemy_sheet_cache(void);
 void free_sprite2s(Sprite2_array *);
 
 void blit_sprite2(SDL_Surface *, int x, int y, Sprite2_array, unsigned int index);
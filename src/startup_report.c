@@ -0,0 +1,181 @@
+/*
+ * Tyrian 3000: Startup Time Report
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#include "startup_report.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPORT_NAME_MAX 32
+
+typedef struct
+{
+	char name[REPORT_NAME_MAX];
+	double at_ms;  // end of the phase, since startup_report_begin
+	double ms;
+} ReportPhase;
+
+typedef struct
+{
+	char name[REPORT_NAME_MAX];
+	size_t bytes;
+	double at_ms;  // start of the load
+	double ms;
+	bool main_thread;
+} ReportFile;
+
+bool startup_report_enabled = false;
+
+static Uint64 report_origin = 0;
+static Uint64 section_start = 0;
+static Uint64 last_mark = 0;
+static SDL_threadID main_thread_id;
+
+static ReportPhase *phases = NULL;
+static size_t phase_count = 0, phase_cap = 0;
+
+static ReportFile *files = NULL;
+static size_t file_count = 0, file_cap = 0;
+static SDL_SpinLock files_lock = 0;  // preload workers record files too
+
+static double ticks_to_ms(Uint64 ticks)
+{
+	return ticks * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+void startup_report_begin(void)
+{
+	if (!startup_report_enabled)
+		return;
+
+	report_origin = SDL_GetPerformanceCounter();
+	section_start = report_origin;
+	last_mark = report_origin;
+	main_thread_id = SDL_ThreadID();
+}
+
+void startup_report_section(void)
+{
+	if (!startup_report_enabled)
+		return;
+
+	SDL_AtomicLock(&files_lock);
+	file_count = 0;
+	SDL_AtomicUnlock(&files_lock);
+
+	phase_count = 0;
+
+	section_start = SDL_GetPerformanceCounter();
+	last_mark = section_start;
+}
+
+void startup_report_phase(const char *name)
+{
+	if (!startup_report_enabled)
+		return;
+
+	const Uint64 now = SDL_GetPerformanceCounter();
+
+	if (phase_count == phase_cap)
+	{
+		const size_t cap = phase_cap == 0 ? 32 : phase_cap * 2;
+		ReportPhase *grown = realloc(phases, cap * sizeof(*phases));
+		if (grown == NULL)
+			return;
+		phases = grown;
+		phase_cap = cap;
+	}
+
+	ReportPhase *phase = &phases[phase_count++];
+	SDL_strlcpy(phase->name, name, sizeof(phase->name));
+	phase->at_ms = ticks_to_ms(now - report_origin);
+	phase->ms = ticks_to_ms(now - last_mark);
+
+	last_mark = now;
+}
+
+Uint64 startup_report_clock(void)
+{
+	return startup_report_enabled ? SDL_GetPerformanceCounter() : 0;
+}
+
+void startup_report_file(const char *file, size_t bytes, Uint64 start)
+{
+	if (!startup_report_enabled || start == 0)
+		return;
+
+	const Uint64 now = SDL_GetPerformanceCounter();
+
+	SDL_AtomicLock(&files_lock);
+
+	if (file_count == file_cap)
+	{
+		const size_t cap = file_cap == 0 ? 32 : file_cap * 2;
+		ReportFile *grown = realloc(files, cap * sizeof(*files));
+		if (grown == NULL)
+		{
+			SDL_AtomicUnlock(&files_lock);
+			return;
+		}
+		files = grown;
+		file_cap = cap;
+	}
+
+	ReportFile *entry = &files[file_count++];
+	SDL_strlcpy(entry->name, file, sizeof(entry->name));
+	entry->bytes = bytes;
+	entry->at_ms = ticks_to_ms(start - report_origin);
+	entry->ms = ticks_to_ms(now - start);
+	entry->main_thread = SDL_ThreadID() == main_thread_id;
+
+	SDL_AtomicUnlock(&files_lock);
+}
+
+void startup_report_print(const char *section)
+{
+	if (!startup_report_enabled)
+		return;
+
+	const Uint64 now = SDL_GetPerformanceCounter();
+	const double total_ms = ticks_to_ms(now - section_start);
+
+	SDL_AtomicLock(&files_lock);
+
+	size_t total_bytes = 0;
+	for (size_t i = 0; i < file_count; ++i)
+		total_bytes += files[i].bytes;
+
+	printf("startup report: %s (%.2f ms)\n", section, total_ms);
+	printf("  %10s %10s  phase\n", "at ms", "ms");
+	for (size_t i = 0; i < phase_count; ++i)
+		printf("  %10.2f %10.2f  %s\n", phases[i].at_ms, phases[i].ms, phases[i].name);
+	printf("  %10s %10s %10s  file\n", "at ms", "ms", "bytes");
+	for (size_t i = 0; i < file_count; ++i)
+		printf("  %10.2f %10.2f %10lu  %s%s\n", files[i].at_ms, files[i].ms, (unsigned long)files[i].bytes, files[i].name, files[i].main_thread ? "" : " (preload)");
+	printf("  %21s %10lu  total\n", "", (unsigned long)total_bytes);
+
+	// one line, so benchmark scripts can grep for it
+	printf("{\"startup_report\":{\"section\":\"%s\",\"total_ms\":%.3f,\"total_bytes\":%lu,\"phases\":[", section, total_ms, (unsigned long)total_bytes);
+	for (size_t i = 0; i < phase_count; ++i)
+		printf("%s{\"name\":\"%s\",\"at_ms\":%.3f,\"ms\":%.3f}", i > 0 ? "," : "", phases[i].name, phases[i].at_ms, phases[i].ms);
+	printf("],\"files\":[");
+	for (size_t i = 0; i < file_count; ++i)
+		printf("%s{\"name\":\"%s\",\"at_ms\":%.3f,\"ms\":%.3f,\"bytes\":%lu,\"preload\":%s}", i > 0 ? "," : "", files[i].name, files[i].at_ms, files[i].ms, (unsigned long)files[i].bytes, files[i].main_thread ? "false" : "true");
+	printf("]}}\n");
+	fflush(stdout);
+
+	phase_count = 0;
+	file_count = 0;
+
+	SDL_AtomicUnlock(&files_lock);
+
+	section_start = now;
+	last_mark = now;
+}
@@ -0,0 +1,41 @@
+/*
+ * Tyrian 3000: Startup Time Report
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+#ifndef STARTUP_REPORT_H
+#define STARTUP_REPORT_H
+
+#include "opentyr.h"
+
+#include "SDL.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+extern bool startup_report_enabled;
+
+/* Starts the clock; everything is reported relative to this call. */
+void startup_report_begin(void);
+
+/* Starts a new section, dropping anything recorded since the last print. */
+void startup_report_section(void);
+
+/* Ends the phase that started at the previous mark (or at the section start). */
+void startup_report_phase(const char *name);
+
+/* Returns a start stamp for startup_report_file, or 0 when reporting is off. */
+Uint64 startup_report_clock(void);
+
+/* Records a data file load that began at `start`.  Safe to call from any thread. */
+void startup_report_file(const char *file, size_t bytes, Uint64 start);
+
+/* Prints everything recorded since the last print as a table and as one JSON line,
+   then starts a new section. */
+void startup_report_print(const char *section);
+
+#endif /* STARTUP_REPORT_H */
@@ -21,6 +21,7 @@
 #include "animlib.h"
 #include "backgrnd.h"
 #include "debug_console.h"
+#include "demo_bench.h"
 #include "episodes.h"
 #include "file.h"
 #include "font.h"
@@ -29,7 +30,6 @@
 #include "joystick.h"
 #include "keyboard.h"
 #include "jukebox.h"
-#include "lds_play.h"
 #include "loudness.h"
 #include "lvllib.h"
 #include "menus.h"
@@ -93,7 +93,13 @@ void JE_starShowVGA(void)
 
 		if (smoothScroll != 0 /*&& thisPlayerNum != 2*/)
 		{
-			wait_delay();
+			bool wait = demo_bench_passes == 0;  // the demo benchmark runs flat out
+#ifdef WITH_NETWORK
+			if (network_catching_up())
+				wait = false;  // as does a spectator behind the game, until it is not
+#endif
+			if (wait)
+				wait_delay();
 			setDelay(frameCountMax);
 		}
 
@@ -178,440 +184,435 @@ inline static void blit_enemy(SDL_Surface *surface, unsigned int i, signed int x
 
 void JE_drawEnemy(int enemyOffset) // actually does a whole lot more than just drawing
 {
+	const Uint64 bench_start = demo_bench_clock();
+
 	player[0].x -= 25;
 
-	for (int i = enemyOffset - 25; i < enemyOffset; i++)
+	for (int i = slot_pool_next_live(&enemyPool, enemyOffset - 25, enemyOffset); i < enemyOffset; i = slot_pool_next_live(&enemyPool, i + 1, enemyOffset))
 	{
-		if (enemyAvail[i] != 1)
-		{
-			enemy[i].mapoffset = tempMapXOfs;
+		enemy[i].mapoffset = tempMapXOfs;
 
-			if (enemy[i].xaccel && enemy[i].xaccel - 89u > mt_rand() % 11)
+		if (enemy[i].xaccel && enemy[i].xaccel - 89u > mt_rand() % 11)
+		{
+			if (player[0].x > enemy[i].ex)
 			{
-				if (player[0].x > enemy[i].ex)
-				{
-					if (enemy[i].exc < enemy[i].xaccel - 89)
-						enemy[i].exc++;
-				}
-				else
-				{
-					if (enemy[i].exc >= 0 || -enemy[i].exc < enemy[i].xaccel - 89)
-						enemy[i].exc--;
-				}
+				if (enemy[i].exc < enemy[i].xaccel - 89)
+					enemy[i].exc++;
+			}
+			else
+			{
+				if (enemy[i].exc >= 0 || -enemy[i].exc < enemy[i].xaccel - 89)
+					enemy[i].exc--;
 			}
+		}
 
-			if (enemy[i].yaccel && enemy[i].yaccel - 89u > mt_rand() % 11)
+		if (enemy[i].yaccel && enemy[i].yaccel - 89u > mt_rand() % 11)
+		{
+			if (player[0].y > enemy[i].ey)
 			{
-				if (player[0].y > enemy[i].ey)
-				{
-					if (enemy[i].eyc < enemy[i].yaccel - 89)
-						enemy[i].eyc++;
-				}
-				else
-				{
-					if (enemy[i].eyc >= 0 || -enemy[i].eyc < enemy[i].yaccel - 89)
-						enemy[i].eyc--;
-				}
+				if (enemy[i].eyc < enemy[i].yaccel - 89)
+					enemy[i].eyc++;
 			}
+			else
+			{
+				if (enemy[i].eyc >= 0 || -enemy[i].eyc < enemy[i].yaccel - 89)
+					enemy[i].eyc--;
+			}
+		}
 
  			if (enemy[i].ex + tempMapXOfs > -29 && enemy[i].ex + tempMapXOfs < 300)
+		{
+			if (enemy[i].aniactive == 1)
 			{
-				if (enemy[i].aniactive == 1)
-				{
-					enemy[i].enemycycle++;
+				enemy[i].enemycycle++;
 
-					if (enemy[i].enemycycle == enemy[i].animax)
-						enemy[i].aniactive = enemy[i].aniwhenfire;
-					else if (enemy[i].enemycycle > enemy[i].ani)
-						enemy[i].enemycycle = enemy[i].animin;
-				}
+				if (enemy[i].enemycycle == enemy[i].animax)
+					enemy[i].aniactive = enemy[i].aniwhenfire;
+				else if (enemy[i].enemycycle > enemy[i].ani)
+					enemy[i].enemycycle = enemy[i].animin;
+			}
 
-				if (enemy[i].egr[enemy[i].enemycycle - 1] == 999)
-					goto enemy_gone;
+			if (enemy[i].egr[enemy[i].enemycycle - 1] == 999)
+				goto enemy_gone;
 
-				if (enemy[i].size == 1) // 2x2 enemy
+			if (enemy[i].size == 1) // 2x2 enemy
+			{
+				if (enemy[i].ey > -13)
 				{
-					if (enemy[i].ey > -13)
-					{
-						blit_enemy(VGAScreen, i, -6, -7, 0);
-						blit_enemy(VGAScreen, i,  6, -7, 1);
-					}
-					if (enemy[i].ey > -26 && enemy[i].ey < 182)
-					{
-						blit_enemy(VGAScreen, i, -6,  7, 19);
-						blit_enemy(VGAScreen, i,  6,  7, 20);
-					}
+					blit_enemy(VGAScreen, i, -6, -7, 0);
+					blit_enemy(VGAScreen, i,  6, -7, 1);
 				}
-				else
+				if (enemy[i].ey > -26 && enemy[i].ey < 182)
 				{
-					if (enemy[i].ey > -13)
-						blit_enemy(VGAScreen, i, 0, 0, 0);
+					blit_enemy(VGAScreen, i, -6,  7, 19);
+					blit_enemy(VGAScreen, i,  6,  7, 20);
 				}
-
-				enemy[i].filter = 0;
+			}
+			else
+			{
+				if (enemy[i].ey > -13)
+					blit_enemy(VGAScreen, i, 0, 0, 0);
 			}
 
-			if (enemy[i].excc)
+			enemy[i].filter = 0;
+		}
+
+		if (enemy[i].excc)
+		{
+			if (--enemy[i].exccw <= 0)
 			{
-				if (--enemy[i].exccw <= 0)
+				if (enemy[i].exc == enemy[i].exrev)
+				{
+					enemy[i].excc = -enemy[i].excc;
+					enemy[i].exrev = -enemy[i].exrev;
+					enemy[i].exccadd = -enemy[i].exccadd;
+				}
+				else
 				{
+					enemy[i].exc += enemy[i].exccadd;
+					enemy[i].exccw = enemy[i].exccwmax;
 					if (enemy[i].exc == enemy[i].exrev)
 					{
 						enemy[i].excc = -enemy[i].excc;
 						enemy[i].exrev = -enemy[i].exrev;
 						enemy[i].exccadd = -enemy[i].exccadd;
 					}
-					else
-					{
-						enemy[i].exc += enemy[i].exccadd;
-						enemy[i].exccw = enemy[i].exccwmax;
-						if (enemy[i].exc == enemy[i].exrev)
-						{
-							enemy[i].excc = -enemy[i].excc;
-							enemy[i].exrev = -enemy[i].exrev;
-							enemy[i].exccadd = -enemy[i].exccadd;
-						}
-					}
 				}
 			}
+		}
 
-			if (enemy[i].eycc)
+		if (enemy[i].eycc)
+		{
+			if (--enemy[i].eyccw <= 0)
 			{
-				if (--enemy[i].eyccw <= 0)
+				if (enemy[i].eyc == enemy[i].eyrev)
+				{
+					enemy[i].eycc = -enemy[i].eycc;
+					enemy[i].eyrev = -enemy[i].eyrev;
+					enemy[i].eyccadd = -enemy[i].eyccadd;
+				}
+				else
 				{
+					enemy[i].eyc += enemy[i].eyccadd;
+					enemy[i].eyccw = enemy[i].eyccwmax;
 					if (enemy[i].eyc == enemy[i].eyrev)
 					{
 						enemy[i].eycc = -enemy[i].eycc;
 						enemy[i].eyrev = -enemy[i].eyrev;
 						enemy[i].eyccadd = -enemy[i].eyccadd;
 					}
-					else
-					{
-						enemy[i].eyc += enemy[i].eyccadd;
-						enemy[i].eyccw = enemy[i].eyccwmax;
-						if (enemy[i].eyc == enemy[i].eyrev)
-						{
-							enemy[i].eycc = -enemy[i].eycc;
-							enemy[i].eyrev = -enemy[i].eyrev;
-							enemy[i].eyccadd = -enemy[i].eyccadd;
-						}
-					}
 				}
 			}
+		}
 
-			enemy[i].ey += enemy[i].fixedmovey;
+		enemy[i].ey += enemy[i].fixedmovey;
 
-			enemy[i].ex += enemy[i].exc;
-			if (enemy[i].ex < -80 || enemy[i].ex > 340)
-				goto enemy_gone;
+		enemy[i].ex += enemy[i].exc;
+		if (enemy[i].ex < -80 || enemy[i].ex > 340)
+			goto enemy_gone;
 
-			enemy[i].ey += enemy[i].eyc;
-			if (enemy[i].ey < -112 || enemy[i].ey > 190)
-				goto enemy_gone;
+		enemy[i].ey += enemy[i].eyc;
+		if (enemy[i].ey < -112 || enemy[i].ey > 190)
+			goto enemy_gone;
 
-			goto enemy_still_exists;
+		goto enemy_still_exists;
 
 enemy_gone:
-			/* enemy[i].egr[10] &= 0x00ff; <MXD> madness? */
-			enemyAvail[i] = 1;
-			goto draw_enemy_end;
+		/* enemy[i].egr[10] &= 0x00ff; <MXD> madness? */
+		enemy_set_avail(i, 1);
+		goto draw_enemy_end;
 
 enemy_still_exists:
 
-			/*X bounce*/
-			if (enemy[i].ex <= enemy[i].xminbounce || enemy[i].ex >= enemy[i].xmaxbounce)
-				enemy[i].exc = -enemy[i].exc;
+		/*X bounce*/
+		if (enemy[i].ex <= enemy[i].xminbounce || enemy[i].ex >= enemy[i].xmaxbounce)
+			enemy[i].exc = -enemy[i].exc;
 
-			/*Y bounce*/
-			if (enemy[i].ey <= enemy[i].yminbounce || enemy[i].ey >= enemy[i].ymaxbounce)
-				enemy[i].eyc = -enemy[i].eyc;
+		/*Y bounce*/
+		if (enemy[i].ey <= enemy[i].yminbounce || enemy[i].ey >= enemy[i].ymaxbounce)
+			enemy[i].eyc = -enemy[i].eyc;
 
-			/* Evalue != 0 - score item at boundary */
-			if (enemy[i].scoreitem)
-			{
-				if (enemy[i].ex < -5)
-					enemy[i].ex++;
-				if (enemy[i].ex > 245)
-					enemy[i].ex--;
-			}
+		/* Evalue != 0 - score item at boundary */
+		if (enemy[i].scoreitem)
+		{
+			if (enemy[i].ex < -5)
+				enemy[i].ex++;
+			if (enemy[i].ex > 245)
+				enemy[i].ex--;
+		}
 
-			enemy[i].ey += tempBackMove;
+		enemy[i].ey += tempBackMove;
 
-			if (enemy[i].ex <= -24 || enemy[i].ex >= 296)
-				goto draw_enemy_end;
+		if (enemy[i].ex <= -24 || enemy[i].ex >= 296)
+			goto draw_enemy_end;
 
-			JE_integer tempX = enemy[i].ex;
-			JE_integer tempY = enemy[i].ey;
+		JE_integer tempX = enemy[i].ex;
+		JE_integer tempY = enemy[i].ey;
 
-			temp = enemy[i].enemytype;
+		temp = enemy[i].enemytype;
 
-			/* Enemy Shots */
-			if (enemy[i].edamaged == 1)
-				goto draw_enemy_end;
+		/* Enemy Shots */
+		if (enemy[i].edamaged == 1)
+			goto draw_enemy_end;
 
-			enemyOnScreen++;
+		enemyOnScreen++;
 
-			if (enemy[i].iced)
+		if (enemy[i].iced)
+		{
+			enemy[i].iced--;
+			if (enemy[i].enemyground != 0)
 			{
-				enemy[i].iced--;
-				if (enemy[i].enemyground != 0)
-				{
-					enemy[i].filter = 0x09;
-				}
-				goto draw_enemy_end;
+				enemy[i].filter = 0x09;
 			}
+			goto draw_enemy_end;
+		}
 
-			for (int j = 3; j > 0; j--)
+		for (int j = 3; j > 0; j--)
+		{
+			if (enemy[i].freq[j-1])
 			{
-				if (enemy[i].freq[j-1])
-				{
-					temp3 = enemy[i].tur[j-1];
+				temp3 = enemy[i].tur[j-1];
 
-					if (--enemy[i].eshotwait[j-1] == 0 && temp3)
+				if (--enemy[i].eshotwait[j-1] == 0 && temp3)
+				{
+					enemy[i].eshotwait[j-1] = enemy[i].freq[j-1];
+					if (difficultyLevel > DIFFICULTY_NORMAL)
 					{
-						enemy[i].eshotwait[j-1] = enemy[i].freq[j-1];
-						if (difficultyLevel > DIFFICULTY_NORMAL)
-						{
+						enemy[i].eshotwait[j-1] = (enemy[i].eshotwait[j-1] / 2) + 1;
+						if (difficultyLevel > DIFFICULTY_MANIACAL)
 							enemy[i].eshotwait[j-1] = (enemy[i].eshotwait[j-1] / 2) + 1;
-							if (difficultyLevel > DIFFICULTY_MANIACAL)
-								enemy[i].eshotwait[j-1] = (enemy[i].eshotwait[j-1] / 2) + 1;
-						}
+					}
 
-						if (galagaMode && (enemy[i].eyc == 0 || (mt_rand() % 400) >= galagaShotFreq))
-							goto draw_enemy_end;
+					if (galagaMode && (enemy[i].eyc == 0 || (mt_rand() % 400) >= galagaShotFreq))
+						goto draw_enemy_end;
 
-						switch (temp3)
+					switch (temp3)
+					{
+					case 252: /* Savara Boss DualMissile */
+						if (enemy[i].ey > 20)
 						{
-						case 252: /* Savara Boss DualMissile */
-							if (enemy[i].ey > 20)
-							{
-								JE_setupExplosion(tempX - 8 + tempMapXOfs, tempY - 20 - backMove * 8, -2, 6, false, false);
-								JE_setupExplosion(tempX + 4 + tempMapXOfs, tempY - 20 - backMove * 8, -2, 6, false, false);
-							}
-							break;
-						case 251:; /* Suck-O-Magnet */
-							const JE_integer attraction = 4 - (abs(player[0].x - tempX) + abs(player[0].y - tempY)) / 100;
-							if (attraction > 0)
-								player[0].x_velocity += (player[0].x > tempX) ? -attraction : attraction;
-							break;
-						case 253: /* Left ShortRange Magnet */
-							if (abs(player[0].x + 25 - 14 - tempX) < 24 && abs(player[0].y - tempY) < 28)
-							{
-								player[0].x_velocity += 2;
-							}
-							if (twoPlayerMode &&
-							   (abs(player[1].x - 14 - tempX) < 24 && abs(player[1].y - tempY) < 28))
-							{
-								player[1].x_velocity += 2;
-							}
-							break;
-						case 254: /* Left ShortRange Magnet */
-							if (abs(player[0].x + 25 - 14 - tempX) < 24 && abs(player[0].y - tempY) < 28)
-							{
-								player[0].x_velocity -= 2;
-							}
-							if (twoPlayerMode &&
-							   (abs(player[1].x - 14 - tempX) < 24 && abs(player[1].y - tempY) < 28))
+							JE_setupExplosion(tempX - 8 + tempMapXOfs, tempY - 20 - backMove * 8, -2, 6, false, false);
+							JE_setupExplosion(tempX + 4 + tempMapXOfs, tempY - 20 - backMove * 8, -2, 6, false, false);
+						}
+						break;
+					case 251:; /* Suck-O-Magnet */
+						const JE_integer attraction = 4 - (abs(player[0].x - tempX) + abs(player[0].y - tempY)) / 100;
+						if (attraction > 0)
+							player[0].x_velocity += (player[0].x > tempX) ? -attraction : attraction;
+						break;
+					case 253: /* Left ShortRange Magnet */
+						if (abs(player[0].x + 25 - 14 - tempX) < 24 && abs(player[0].y - tempY) < 28)
+						{
+							player[0].x_velocity += 2;
+						}
+						if (twoPlayerMode &&
+						   (abs(player[1].x - 14 - tempX) < 24 && abs(player[1].y - tempY) < 28))
+						{
+							player[1].x_velocity += 2;
+						}
+						break;
+					case 254: /* Left ShortRange Magnet */
+						if (abs(player[0].x + 25 - 14 - tempX) < 24 && abs(player[0].y - tempY) < 28)
+						{
+							player[0].x_velocity -= 2;
+						}
+						if (twoPlayerMode &&
+						   (abs(player[1].x - 14 - tempX) < 24 && abs(player[1].y - tempY) < 28))
+						{
+							player[1].x_velocity -= 2;
+						}
+						break;
+					case 255: /* Magneto RePulse!! */
+						if (difficultyLevel != DIFFICULTY_EASY) /*DIF*/
+						{
+							if (j == 3)
 							{
-								player[1].x_velocity -= 2;
+								enemy[i].filter = 0x70;
 							}
-							break;
-						case 255: /* Magneto RePulse!! */
-							if (difficultyLevel != DIFFICULTY_EASY) /*DIF*/
+							else
 							{
-								if (j == 3)
-								{
-									enemy[i].filter = 0x70;
-								}
-								else
-								{
-									const JE_integer repulsion = 4 - (abs(player[0].x - tempX) + abs(player[0].y - tempY)) / 20;
-									if (repulsion > 0)
-										player[0].x_velocity += (player[0].x > tempX) ? repulsion : -repulsion;
-								}
+								const JE_integer repulsion = 4 - (abs(player[0].x - tempX) + abs(player[0].y - tempY)) / 20;
+								if (repulsion > 0)
+									player[0].x_velocity += (player[0].x > tempX) ? repulsion : -repulsion;
 							}
-							break;
-						default:
-						/*Rot*/
-							for (int tempCount = weapons[temp3].multi; tempCount > 0; tempCount--)
-							{
-								for (b = 0; b < ENEMY_SHOT_MAX; b++)
-								{
-									if (enemyShotAvail[b] == 1)
-										break;
-								}
-								if (b == ENEMY_SHOT_MAX)
-									goto draw_enemy_end;
+						}
+						break;
+					default:
+					/*Rot*/
+						for (int tempCount = weapons[temp3].multi; tempCount > 0; tempCount--)
+						{
+							b = slot_pool_next_free(&enemyShotPool, 0, ENEMY_SHOT_MAX);
+							if (b == ENEMY_SHOT_MAX)
+								goto draw_enemy_end;
 
-								enemyShotAvail[b] = !enemyShotAvail[b];
+							enemy_shot_set_avail(b, false);
 
-								if (weapons[temp3].sound > 0)
+							if (weapons[temp3].sound > 0)
+							{
+								do
 								{
-									do
-									{
-										temp = mt_rand() % 8;
-									} while (temp == 3);
-									soundQueue[temp] = weapons[temp3].sound;
-								}
+									temp = mt_rand() % 8;
+								} while (temp == 3);
+								soundQueue[temp] = weapons[temp3].sound;
+							}
 
-								if (enemy[i].aniactive == 2)
-									enemy[i].aniactive = 1;
+							if (enemy[i].aniactive == 2)
+								enemy[i].aniactive = 1;
 
-								if (++enemy[i].eshotmultipos[j-1] > weapons[temp3].max)
-									enemy[i].eshotmultipos[j-1] = 1;
+							if (++enemy[i].eshotmultipos[j-1] > weapons[temp3].max)
+								enemy[i].eshotmultipos[j-1] = 1;
 
-								int tempPos = enemy[i].eshotmultipos[j-1] - 1;
+							int tempPos = enemy[i].eshotmultipos[j-1] - 1;
 
-								if (j == 1)
-									temp2 = 4;
+							if (j == 1)
+								temp2 = 4;
 
-								enemyShot[b].sx = tempX + weapons[temp3].bx[tempPos] + tempMapXOfs;
-								enemyShot[b].sy = tempY + weapons[temp3].by[tempPos];
-								enemyShot[b].sdmg = weapons[temp3].attack[tempPos];
-								enemyShot[b].tx = weapons[temp3].tx;
-								enemyShot[b].ty = weapons[temp3].ty;
-								enemyShot[b].duration = weapons[temp3].del[tempPos];
-								enemyShot[b].animate = 0;
-								enemyShot[b].animax = weapons[temp3].weapani;
+							enemyShot[b].sx = tempX + weapons[temp3].bx[tempPos] + tempMapXOfs;
+							enemyShot[b].sy = tempY + weapons[temp3].by[tempPos];
+							enemyShot[b].sdmg = weapons[temp3].attack[tempPos];
+							enemyShot[b].tx = weapons[temp3].tx;
+							enemyShot[b].ty = weapons[temp3].ty;
+							enemyShot[b].duration = weapons[temp3].del[tempPos];
+							enemyShot[b].animate = 0;
+							enemyShot[b].animax = weapons[temp3].weapani;
 
-								enemyShot[b].sgr = weapons[temp3].sg[tempPos];
-								switch (j)
-								{
-								case 1:
-									enemyShot[b].syc = weapons[temp3].acceleration;
-									enemyShot[b].sxc = weapons[temp3].accelerationx;
-
-									enemyShot[b].sxm = weapons[temp3].sx[tempPos];
-									enemyShot[b].sym = weapons[temp3].sy[tempPos];
-									break;
-								case 3:
-									enemyShot[b].sxc = -weapons[temp3].acceleration;
-									enemyShot[b].syc = weapons[temp3].accelerationx;
-
-									enemyShot[b].sxm = -weapons[temp3].sy[tempPos];
-									enemyShot[b].sym = -weapons[temp3].sx[tempPos];
-									break;
-								case 2:
-									enemyShot[b].sxc = weapons[temp3].acceleration;
-									enemyShot[b].syc = -weapons[temp3].acceleration;
-
-									enemyShot[b].sxm = weapons[temp3].sy[tempPos];
-									enemyShot[b].sym = -weapons[temp3].sx[tempPos];
-									break;
-								}
+							enemyShot[b].sgr = weapons[temp3].sg[tempPos];
+							switch (j)
+							{
+							case 1:
+								enemyShot[b].syc = weapons[temp3].acceleration;
+								enemyShot[b].sxc = weapons[temp3].accelerationx;
+
+								enemyShot[b].sxm = weapons[temp3].sx[tempPos];
+								enemyShot[b].sym = weapons[temp3].sy[tempPos];
+								break;
+							case 3:
+								enemyShot[b].sxc = -weapons[temp3].acceleration;
+								enemyShot[b].syc = weapons[temp3].accelerationx;
+
+								enemyShot[b].sxm = -weapons[temp3].sy[tempPos];
+								enemyShot[b].sym = -weapons[temp3].sx[tempPos];
+								break;
+							case 2:
+								enemyShot[b].sxc = weapons[temp3].acceleration;
+								enemyShot[b].syc = -weapons[temp3].acceleration;
+
+								enemyShot[b].sxm = weapons[temp3].sy[tempPos];
+								enemyShot[b].sym = -weapons[temp3].sx[tempPos];
+								break;
+							}
 
-								if (weapons[temp3].aim > 0)
-								{
-									JE_byte aim = weapons[temp3].aim;
+							if (weapons[temp3].aim > 0)
+							{
+								JE_byte aim = weapons[temp3].aim;
 
-									/*DIF*/
-									if (difficultyLevel > DIFFICULTY_NORMAL)
-										aim += difficultyLevel - 2;
+								/*DIF*/
+								if (difficultyLevel > DIFFICULTY_NORMAL)
+									aim += difficultyLevel - 2;
 
-									JE_word targetX = player[0].x;
-									JE_word targetY = player[0].y;
+								JE_word targetX = player[0].x;
+								JE_word targetY = player[0].y;
 
-									if (twoPlayerMode)
+								if (twoPlayerMode)
+								{
+									// fire at live player(s)
+									if (player[0].is_alive && !player[1].is_alive)
+										temp = 0;
+									else if (player[1].is_alive && !player[0].is_alive)
+										temp = 1;
+									else
+										temp = mt_rand() % 2;
+
+									if (temp == 1)
 									{
-										// fire at live player(s)
-										if (player[0].is_alive && !player[1].is_alive)
-											temp = 0;
-										else if (player[1].is_alive && !player[0].is_alive)
-											temp = 1;
-										else
-											temp = mt_rand() % 2;
-
-										if (temp == 1)
-										{
-											targetX = player[1].x - 25;
-											targetY = player[1].y;
-										}
+										targetX = player[1].x - 25;
+										targetY = player[1].y;
 									}
-
-									JE_integer aimX = (targetX + 25) - tempX - tempMapXOfs - 4;
-									if (aimX == 0)
-										aimX = 1;
-									JE_integer aimY = targetY - tempY;
-									if (aimY == 0)
-										aimY = 1;
-									const JE_integer maxMagAim = MAX(abs(aimX), abs(aimY));
-									enemyShot[b].sxm = roundf((float)aimX / maxMagAim * aim);
-									enemyShot[b].sym = roundf((float)aimY / maxMagAim * aim);
 								}
+
+								JE_integer aimX = (targetX + 25) - tempX - tempMapXOfs - 4;
+								if (aimX == 0)
+									aimX = 1;
+								JE_integer aimY = targetY - tempY;
+								if (aimY == 0)
+									aimY = 1;
+								const JE_integer maxMagAim = MAX(abs(aimX), abs(aimY));
+								enemyShot[b].sxm = roundf((float)aimX / maxMagAim * aim);
+								enemyShot[b].sym = roundf((float)aimY / maxMagAim * aim);
 							}
-							break;
 						}
+						break;
 					}
 				}
 			}
+		}
 
-			/* Enemy Launch Routine */
-			if (enemy[i].launchfreq)
+		/* Enemy Launch Routine */
+		if (enemy[i].launchfreq)
+		{
+			if (--enemy[i].launchwait == 0)
 			{
-				if (--enemy[i].launchwait == 0)
-				{
-					enemy[i].launchwait = enemy[i].launchfreq;
+				enemy[i].launchwait = enemy[i].launchfreq;
 
-					if (enemy[i].launchspecial != 0)
-					{
-						/*Type  1 : Must be inline with player*/
-						if (abs(enemy[i].ey - player[0].y) > 5)
-							goto draw_enemy_end;
-					}
+				if (enemy[i].launchspecial != 0)
+				{
+					/*Type  1 : Must be inline with player*/
+					if (abs(enemy[i].ey - player[0].y) > 5)
+						goto draw_enemy_end;
+				}
 
-					if (enemy[i].aniactive == 2)
-					{
-						enemy[i].aniactive = 1;
-					}
+				if (enemy[i].aniactive == 2)
+				{
+					enemy[i].aniactive = 1;
+				}
 
-					if (enemy[i].launchtype == 0)
-						goto draw_enemy_end;
+				if (enemy[i].launchtype == 0)
+					goto draw_enemy_end;
 
-					tempW = enemy[i].launchtype;
-					b = JE_newEnemy(enemyOffset == 50 ? 75 : enemyOffset - 25, tempW, 0);
+				tempW = enemy[i].launchtype;
+				b = JE_newEnemy(enemyOffset == 50 ? 75 : enemyOffset - 25, tempW, 0);
 
-					/*Launch Enemy Placement*/
-					if (b > 0)
-					{
-						struct JE_SingleEnemyType* e = &enemy[b-1];
+				/*Launch Enemy Placement*/
+				if (b > 0)
+				{
+					struct JE_SingleEnemyType* e = &enemy[b-1];
 
-						e->ex = tempX;
-						e->ey = tempY + enemyDat[e->enemytype].startyc;
-						if (e->size == 0)
-							e->ey -= 7;
+					e->ex = tempX;
+					e->ey = tempY + enemyDat[e->enemytype].startyc;
+					if (e->size == 0)
+						e->ey -= 7;
 
-						if (e->launchtype > 0 && e->launchfreq == 0)
+					if (e->launchtype > 0 && e->launchfreq == 0)
+					{
+						if (e->launchtype > 90)
 						{
-							if (e->launchtype > 90)
-							{
-								e->ex += mt_rand() % ((e->launchtype - 90) * 4) - (e->launchtype - 90) * 2;
-							}
-							else
-							{
-								JE_integer aimX = (player[0].x + 25) - tempX - tempMapXOfs - 4;
-								if (aimX == 0)
-									aimX = 1;
-								JE_integer aimY = player[0].y - tempY;
-								if (aimY == 0)
-									aimY = 1;
-								const JE_integer maxMagAim = MAX(abs(aimX), abs(aimY));
-								e->exc = roundf((float)aimX / maxMagAim * e->launchtype);
-								e->eyc = roundf((float)aimY / maxMagAim * e->launchtype);
-							}
+							e->ex += mt_rand() % ((e->launchtype - 90) * 4) - (e->launchtype - 90) * 2;
 						}
-
-						do
-						{
-							temp = mt_rand() % 8;
-						} while (temp == 3);
-						soundQueue[temp] = randomEnemyLaunchSounds[(mt_rand() % 3)];
-
-						if (enemy[i].launchspecial == 1 &&
-						    enemy[i].linknum < 100)
+						else
 						{
-							e->linknum = enemy[i].linknum;
+							JE_integer aimX = (player[0].x + 25) - tempX - tempMapXOfs - 4;
+							if (aimX == 0)
+								aimX = 1;
+							JE_integer aimY = player[0].y - tempY;
+							if (aimY == 0)
+								aimY = 1;
+							const JE_integer maxMagAim = MAX(abs(aimX), abs(aimY));
+							e->exc = roundf((float)aimX / maxMagAim * e->launchtype);
+							e->eyc = roundf((float)aimY / maxMagAim * e->launchtype);
 						}
 					}
+
+					do
+					{
+						temp = mt_rand() % 8;
+					} while (temp == 3);
+					soundQueue[temp] = randomEnemyLaunchSounds[(mt_rand() % 3)];
+
+					if (enemy[i].launchspecial == 1 &&
+					    enemy[i].linknum < 100)
+					{
+						e->linknum = enemy[i].linknum;
+					}
 				}
 			}
 		}
@@ -620,6 +621,8 @@ draw_enemy_end:
 	}
 
 	player[0].x += 25;
+
+	demo_bench_enemy_time(bench_start);
 }
 
 void JE_main(void)
@@ -646,6 +649,8 @@ void JE_main(void)
 
 start_level:
 
+	remote_control_on_level_end();
+
 	mouseSetRelative(false);
 
 	if (galagaMode)
@@ -747,6 +752,8 @@ start_level_first:
 	for (uint i = 0; i < COUNTOF(player); ++i)
 		player[i].is_alive = true;
 
+	remote_control_on_level_start();
+
 	oldDifficultyLevel = difficultyLevel;
 	if (episodeNum == EPISODE_AVAILABLE)
 		difficultyLevel--;
@@ -927,6 +934,8 @@ start_level_first:
 	{
 		JE_clearSpecialRequests();
 		mt_srand(32402394);
+
+		network_level_start();
 	}
 #endif
 
@@ -1030,13 +1039,12 @@ start_level_first:
 		JE_loadItemDat();
 	}
 
-	memset(enemyAvail,       1, sizeof(enemyAvail));
-	for (uint i = 0; i < COUNTOF(enemyShotAvail); i++)
-		enemyShotAvail[i] = 1;
+	enemy_free_all();
+	enemy_shot_free_all();
 
 	/*Initialize Shots*/
 	memset(playerShotData,   0, sizeof(playerShotData));
-	memset(shotAvail,        0, sizeof(shotAvail));
+	player_shot_free_all();
 	memset(shotMultiPos,     0, sizeof(shotMultiPos));
 	memset(shotRepeat,       1, sizeof(shotRepeat));
 
@@ -1045,6 +1053,7 @@ start_level_first:
 	memset(globalFlags,      0, sizeof(globalFlags));
 
 	memset(explosions,       0, sizeof(explosions));
+	slot_pool_clear(&explosionPool);
 	memset(rep_explosions,   0, sizeof(rep_explosions));
 
 	/* --- Clear Sound Queue --- */
@@ -1147,7 +1156,7 @@ level_loop:
 		play_song(9);
 		musicFade = false;
 	}
-	else if (!playing && firstGameOver)
+	else if (!song_is_playing() && firstGameOver)
 	{
 		play_song(levelSong - 1);
 	}
@@ -1358,6 +1367,8 @@ level_loop:
 	}
 
 	/*-----------------------Ground Enemy------------------------*/
+	demo_bench_frame();
+
 	lastEnemyOnScreen = enemyOnScreen;
 
 	tempMapXOfs = mapXOfs;
@@ -1454,322 +1465,316 @@ level_loop:
 	}
 
 	/* Player Shot Images */
-	for (int z = 0; z < MAX_PWEAPON; z++)
+	const Uint64 bench_start = demo_bench_clock();
+
+	for (int z = slot_pool_next_live(&playerShotPool, 0, MAX_PWEAPON); z < MAX_PWEAPON; z = slot_pool_next_live(&playerShotPool, z + 1, MAX_PWEAPON))
 	{
-		if (shotAvail[z] != 0)
-		{
-			bool is_special = false;
-			int tempShotX = 0, tempShotY = 0;
-			JE_byte chain;
-			JE_byte playerNum;
-			JE_word tempX2, tempY2;
-			JE_integer damage;
-			
-			if (!player_shot_move_and_draw(z, &is_special, &tempShotX, &tempShotY, &damage, &temp2, &chain, &playerNum, &tempX2, &tempY2))
-			{
-				goto draw_player_shot_loop_end;
-			}
+		bool is_special = false;
+		int tempShotX = 0, tempShotY = 0;
+		JE_byte chain;
+		JE_byte playerNum;
+		JE_word tempX2, tempY2;
+		JE_integer damage;
+		
+		if (!player_shot_move_and_draw(z, &is_special, &tempShotX, &tempShotY, &damage, &temp2, &chain, &playerNum, &tempX2, &tempY2))
+		{
+			goto draw_player_shot_loop_end;
+		}
 
-			for (b = 0; b < 100; b++)
+		for (b = slot_pool_next_live(&enemyPool, 0, 100); b < 100; b = slot_pool_next_live(&enemyPool, b + 1, 100))
+		{
+			if (enemyAvail[b] == 0)
 			{
-				if (enemyAvail[b] == 0)
+				bool collided;
+
+				if (z == MAX_PWEAPON - 1)
+				{
+					temp = 25 - abs(zinglonDuration - 25);
+					collided = abs(enemy[b].ex + enemy[b].mapoffset - (player[0].x + 7)) < temp;
+					temp2 = 9;
+					chain = 0;
+					damage = 10;
+				}
+				else if (is_special)
+				{
+					collided = ((enemy[b].enemycycle == 0) &&
+					            (abs(enemy[b].ex + enemy[b].mapoffset - tempShotX - tempX2) < (25 + tempX2)) &&
+					            (abs(enemy[b].ey - tempShotY - 12 - tempY2)                 < (29 + tempY2))) ||
+					           ((enemy[b].enemycycle > 0) &&
+					            (abs(enemy[b].ex + enemy[b].mapoffset - tempShotX - tempX2) < (13 + tempX2)) &&
+					            (abs(enemy[b].ey - tempShotY - 6 - tempY2)                  < (15 + tempY2)));
+				}
+				else
 				{
-					bool collided;
+					collided = ((enemy[b].enemycycle == 0) &&
+					            (abs(enemy[b].ex + enemy[b].mapoffset - tempShotX) < 25) && (abs(enemy[b].ey - tempShotY - 12) < 29)) ||
+					           ((enemy[b].enemycycle > 0) &&
+					            (abs(enemy[b].ex + enemy[b].mapoffset - tempShotX) < 13) && (abs(enemy[b].ey - tempShotY - 6) < 15));
+				}
 
-					if (z == MAX_PWEAPON - 1)
+				if (collided)
+				{
+					if (chain > 0)
 					{
-						temp = 25 - abs(zinglonDuration - 25);
-						collided = abs(enemy[b].ex + enemy[b].mapoffset - (player[0].x + 7)) < temp;
-						temp2 = 9;
-						chain = 0;
-						damage = 10;
+						shotMultiPos[SHOT_MISC] = 0;
+						b = player_shot_create(0, SHOT_MISC, tempShotX, tempShotY, mouseX, mouseY, chain, playerNum);
+						player_shot_set_avail(z, 0);
+						goto draw_player_shot_loop_end;
 					}
-					else if (is_special)
+
+					infiniteShot = false;
+
+					if (damage == 99)
 					{
-						collided = ((enemy[b].enemycycle == 0) &&
-						            (abs(enemy[b].ex + enemy[b].mapoffset - tempShotX - tempX2) < (25 + tempX2)) &&
-						            (abs(enemy[b].ey - tempShotY - 12 - tempY2)                 < (29 + tempY2))) ||
-						           ((enemy[b].enemycycle > 0) &&
-						            (abs(enemy[b].ex + enemy[b].mapoffset - tempShotX - tempX2) < (13 + tempX2)) &&
-						            (abs(enemy[b].ey - tempShotY - 6 - tempY2)                  < (15 + tempY2)));
+						damage = 0;
+						doIced = 40;
+						enemy[b].iced = 40;
 					}
 					else
 					{
-						collided = ((enemy[b].enemycycle == 0) &&
-						            (abs(enemy[b].ex + enemy[b].mapoffset - tempShotX) < 25) && (abs(enemy[b].ey - tempShotY - 12) < 29)) ||
-						           ((enemy[b].enemycycle > 0) &&
-						            (abs(enemy[b].ex + enemy[b].mapoffset - tempShotX) < 13) && (abs(enemy[b].ey - tempShotY - 6) < 15));
+						doIced = 0;
+						if (damage >= 250)
+						{
+							damage = damage - 250;
+							infiniteShot = true;
+						}
 					}
 
-					if (collided)
+					int armorleft = enemy[b].armorleft;
+
+					temp = enemy[b].linknum;
+					if (temp == 0)
+						temp = 255;
+
+					if (enemy[b].armorleft < 255)
 					{
-						if (chain > 0)
-						{
-							shotMultiPos[SHOT_MISC] = 0;
-							b = player_shot_create(0, SHOT_MISC, tempShotX, tempShotY, mouseX, mouseY, chain, playerNum);
-							shotAvail[z] = 0;
-							goto draw_player_shot_loop_end;
-						}
+						for (unsigned int i = 0; i < COUNTOF(boss_bar); i++)
+							if (temp == boss_bar[i].link_num)
+								boss_bar[i].color = 6;
 
-						infiniteShot = false;
+						if (enemy[b].enemyground)
+							enemy[b].filter = temp2;
 
-						if (damage == 99)
+						for (unsigned int e = slot_pool_next_live(&enemyPool, 0, COUNTOF(enemy)); e < COUNTOF(enemy); e = slot_pool_next_live(&enemyPool, e + 1, COUNTOF(enemy)))
 						{
-							damage = 0;
-							doIced = 40;
-							enemy[b].iced = 40;
-						}
-						else
-						{
-							doIced = 0;
-							if (damage >= 250)
+							if (enemy[e].linknum == temp &&
+							    enemy[e].enemyground != 0)
 							{
-								damage = damage - 250;
-								infiniteShot = true;
+								if (doIced)
+									enemy[e].iced = doIced;
+								enemy[e].filter = temp2;
 							}
 						}
+					}
 
-						int armorleft = enemy[b].armorleft;
-
-						temp = enemy[b].linknum;
-						if (temp == 0)
-							temp = 255;
-
-						if (enemy[b].armorleft < 255)
+					if (armorleft > damage)
+					{
+						if (z != MAX_PWEAPON - 1)
 						{
-							for (unsigned int i = 0; i < COUNTOF(boss_bar); i++)
-								if (temp == boss_bar[i].link_num)
-									boss_bar[i].color = 6;
-
-							if (enemy[b].enemyground)
-								enemy[b].filter = temp2;
-
-							for (unsigned int e = 0; e < COUNTOF(enemy); e++)
+							if (enemy[b].armorleft != 255)
 							{
-								if (enemy[e].linknum == temp &&
-								    enemyAvail[e] != 1 &&
-								    enemy[e].enemyground != 0)
-								{
-									if (doIced)
-										enemy[e].iced = doIced;
-									enemy[e].filter = temp2;
-								}
+								enemy[b].armorleft -= damage;
+								JE_setupExplosion(tempShotX, tempShotY, 0, 0, false, false);
+							}
+							else
+							{
+								JE_doSP(tempShotX + 6, tempShotY + 6, damage / 2 + 3, damage / 4 + 2, temp2);
 							}
 						}
 
-						if (armorleft > damage)
+						soundQueue[5] = S_ENEMY_HIT;
+
+						if ((armorleft - damage <= enemy[b].edlevel) &&
+						    ((!enemy[b].edamaged) ^ (enemy[b].edani < 0)))
 						{
-							if (z != MAX_PWEAPON - 1)
+
+							for (temp3 = slot_pool_next_live(&enemyPool, 0, 100); temp3 < 100; temp3 = slot_pool_next_live(&enemyPool, temp3 + 1, 100))
 							{
-								if (enemy[b].armorleft != 255)
-								{
-									enemy[b].armorleft -= damage;
-									JE_setupExplosion(tempShotX, tempShotY, 0, 0, false, false);
-								}
-								else
+								int linknum = enemy[temp3].linknum;
+								if (
+								     (temp3 == b) ||
+								     (
+								       (temp != 255) &&
+								       (
+								         ((enemy[temp3].edlevel > 0) && (linknum == temp)) ||
+								         (
+								           (enemyContinualDamage && (temp - 100 == linknum)) ||
+								           ((linknum > 40) && (linknum / 20 == temp / 20) && (linknum <= temp))
+								         )
+								       )
+								     )
+								   )
 								{
-									JE_doSP(tempShotX + 6, tempShotY + 6, damage / 2 + 3, damage / 4 + 2, temp2);
-								}
-							}
+									enemy[temp3].enemycycle = 1;
 
-							soundQueue[5] = S_ENEMY_HIT;
+									enemy[temp3].edamaged = !enemy[temp3].edamaged;
 
-							if ((armorleft - damage <= enemy[b].edlevel) &&
-							    ((!enemy[b].edamaged) ^ (enemy[b].edani < 0)))
-							{
+									if (enemy[temp3].edani != 0)
+									{
+										enemy[temp3].ani = abs(enemy[temp3].edani);
+										enemy[temp3].aniactive = 1;
+										enemy[temp3].animax = 0;
+										enemy[temp3].animin = enemy[temp3].edgr;
+										enemy[temp3].enemycycle = enemy[temp3].animin - 1;
 
-								for (temp3 = 0; temp3 < 100; temp3++)
-								{
-									if (enemyAvail[temp3] != 1)
+									}
+									else if (enemy[temp3].edgr > 0)
 									{
-										int linknum = enemy[temp3].linknum;
-										if (
-										     (temp3 == b) ||
-										     (
-										       (temp != 255) &&
-										       (
-										         ((enemy[temp3].edlevel > 0) && (linknum == temp)) ||
-										         (
-										           (enemyContinualDamage && (temp - 100 == linknum)) ||
-										           ((linknum > 40) && (linknum / 20 == temp / 20) && (linknum <= temp))
-										         )
-										       )
-										     )
-										   )
-										{
-											enemy[temp3].enemycycle = 1;
-
-											enemy[temp3].edamaged = !enemy[temp3].edamaged;
-
-											if (enemy[temp3].edani != 0)
-											{
-												enemy[temp3].ani = abs(enemy[temp3].edani);
-												enemy[temp3].aniactive = 1;
-												enemy[temp3].animax = 0;
-												enemy[temp3].animin = enemy[temp3].edgr;
-												enemy[temp3].enemycycle = enemy[temp3].animin - 1;
-
-											}
-											else if (enemy[temp3].edgr > 0)
-											{
-												enemy[temp3].egr[1-1] = enemy[temp3].edgr;
-												enemy[temp3].ani = 1;
-												enemy[temp3].aniactive = 0;
-												enemy[temp3].animax = 0;
-												enemy[temp3].animin = 1;
-											}
-											else
-											{
-												enemyAvail[temp3] = 1;
-												enemyKilled++;
-											}
-
-											enemy[temp3].aniwhenfire = 0;
-
-											if (enemy[temp3].armorleft > (unsigned char)enemy[temp3].edlevel)
-												enemy[temp3].armorleft = enemy[temp3].edlevel;
-
-											JE_integer tempX = enemy[temp3].ex + enemy[temp3].mapoffset;
-											JE_integer tempY = enemy[temp3].ey;
-
-											if (enemyDat[enemy[temp3].enemytype].esize != 1)
-												JE_setupExplosion(tempX, tempY - 6, 0, 1, false, false);
-											else
-												JE_setupExplosionLarge(enemy[temp3].enemyground, enemy[temp3].explonum / 2, tempX, tempY);
-										}
+										enemy[temp3].egr[1-1] = enemy[temp3].edgr;
+										enemy[temp3].ani = 1;
+										enemy[temp3].aniactive = 0;
+										enemy[temp3].animax = 0;
+										enemy[temp3].animin = 1;
 									}
+									else
+									{
+										enemy_set_avail(temp3, 1);
+										enemyKilled++;
+									}
+
+									enemy[temp3].aniwhenfire = 0;
+
+									if (enemy[temp3].armorleft > (unsigned char)enemy[temp3].edlevel)
+										enemy[temp3].armorleft = enemy[temp3].edlevel;
+
+									JE_integer tempX = enemy[temp3].ex + enemy[temp3].mapoffset;
+									JE_integer tempY = enemy[temp3].ey;
+
+									if (enemyDat[enemy[temp3].enemytype].esize != 1)
+										JE_setupExplosion(tempX, tempY - 6, 0, 1, false, false);
+									else
+										JE_setupExplosionLarge(enemy[temp3].enemyground, enemy[temp3].explonum / 2, tempX, tempY);
 								}
 							}
 						}
-						else
-						{
+					}
+					else
+					{
 
-							if ((temp == 254) && (superEnemy254Jump > 0))
-								JE_eventJump(superEnemy254Jump);
+						if ((temp == 254) && (superEnemy254Jump > 0))
+							JE_eventJump(superEnemy254Jump);
 
-							for (temp2 = 0; temp2 < 100; temp2++)
+						for (temp2 = slot_pool_next_live(&enemyPool, 0, 100); temp2 < 100; temp2 = slot_pool_next_live(&enemyPool, temp2 + 1, 100))
+						{
+							temp3 = enemy[temp2].linknum;
+							if ((temp2 == b) || (temp == 254) ||
+							    ((temp != 255) && ((temp == temp3) || (temp - 100 == temp3) ||
+							                       ((temp3 > 40) && (temp3 / 20 == temp / 20) && (temp3 <= temp)))))
 							{
-								if (enemyAvail[temp2] != 1)
-								{
-									temp3 = enemy[temp2].linknum;
-									if ((temp2 == b) || (temp == 254) ||
-									    ((temp != 255) && ((temp == temp3) || (temp - 100 == temp3) ||
-									                       ((temp3 > 40) && (temp3 / 20 == temp / 20) && (temp3 <= temp)))))
-									{
-
-										int enemy_screen_x = enemy[temp2].ex + enemy[temp2].mapoffset;
 
-										if (enemy[temp2].special)
-										{
-											assert((unsigned int) enemy[temp2].flagnum-1 < COUNTOF(globalFlags));
-											globalFlags[enemy[temp2].flagnum-1] = enemy[temp2].setto;
-										}
+								int enemy_screen_x = enemy[temp2].ex + enemy[temp2].mapoffset;
 
-										if ((enemy[temp2].enemydie > 0) &&
-										    !((superArcadeMode != SA_NONE) &&
-										      (enemyDat[enemy[temp2].enemydie].value == 30000)))
-										{
-											int temp_b = b;
-											tempW = enemy[temp2].enemydie;
-											int enemy_offset = temp2 - (temp2 % 25);
-											if (enemyDat[tempW].value > 30000)
-											{
-												enemy_offset = 0;
-											}
-											b = JE_newEnemy(enemy_offset, tempW, 0);
-											if (b != 0)
-											{
-												if ((superArcadeMode != SA_NONE) && (enemy[b-1].evalue > 30000))
-												{
-													superArcadePowerUp++;
-													if (superArcadePowerUp > 5)
-														superArcadePowerUp = 1;
-													enemy[b-1].egr[1-1] = 5 + superArcadePowerUp * 2;
-													enemy[b-1].evalue = 30000 + superArcadePowerUp;
-												}
-
-												if (enemy[b-1].evalue != 0)
-													enemy[b-1].scoreitem = true;
-												else
-													enemy[b-1].scoreitem = false;
-
-												enemy[b-1].ex = enemy[temp2].ex;
-												enemy[b-1].ey = enemy[temp2].ey;
-											}
-											b = temp_b;
-										}
+								if (enemy[temp2].special)
+								{
+									assert((unsigned int) enemy[temp2].flagnum-1 < COUNTOF(globalFlags));
+									globalFlags[enemy[temp2].flagnum-1] = enemy[temp2].setto;
+								}
 
-										if ((enemy[temp2].evalue > 0) && (enemy[temp2].evalue < 10000))
+								if ((enemy[temp2].enemydie > 0) &&
+								    !((superArcadeMode != SA_NONE) &&
+								      (enemyDat[enemy[temp2].enemydie].value == 30000)))
+								{
+									int temp_b = b;
+									tempW = enemy[temp2].enemydie;
+									int enemy_offset = temp2 - (temp2 % 25);
+									if (enemyDat[tempW].value > 30000)
+									{
+										enemy_offset = 0;
+									}
+									b = JE_newEnemy(enemy_offset, tempW, 0);
+									if (b != 0)
+									{
+										if ((superArcadeMode != SA_NONE) && (enemy[b-1].evalue > 30000))
 										{
-											if (enemy[temp2].evalue == 1)
-											{
-												cubeMax++;
-											}
-											else
-											{
-												// in galaga mode player 2 is sidekick, so give cash to player 1
-												player[galagaMode ? 0 : playerNum - 1].cash += enemy[temp2].evalue;
-											}
+											superArcadePowerUp++;
+											if (superArcadePowerUp > 5)
+												superArcadePowerUp = 1;
+											enemy[b-1].egr[1-1] = 5 + superArcadePowerUp * 2;
+											enemy[b-1].evalue = 30000 + superArcadePowerUp;
 										}
 
-										if ((enemy[temp2].edlevel == -1) && (temp == temp3))
-										{
-											enemy[temp2].edlevel = 0;
-											enemyAvail[temp2] = 2;
-											enemy[temp2].egr[1-1] = enemy[temp2].edgr;
-											enemy[temp2].ani = 1;
-											enemy[temp2].aniactive = 0;
-											enemy[temp2].animax = 0;
-											enemy[temp2].animin = 1;
-											enemy[temp2].edamaged = true;
-											enemy[temp2].enemycycle = 1;
-										}
+										if (enemy[b-1].evalue != 0)
+											enemy[b-1].scoreitem = true;
 										else
-										{
-											enemyAvail[temp2] = 1;
-											enemyKilled++;
-										}
+											enemy[b-1].scoreitem = false;
 
-										if (enemyDat[enemy[temp2].enemytype].esize == 1)
-										{
-											JE_setupExplosionLarge(enemy[temp2].enemyground, enemy[temp2].explonum, enemy_screen_x, enemy[temp2].ey);
-											soundQueue[6] = S_EXPLOSION_9;
-										}
-										else
-										{
-											JE_setupExplosion(enemy_screen_x, enemy[temp2].ey, 0, 1, false, false);
-											soundQueue[6] = S_EXPLOSION_8;
-										}
+										enemy[b-1].ex = enemy[temp2].ex;
+										enemy[b-1].ey = enemy[temp2].ey;
+									}
+									b = temp_b;
+								}
+
+								if ((enemy[temp2].evalue > 0) && (enemy[temp2].evalue < 10000))
+								{
+									if (enemy[temp2].evalue == 1)
+									{
+										cubeMax++;
+									}
+									else
+									{
+										// in galaga mode player 2 is sidekick, so give cash to player 1
+										player[galagaMode ? 0 : playerNum - 1].cash += enemy[temp2].evalue;
 									}
 								}
+
+								if ((enemy[temp2].edlevel == -1) && (temp == temp3))
+								{
+									enemy[temp2].edlevel = 0;
+									enemy_set_avail(temp2, 2);
+									enemy[temp2].egr[1-1] = enemy[temp2].edgr;
+									enemy[temp2].ani = 1;
+									enemy[temp2].aniactive = 0;
+									enemy[temp2].animax = 0;
+									enemy[temp2].animin = 1;
+									enemy[temp2].edamaged = true;
+									enemy[temp2].enemycycle = 1;
+								}
+								else
+								{
+									enemy_set_avail(temp2, 1);
+									enemyKilled++;
+								}
+
+								if (enemyDat[enemy[temp2].enemytype].esize == 1)
+								{
+									JE_setupExplosionLarge(enemy[temp2].enemyground, enemy[temp2].explonum, enemy_screen_x, enemy[temp2].ey);
+									soundQueue[6] = S_EXPLOSION_9;
+								}
+								else
+								{
+									JE_setupExplosion(enemy_screen_x, enemy[temp2].ey, 0, 1, false, false);
+									soundQueue[6] = S_EXPLOSION_8;
+								}
 							}
 						}
+					}
 
-						if (infiniteShot)
+					if (infiniteShot)
+					{
+						damage += 250;
+					}
+					else if (z != MAX_PWEAPON - 1)
+					{
+						if (damage <= armorleft)
 						{
-							damage += 250;
+							player_shot_set_avail(z, 0);
+							goto draw_player_shot_loop_end;
 						}
-						else if (z != MAX_PWEAPON - 1)
+						else
 						{
-							if (damage <= armorleft)
-							{
-								shotAvail[z] = 0;
-								goto draw_player_shot_loop_end;
-							}
-							else
-							{
-								playerShotData[z].shotDmg -= armorleft;
-							}
+							playerShotData[z].shotDmg -= armorleft;
 						}
 					}
 				}
 			}
+		}
 
 draw_player_shot_loop_end:
-			;
-		}
+		;
 	}
 
+	demo_bench_enemy_time(bench_start);  // mostly shots against enemies
+
 	/* Player movement indicators for shots that track your ship */
 	for (uint i = 0; i < COUNTOF(player); ++i)
 	{
@@ -1792,95 +1797,92 @@ draw_player_shot_loop_end:
 	{    /*MAIN DRAWING IS STOPPED STARTING HERE*/
 
 		/* Draw Enemy Shots */
-		for (int z = 0; z < ENEMY_SHOT_MAX; z++)
+		for (int z = slot_pool_next_live(&enemyShotPool, 0, ENEMY_SHOT_MAX); z < ENEMY_SHOT_MAX; z = slot_pool_next_live(&enemyShotPool, z + 1, ENEMY_SHOT_MAX))
 		{
-			if (enemyShotAvail[z] == 0)
-			{
-				enemyShot[z].sxm += enemyShot[z].sxc;
-				enemyShot[z].sx += enemyShot[z].sxm;
+			enemyShot[z].sxm += enemyShot[z].sxc;
+			enemyShot[z].sx += enemyShot[z].sxm;
 
-				if (enemyShot[z].tx != 0)
+			if (enemyShot[z].tx != 0)
+			{
+				if (enemyShot[z].sx > player[0].x)
 				{
-					if (enemyShot[z].sx > player[0].x)
-					{
-						if (enemyShot[z].sxm > -enemyShot[z].tx)
-							enemyShot[z].sxm--;
-					}
-					else
-					{
-						if (enemyShot[z].sxm < enemyShot[z].tx)
-							enemyShot[z].sxm++;
-					}
+					if (enemyShot[z].sxm > -enemyShot[z].tx)
+						enemyShot[z].sxm--;
 				}
+				else
+				{
+					if (enemyShot[z].sxm < enemyShot[z].tx)
+						enemyShot[z].sxm++;
+				}
+			}
 
-				enemyShot[z].sym += enemyShot[z].syc;
-				enemyShot[z].sy += enemyShot[z].sym;
+			enemyShot[z].sym += enemyShot[z].syc;
+			enemyShot[z].sy += enemyShot[z].sym;
 
-				if (enemyShot[z].ty != 0)
+			if (enemyShot[z].ty != 0)
+			{
+				if (enemyShot[z].sy > player[0].y)
 				{
-					if (enemyShot[z].sy > player[0].y)
-					{
-						if (enemyShot[z].sym > -enemyShot[z].ty)
-							enemyShot[z].sym--;
-					}
-					else
-					{
-						if (enemyShot[z].sym < enemyShot[z].ty)
-							enemyShot[z].sym++;
-					}
+					if (enemyShot[z].sym > -enemyShot[z].ty)
+						enemyShot[z].sym--;
 				}
-
-				if (enemyShot[z].duration-- == 0 || enemyShot[z].sy > 190 || enemyShot[z].sy <= -14 || enemyShot[z].sx > 275 || enemyShot[z].sx <= 0)
+				else
 				{
-					enemyShotAvail[z] = true;
+					if (enemyShot[z].sym < enemyShot[z].ty)
+						enemyShot[z].sym++;
 				}
-				else  // check if shot collided with player
+			}
+
+			if (enemyShot[z].duration-- == 0 || enemyShot[z].sy > 190 || enemyShot[z].sy <= -14 || enemyShot[z].sx > 275 || enemyShot[z].sx <= 0)
+			{
+				enemy_shot_set_avail(z, true);
+			}
+			else  // check if shot collided with player
+			{
+				for (uint i = 0; i < (twoPlayerMode ? 2 : 1); ++i)
 				{
-					for (uint i = 0; i < (twoPlayerMode ? 2 : 1); ++i)
+					if (player[i].is_alive &&
+					    enemyShot[z].sx > player[i].x - (signed)player[i].shot_hit_area_x &&
+					    enemyShot[z].sx < player[i].x + (signed)player[i].shot_hit_area_x &&
+					    enemyShot[z].sy > player[i].y - (signed)player[i].shot_hit_area_y &&
+					    enemyShot[z].sy < player[i].y + (signed)player[i].shot_hit_area_y)
 					{
-						if (player[i].is_alive &&
-						    enemyShot[z].sx > player[i].x - (signed)player[i].shot_hit_area_x &&
-						    enemyShot[z].sx < player[i].x + (signed)player[i].shot_hit_area_x &&
-						    enemyShot[z].sy > player[i].y - (signed)player[i].shot_hit_area_y &&
-						    enemyShot[z].sy < player[i].y + (signed)player[i].shot_hit_area_y)
-						{
-							JE_integer tempX = enemyShot[z].sx;
-							JE_integer tempY = enemyShot[z].sy;
-							temp = enemyShot[z].sdmg;
+						JE_integer tempX = enemyShot[z].sx;
+						JE_integer tempY = enemyShot[z].sy;
+						temp = enemyShot[z].sdmg;
 
-							enemyShotAvail[z] = true;
+						enemy_shot_set_avail(z, true);
 
-							JE_setupExplosion(tempX, tempY, 0, 0, false, false);
+						JE_setupExplosion(tempX, tempY, 0, 0, false, false);
 
-							if (player[i].invulnerable_ticks == 0)
+						if (player[i].invulnerable_ticks == 0)
+						{
+							if ((temp = JE_playerDamage(temp, &player[i])) > 0)
 							{
-								if ((temp = JE_playerDamage(temp, &player[i])) > 0)
-								{
-									player[i].x_velocity += (enemyShot[z].sxm * temp) / 2;
-									player[i].y_velocity += (enemyShot[z].sym * temp) / 2;
-								}
+								player[i].x_velocity += (enemyShot[z].sxm * temp) / 2;
+								player[i].y_velocity += (enemyShot[z].sym * temp) / 2;
 							}
-
-							break;
 						}
+
+						break;
 					}
+				}
 
-					if (enemyShotAvail[z] == false)
+				if (enemyShotAvail[z] == false)
+				{
+					if (enemyShot[z].animax != 0)
 					{
-						if (enemyShot[z].animax != 0)
-						{
-							if (++enemyShot[z].animate >= enemyShot[z].animax)
-								enemyShot[z].animate = 0;
-						}
-
-						if (enemyShot[z].sgr >= 500)
-							blit_sprite2(VGAScreen, enemyShot[z].sx, enemyShot[z].sy, spriteSheet12, enemyShot[z].sgr + enemyShot[z].animate - 500);
-						else
-							blit_sprite2(VGAScreen, enemyShot[z].sx, enemyShot[z].sy, spriteSheet8, enemyShot[z].sgr + enemyShot[z].animate);
+						if (++enemyShot[z].animate >= enemyShot[z].animax)
+							enemyShot[z].animate = 0;
 					}
-				}
 
+					if (enemyShot[z].sgr >= 500)
+						blit_sprite2(VGAScreen, enemyShot[z].sx, enemyShot[z].sy, spriteSheet12, enemyShot[z].sgr + enemyShot[z].animate - 500);
+					else
+						blit_sprite2(VGAScreen, enemyShot[z].sx, enemyShot[z].sy, spriteSheet8, enemyShot[z].sgr + enemyShot[z].animate);
+				}
 			}
+
 		}
 	}
 
@@ -1954,35 +1956,34 @@ draw_player_shot_loop_end:
 	}
 
 	/*---------------------------- Draw Explosions ----------------------------*/
-	for (int j = 0; j < MAX_EXPLOSIONS; j++)
+	for (int j = slot_pool_next_live(&explosionPool, 0, MAX_EXPLOSIONS); j < MAX_EXPLOSIONS; j = slot_pool_next_live(&explosionPool, j + 1, MAX_EXPLOSIONS))
 	{
-		if (explosions[j].ttl != 0)
+		if (!explosions[j].fixedPosition)
 		{
-			if (!explosions[j].fixedPosition)
-			{
-				explosions[j].sprite++;
-				explosions[j].y += explodeMove;
-			}
-			else if (explosions[j].followPlayer)
-			{
-				explosions[j].x += explosionFollowAmountX;
-				explosions[j].y += explosionFollowAmountY;
-			}
-			explosions[j].y += explosions[j].deltaY;
+			explosions[j].sprite++;
+			explosions[j].y += explodeMove;
+		}
+		else if (explosions[j].followPlayer)
+		{
+			explosions[j].x += explosionFollowAmountX;
+			explosions[j].y += explosionFollowAmountY;
+		}
+		explosions[j].y += explosions[j].deltaY;
 
-			if (explosions[j].y > 200 - 14)
-			{
-				explosions[j].ttl = 0;
-			}
+		if (explosions[j].y > 200 - 14)
+		{
+			explosions[j].ttl = 0;
+			slot_pool_set(&explosionPool, j, false);
+		}
+		else
+		{
+			if (explosionTransparent)
+				blit_sprite2_blend(VGAScreen, explosions[j].x, explosions[j].y, explosionSpriteSheet, explosions[j].sprite + 1);
 			else
-			{
-				if (explosionTransparent)
-					blit_sprite2_blend(VGAScreen, explosions[j].x, explosions[j].y, explosionSpriteSheet, explosions[j].sprite + 1);
-				else
-					blit_sprite2(VGAScreen, explosions[j].x, explosions[j].y, explosionSpriteSheet, explosions[j].sprite + 1);
+				blit_sprite2(VGAScreen, explosions[j].x, explosions[j].y, explosionSpriteSheet, explosions[j].sprite + 1);
 
-				explosions[j].ttl--;
-			}
+			if (--explosions[j].ttl == 0)
+				slot_pool_set(&explosionPool, j, false);
 		}
 	}
 
@@ -2098,6 +2099,11 @@ draw_player_shot_loop_end:
 		returnActive = false;
 	}
 
+#ifdef WITH_NETWORK
+	if (isNetworkGame && network_overlay)
+		network_draw_overlay(VGAScreen);
+#endif
+
 	/*-------      DEbug      ---------*/
 	debugTime = SDL_GetTicks();
 	tempW = lastmouse_but;
@@ -2256,6 +2262,10 @@ draw_player_shot_loop_end:
 
 			if (isNetworkGame)
 			{
+#ifdef WITH_NETWORK
+				if (network_spectating)
+					network_tyrian_halt(0, false);  // nothing to set up, so Escape just leaves
+#endif
 				inGameMenuRequest = true;
 			}
 			else
@@ -2273,33 +2283,39 @@ draw_player_shot_loop_end:
 	{
 		if (!reallyEndLevel)
 		{
-			Uint16 requests = (pauseRequest == true) |
-			                  (inGameMenuRequest == true) << 1 |
-			                  (skipLevelRequest == true) << 2 |
-			                  (nortShipRequest == true) << 3;
-			SDLNet_Write16(requests,        &packet_state_out[0]->data[14]);
-
-			SDLNet_Write16(difficultyLevel, &packet_state_out[0]->data[16]);
-			SDLNet_Write16(player[0].x,     &packet_state_out[0]->data[18]);
-			SDLNet_Write16(player[1].x,     &packet_state_out[0]->data[20]);
-			SDLNet_Write16(player[0].y,     &packet_state_out[0]->data[22]);
-			SDLNet_Write16(player[1].y,     &packet_state_out[0]->data[24]);
-			SDLNet_Write16(curLoc,          &packet_state_out[0]->data[26]);
+			// a spectator only replays the players' states
+			if (!network_spectating)
+			{
+				const Uint16 requests = (pauseRequest == true) |
+				                        (inGameMenuRequest == true) << 1 |
+				                        (skipLevelRequest == true) << 2 |
+				                        (nortShipRequest == true) << 3;
+				SDLNet_Write16(requests,        &NET_PACKET(packet_state_out, 0)->data[14]);
+
+				SDLNet_Write16(difficultyLevel, &NET_PACKET(packet_state_out, 0)->data[16]);
+				SDLNet_Write16(player[0].x,     &NET_PACKET(packet_state_out, 0)->data[18]);
+				SDLNet_Write16(player[1].x,     &NET_PACKET(packet_state_out, 0)->data[20]);
+				SDLNet_Write16(player[0].y,     &NET_PACKET(packet_state_out, 0)->data[22]);
+				SDLNet_Write16(player[1].y,     &NET_PACKET(packet_state_out, 0)->data[24]);
+				SDLNet_Write16(curLoc,          &NET_PACKET(packet_state_out, 0)->data[26]);
+			}
 
 			network_state_send();
 
 			if (network_state_update())
 			{
-				assert(SDLNet_Read16(&packet_state_in[0]->data[26]) == SDLNet_Read16(&packet_state_out[network_delay]->data[26]));
+				UDPpacket *const state_1 = network_state_of(1), *const state_2 = network_state_of(2);
+
+				assert(SDLNet_Read16(&state_1->data[26]) == SDLNet_Read16(&state_2->data[26]));
 
-				requests = SDLNet_Read16(&packet_state_in[0]->data[14]) ^ SDLNet_Read16(&packet_state_out[network_delay]->data[14]);
-				if (requests & 1)
+				const Uint16 requests = SDLNet_Read16(&state_1->data[14]) ^ SDLNet_Read16(&state_2->data[14]);
+				if ((requests & 1) && !network_spectating)
 				{
 					JE_pauseGame();
 				}
-				if (requests & 2)
+				if ((requests & 2) && !network_spectating)
 				{
-					yourInGameMenuRequest = SDLNet_Read16(&packet_state_out[network_delay]->data[14]) & 2;
+					yourInGameMenuRequest = SDLNet_Read16(&network_state_of(thisPlayerNum)->data[14]) & 2;
 					JE_doInGameSetup();
 					yourInGameMenuRequest = false;
 					if (haltGame)
@@ -2321,16 +2337,21 @@ draw_player_shot_loop_end:
 					shipGr = 1;
 				}
 
+				bool unsynchronized = false;
 				for (int i = 0; i < 2; i++)
 				{
-					if (SDLNet_Read16(&packet_state_in[0]->data[18 + i * 2]) != SDLNet_Read16(&packet_state_out[network_delay]->data[18 + i * 2]) || SDLNet_Read16(&packet_state_in[0]->data[20 + i * 2]) != SDLNet_Read16(&packet_state_out[network_delay]->data[20 + i * 2]))
+					if (SDLNet_Read16(&state_1->data[18 + i * 2]) != SDLNet_Read16(&state_2->data[18 + i * 2]) || SDLNet_Read16(&state_1->data[20 + i * 2]) != SDLNet_Read16(&state_2->data[20 + i * 2]))
 					{
+						unsynchronized = true;
+
 						char temp[64];
 						sprintf(temp, "Player %d is unsynchronized!", i + 1);
 
 						JE_textShade(game_screen, 40, 110 + i * 10, temp, 9, 2, FULL_SHADE);
 					}
 				}
+				if (unsynchronized)
+					network_stats.desyncs++;
 			}
 		}
 
@@ -2451,22 +2472,11 @@ new_game:
 	{
 		do
 		{
-			FILE *ep_f = dir_fopen_die(data_dir(), episode_file, "rb");
-
 			jumpSection = false;
 			loadLevelOk = false;
 
 			/* Seek Section # Mainlevel */
-			int x = 0;
-			while (x < mainLevel)
-			{
-				read_encrypted_pascal_string(s, sizeof(s), ep_f);
-				if (s[0] == '*')
-				{
-					x++;
-					s[0] = ' ';
-				}
-			}
+			size_t ep_line = episode_script_seek(mainLevel);
 
 			ESCPressed = false;
 
@@ -2474,8 +2484,6 @@ new_game:
 			{
 				if (gameLoaded)
 				{
-					fclose(ep_f);
-
 					if (mainLevel == 0)  // if quit itemscreen
 						return;          // back to title screen
 					else
@@ -2483,7 +2491,7 @@ new_game:
 				}
 
 				strcpy(s, " ");
-				read_encrypted_pascal_string(s, sizeof(s), ep_f);
+				episode_script_read(&ep_line, s, sizeof(s));
 
 				if (s[0] == ']')
 				{
@@ -2623,7 +2631,7 @@ new_game:
 
 						for (int i = 0; i < 9; ++i)
 						{
-							read_encrypted_pascal_string(s, sizeof(s), ep_f);
+							episode_script_read(&ep_line, s, sizeof(s));
 
 							char buf[256];
 							strncpy(buf, (strlen(s) > 8) ? s + 8 : "", sizeof(buf));
@@ -2674,17 +2682,17 @@ new_game:
 							levelWarningLines = 2;
 						}
 
-						for (x = 0; x < temp - 1; x++)
+						for (int x = 0; x < temp - 1; x++)
 						{
 							do
 							{
-								read_encrypted_pascal_string(s, sizeof(s), ep_f);
+								episode_script_read(&ep_line, s, sizeof(s));
 							} while (s[0] != '#');
 						}
 
 						do
 						{
-							read_encrypted_pascal_string(s, sizeof(s), ep_f);
+							episode_script_read(&ep_line, s, sizeof(s));
 							strcpy(levelWarningText[levelWarningLines], s);
 							levelWarningLines++;
 						} while (s[0] != '#');
@@ -2976,7 +2984,7 @@ new_game:
 
 								do
 								{
-									read_encrypted_pascal_string(s, sizeof(s), ep_f);
+									episode_script_read(&ep_line, s, sizeof(s));
 
 									if (s[0] != '#')
 									{
@@ -3002,7 +3010,7 @@ new_game:
 					case 'h':
 						if (initialDifficulty > DIFFICULTY_NORMAL)
 						{
-							read_encrypted_pascal_string(s, sizeof(s), ep_f);
+							episode_script_read(&ep_line, s, sizeof(s));
 						}
 						break;
 
@@ -3045,8 +3053,6 @@ new_game:
 
 			} while (!(loadLevelOk || jumpSection));
 
-			fclose(ep_f);
-
 		} while (!loadLevelOk);
 	}
 
@@ -3220,12 +3226,24 @@ new_game:
 #ifdef WITH_NETWORK
 void networkStartScreen(void)
 {
+	const char *waiting = network_spectating ? "Waiting for the game to start." : "Waiting for other player.";
+
 	JE_loadPic(VGAScreen, 2, false);
 	memcpy(VGAScreen2->pixels, VGAScreen->pixels, VGAScreen2->pitch * VGAScreen2->h);
-	JE_dString(VGAScreen, JE_fontCenter("Waiting for other player.", SMALL_FONT_SHAPES), 140, "Waiting for other player.", SMALL_FONT_SHAPES);
+	JE_dString(VGAScreen, JE_fontCenter(waiting, SMALL_FONT_SHAPES), 140, waiting, SMALL_FONT_SHAPES);
 	JE_showVGA();
 	fade_palette(colors, 10, 0, 255);
 
+	if (network_spectating)
+	{
+		// the host's keyframe has everything the menus would have chosen
+		network_spectate_join();
+
+		twoPlayerMode = true;
+		fade_black(10);
+		return;
+	}
+
 	network_connect();
 
 	twoPlayerMode = true;
@@ -3264,7 +3282,7 @@ void networkStartScreen(void)
 			service_SDL_events(false);
 			JE_showVGA();
 
-			if (packet_in[0] && SDLNet_Read16(&packet_in[0]->data[0]) == PACKET_DETAILS)
+			if (NET_PACKET(packet_in, 0) && SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[0]) == PACKET_DETAILS)
 				break;
 
 			network_update();
@@ -3273,8 +3291,8 @@ void networkStartScreen(void)
 			SDL_Delay(16);
 		}
 
-		JE_initEpisode(SDLNet_Read16(&packet_in[0]->data[4]));
-		difficultyLevel = SDLNet_Read16(&packet_in[0]->data[6]);
+		JE_initEpisode(SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[4]));
+		difficultyLevel = SDLNet_Read16(&NET_PACKET(packet_in, 0)->data[6]);
 		initialDifficulty = difficultyLevel - 1;
 		fade_black(10);
 
@@ -4166,16 +4184,12 @@ void JE_displayText(void)
 
 Sint16 JE_newEnemy(int enemyOffset, Uint16 eDatI, Sint16 uniqueShapeTableI)
 {
-	for (int i = enemyOffset; i < enemyOffset + 25; ++i)
-	{
-		if (enemyAvail[i] == 1)
-		{
-			enemyAvail[i] = JE_makeEnemy(&enemy[i], eDatI, uniqueShapeTableI);
-			return i + 1;
-		}
-	}
-	
-	return 0;
+	const unsigned int i = slot_pool_next_free(&enemyPool, enemyOffset, enemyOffset + 25);
+	if (i == enemyOffset + 25u)
+		return 0;
+
+	enemy_set_avail(i, JE_makeEnemy(&enemy[i], eDatI, uniqueShapeTableI));
+	return i + 1;
 }
 
 uint JE_makeEnemy(struct JE_SingleEnemyType *enemy, Uint16 eDatI, Sint16 uniqueShapeTableI)
@@ -4470,27 +4484,20 @@ uint JE_makeEnemy(struct JE_SingleEnemyType *enemy, Uint16 eDatI, Sint16 uniqueS
 	return avail;
 }
 
-void JE_createNewEventEnemy(JE_byte enemyTypeOfs, JE_word enemyOffset, Sint16 uniqueShapeTableI)
+static void create_event_enemy(JE_byte enemyTypeOfs, JE_word enemyOffset, Sint16 uniqueShapeTableI)
 {
-	int i;
-
 	b = 0;
 
-	for (i = enemyOffset; i < enemyOffset + 25; i++)
-	{
-		if (enemyAvail[i] == 1)
-		{
-			b = i + 1;
-			break;
-		}
-	}
+	const unsigned int i = slot_pool_next_free(&enemyPool, enemyOffset, enemyOffset + 25);
+	if (i < enemyOffset + 25u)
+		b = i + 1;
 
 	if (b == 0)
 		return;
 
 	tempW = eventRec[eventLoc-1].eventdat + enemyTypeOfs;
 
-	enemyAvail[b-1] = JE_makeEnemy(&enemy[b-1], tempW, uniqueShapeTableI);
+	enemy_set_avail(b-1, JE_makeEnemy(&enemy[b-1], tempW, uniqueShapeTableI));
 
 	// When T2000 gives an X position of -200, what it actually wants is a random X position...
 	if (eventRec[eventLoc-1].eventdat2 == -200)
@@ -4540,6 +4547,14 @@ void JE_createNewEventEnemy(JE_byte enemyTypeOfs, JE_word enemyOffset, Sint16 un
 	enemy[b-1].fixedmovey = eventRec[eventLoc-1].eventdat6;
 }
 
+void JE_createNewEventEnemy(JE_byte enemyTypeOfs, JE_word enemyOffset, Sint16 uniqueShapeTableI)
+{
+	// the demo benchmark can crowd the screen by spawning every enemy more than once
+	const int copies = demo_bench_passes > 0 ? demo_bench_crowd : 1;
+	for (int copy = 0; copy < copies; ++copy)
+		create_event_enemy(enemyTypeOfs, enemyOffset, uniqueShapeTableI);
+}
+
 void JE_eventJump(JE_word jump)
 {
 	JE_word tempW;
@@ -4565,7 +4580,7 @@ bool JE_searchFor/*enemy*/(JE_byte PLType, JE_byte* out_index)
 {
 	int found_id = -1;
 
-	for (int i = 0; i < 100; i++)
+	for (int i = slot_pool_next_live(&enemyPool, 0, 100); i < 100; i = slot_pool_next_live(&enemyPool, i + 1, 100))
 	{
 		if (enemyAvail[i] == 0 && enemy[i].linknum == PLType)
 		{
@@ -4660,7 +4675,7 @@ void JE_eventSystem(void)
 					if (newEnemyShapeTables[i] > 0)
 					{
 						assert(newEnemyShapeTables[i] <= COUNTOF(shapeFile));
-						JE_loadCompShapes(&enemySpriteSheets[i], shapeFile[newEnemyShapeTables[i] - 1]);
+						load_enemy_sprite2s(&enemySpriteSheets[i], shapeFile[newEnemyShapeTables[i] - 1]);
 					}
 					else
 						free_sprite2s(&enemySpriteSheets[i]);
@@ -4846,10 +4861,9 @@ void JE_eventSystem(void)
 		if (eventRec[eventLoc-1].eventdat3 > 79 && eventRec[eventLoc-1].eventdat3 < 90)
 			eventRec[eventLoc-1].eventdat4 = newPL[eventRec[eventLoc-1].eventdat3 - 80];
 
-		for (temp = 0; temp < 100; temp++)
+		for (temp = slot_pool_next_live(&enemyPool, 0, 100); temp < 100; temp = slot_pool_next_live(&enemyPool, temp + 1, 100))
 		{
-			if (enemyAvail[temp] != 1 &&
-			    (enemy[temp].linknum == eventRec[eventLoc-1].eventdat4 || eventRec[eventLoc-1].eventdat4 == 0))
+			if (enemy[temp].linknum == eventRec[eventLoc-1].eventdat4 || eventRec[eventLoc-1].eventdat4 == 0)
 			{
 				if (eventRec[eventLoc-1].eventdat != -99)
 				{
@@ -5098,12 +5112,12 @@ void JE_eventSystem(void)
 	case 41:
 		if (eventRec[eventLoc-1].eventdat == 0)
 		{
-			memset(enemyAvail, 1, sizeof(enemyAvail));
+			enemy_free_all();
 		}
 		else
 		{
 			for (x = 0; x <= 24; x++)
-				enemyAvail[x] = 1;
+				enemy_set_avail(x, 1);
 		}
 		break;
 
@@ -5266,7 +5280,7 @@ void JE_eventSystem(void)
 					enemy[b-1].ey = enemy[temp].ey;
 				}
 
-				enemyAvail[temp] = 1;
+				enemy_set_avail(temp, 1);
 			}			
 		}
 		break;
@@ -5384,7 +5398,7 @@ void JE_eventSystem(void)
 	case 75:;
 		bool temp_no_clue = false; // TODO: figure out what this is doing
 
-		for (temp = 0; temp < 100; temp++)
+		for (temp = slot_pool_next_live(&enemyPool, 0, 100); temp < 100; temp = slot_pool_next_live(&enemyPool, temp + 1, 100))
 		{
 			if (enemyAvail[temp] == 0 &&
 			    enemy[temp].eyc == 0 &&
@@ -5592,9 +5606,9 @@ void draw_boss_bar(void)
 
 		unsigned int armor = 256;  // higher than armor max
 
-		for (unsigned int e = 0; e < COUNTOF(enemy); e++)  // find most damaged
+		for (unsigned int e = slot_pool_next_live(&enemyPool, 0, COUNTOF(enemy)); e < COUNTOF(enemy); e = slot_pool_next_live(&enemyPool, e + 1, COUNTOF(enemy)))  // find most damaged
 		{
-			if (enemyAvail[e] != 1 && enemy[e].linknum == boss_bar[b].link_num)
+			if (enemy[e].linknum == boss_bar[b].link_num)
 				if (enemy[e].armorleft < armor)
 					armor = enemy[e].armorleft;
 		}
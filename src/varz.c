@@ -31,11 +31,14 @@
 #include "nortsong.h"
 #include "nortvars.h"
 #include "opentyr.h"
+#include "preload.h"
 #include "shots.h"
 #include "sprite.h"
 #include "vga256d.h"
 #include "video.h"
 
+#include <string.h>
+
 JE_integer tempDat, tempDat2, tempDat3;
 
 const JE_byte SANextShip[SA + 2] /* [0..SA + 1] */ = { 3, 8, 6, 2, 5, 1, 4, 10, 9, 7, 3 };
@@ -262,6 +265,7 @@ JE_boolean skipStarShowVGA;
 /*EnemyData*/
 JE_MultiEnemyType enemy;
 JE_EnemyAvailType enemyAvail;  /* values: 0: used, 1: free, 2: secret pick-up */
+SlotPool enemyPool;
 JE_word enemyOffset;
 JE_word enemyOnScreen;
 JE_word superEnemy254Jump;
@@ -270,6 +274,7 @@ JE_word superEnemy254Jump;
 JE_boolean fireButtonHeld;
 JE_boolean enemyShotAvail[ENEMY_SHOT_MAX]; /* [1..Enemyshotmax] */
 EnemyShotType enemyShot[ENEMY_SHOT_MAX]; /* [1..Enemyshotmax]  */
+SlotPool enemyShotPool;
 
 /* Player Shot Data */
 JE_byte     zinglonDuration;
@@ -299,6 +304,7 @@ JE_word neat;
 
 /*ExplosionData*/
 Explosion explosions[MAX_EXPLOSIONS]; /* [1..ExplosionMax] */
+SlotPool explosionPool;  /* ttl != 0 */
 JE_integer explosionFollowAmountX, explosionFollowAmountY;
 
 /*Repeating Explosions*/
@@ -445,6 +451,8 @@ void JE_drawOptionLevel(void)
 
 void JE_tyrianHalt(JE_byte code)
 {
+	preload_halting();
+
 	deinit_audio();
 	deinit_video();
 	deinit_joysticks();
@@ -456,6 +464,7 @@ void JE_tyrianHalt(JE_byte code)
 	free_sprite2s(&shopSpriteSheet);
 	free_sprite2s(&explosionSpriteSheet);
 	free_sprite2s(&destructSpriteSheet);
+	free_enemy_sheet_cache();
 
 	for (int i = 0; i < SOUND_COUNT; i++)
 	{
@@ -520,20 +529,17 @@ void JE_specialComplete(JE_byte playerNum, JE_byte specialType)
 			break;
 		/*Repulsor*/
 		case 2:
-			for (temp = 0; temp < ENEMY_SHOT_MAX; temp++)
+			for (temp = slot_pool_next_live(&enemyShotPool, 0, ENEMY_SHOT_MAX); temp < ENEMY_SHOT_MAX; temp = slot_pool_next_live(&enemyShotPool, temp + 1, ENEMY_SHOT_MAX))
 			{
-				if (!enemyShotAvail[temp])
-				{
-					if (player[0].x > enemyShot[temp].sx)
-						enemyShot[temp].sxm--;
-					else if (player[0].x < enemyShot[temp].sx)
-						enemyShot[temp].sxm++;
-
-					if (player[0].y > enemyShot[temp].sy)
-						enemyShot[temp].sym--;
-					else if (player[0].y < enemyShot[temp].sy)
-						enemyShot[temp].sym++;
-				}
+				if (player[0].x > enemyShot[temp].sx)
+					enemyShot[temp].sxm--;
+				else if (player[0].x < enemyShot[temp].sx)
+					enemyShot[temp].sxm++;
+
+				if (player[0].y > enemyShot[temp].sy)
+					enemyShot[temp].sym--;
+				else if (player[0].y < enemyShot[temp].sy)
+					enemyShot[temp].sym++;
 			}
 			break;
 		/*Zinglon Blast*/
@@ -544,10 +550,9 @@ void JE_specialComplete(JE_byte playerNum, JE_byte specialType)
 			break;
 		/*Attractor*/
 		case 4:
-			for (temp = 0; temp < 100; temp++)
+			for (temp = slot_pool_next_live(&enemyPool, 0, 100); temp < 100; temp = slot_pool_next_live(&enemyPool, temp + 1, 100))
 			{
-				if (enemyAvail[temp] != 1 && enemy[temp].scoreitem &&
-				    enemy[temp].evalue != 0)
+				if (enemy[temp].scoreitem && enemy[temp].evalue != 0)
 				{
 					if (player[0].x > enemy[temp].ex)
 						enemy[temp].exc++;
@@ -772,7 +777,7 @@ void JE_doSpecialShot(JE_byte playerNum, uint *armor, uint *shield)
 	if (astralDuration > 0)
 		astralDuration--;
 
-	shotAvail[MAX_PWEAPON-1] = 0;
+	player_shot_set_avail(MAX_PWEAPON-1, 0);
 	if (flareDuration > 1)
 	{
 		if (specialWeaponFilter != -99)
@@ -866,11 +871,36 @@ void JE_doSpecialShot(JE_byte playerNum, uint *armor, uint *shield)
 		zinglonDuration--;
 		if (zinglonDuration % 5 == 0)
 		{
-			shotAvail[MAX_PWEAPON-1] = 1;
+			player_shot_set_avail(MAX_PWEAPON-1, 1);
 		}
 	}
 }
 
+void enemy_set_avail(unsigned int i, JE_byte avail)
+{
+	enemyAvail[i] = avail;
+	slot_pool_set(&enemyPool, i, avail != 1);
+}
+
+void enemy_free_all(void)
+{
+	memset(enemyAvail, 1, sizeof(enemyAvail));
+	slot_pool_clear(&enemyPool);
+}
+
+void enemy_shot_set_avail(unsigned int i, JE_boolean avail)
+{
+	enemyShotAvail[i] = avail;
+	slot_pool_set(&enemyShotPool, i, !avail);
+}
+
+void enemy_shot_free_all(void)
+{
+	for (uint i = 0; i < COUNTOF(enemyShotAvail); i++)
+		enemyShotAvail[i] = 1;
+	slot_pool_clear(&enemyShotPool);
+}
+
 void JE_setupExplosion(
 	JE_integer x,
 	JE_integer y,
@@ -941,28 +971,26 @@ void JE_setupExplosion(
 
 	if (y > -16 && y < 190)
 	{
-		for (int i = 0; i < MAX_EXPLOSIONS; i++)
+		const unsigned int i = slot_pool_next_free(&explosionPool, 0, MAX_EXPLOSIONS);
+		if (i < MAX_EXPLOSIONS)
 		{
-			if (explosions[i].ttl == 0)
+			explosions[i].x = x;
+			explosions[i].y = y;
+			if (type == 6)
 			{
-				explosions[i].x = x;
-				explosions[i].y = y;
-				if (type == 6)
-				{
-					explosions[i].y += 12;
-					explosions[i].x += 2;
-				}
-				else if (type == 98 || type == 198)
-				{
-					type = 6;
-				}
-				explosions[i].sprite = explosion_data[type].sprite;
-				explosions[i].ttl = explosion_data[type].ttl;
-				explosions[i].followPlayer = followPlayer;
-				explosions[i].fixedPosition = fixedPosition;
-				explosions[i].deltaY = deltaY;
-				break;
+				explosions[i].y += 12;
+				explosions[i].x += 2;
+			}
+			else if (type == 98 || type == 198)
+			{
+				type = 6;
 			}
+			explosions[i].sprite = explosion_data[type].sprite;
+			explosions[i].ttl = explosion_data[type].ttl;
+			explosions[i].followPlayer = followPlayer;
+			explosions[i].fixedPosition = fixedPosition;
+			explosions[i].deltaY = deltaY;
+			slot_pool_set(&explosionPool, i, explosions[i].ttl != 0);
 		}
 	}
 }
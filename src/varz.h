@@ -22,6 +22,7 @@
 #include "episodes.h"
 #include "opentyr.h"
 #include "player.h"
+#include "slot_pool.h"
 #include "sprite.h"
 
 #include <stdbool.h>
@@ -51,6 +52,9 @@ enum
 #define MAX_REPEATING_EXPLOSIONS 20
 #define MAX_SUPERPIXELS          101
 
+/* All 100 enemies take about 15 KB, which stays in L1 through a frame; moving the
+   fields the per-frame passes read into an array of their own measured within noise
+   (tools/enemy_layout_bench.c), so the record stays whole. */
 struct JE_SingleEnemyType
 {
 	JE_byte     fillbyte;
@@ -281,14 +285,17 @@ extern JE_boolean moveTyrianLogoUp;
 extern JE_boolean skipStarShowVGA;
 extern JE_MultiEnemyType enemy;
 extern JE_EnemyAvailType enemyAvail;
+extern SlotPool enemyPool;
 extern JE_word enemyOffset;
 extern JE_word enemyOnScreen;
 extern JE_word superEnemy254Jump;
 extern Explosion explosions[MAX_EXPLOSIONS];
+extern SlotPool explosionPool;
 extern JE_integer explosionFollowAmountX, explosionFollowAmountY;
 extern JE_boolean fireButtonHeld;
 extern JE_boolean enemyShotAvail[ENEMY_SHOT_MAX];
 extern EnemyShotType enemyShot[ENEMY_SHOT_MAX];
+extern SlotPool enemyShotPool;
 extern JE_byte zinglonDuration;
 extern JE_byte astralDuration;
 extern JE_word flareDuration;
@@ -339,6 +346,13 @@ void JE_doSpecialShot(JE_byte playernum, uint *armor, uint *shield);
 void JE_wipeShieldArmorBars(void);
 JE_byte JE_playerDamage(JE_byte temp, Player *);
 
+/* enemyAvail and enemyShotAvail are only written through these, so that their pools
+   (live slots: enemyAvail != 1, enemyShotAvail false) stay in step. */
+void enemy_set_avail(unsigned int i, JE_byte avail);
+void enemy_free_all(void);
+void enemy_shot_set_avail(unsigned int i, JE_boolean avail);
+void enemy_shot_free_all(void);
+
 void JE_setupExplosion(JE_integer x, JE_integer y, JE_integer deltaY, JE_integer type, bool fixedPosition, bool followPlayer);
 void JE_setupExplosionLarge(JE_boolean enemyground, JE_byte explonum, JE_integer x, JE_integer y);
 
@@ -66,6 +66,7 @@ static int window_get_display_index(void);
 static void window_center_in_display(int display_index);
 static void calc_dst_render_rect(SDL_Surface *src_surface, SDL_Rect *dst_rect);
 static void scale_and_flip(SDL_Surface *);
+static void present_texture(SDL_Surface *);
 
 void init_video(void)
 {
@@ -343,41 +344,11 @@ void JE_clr256(SDL_Surface *screen)
 	SDL_FillRect(screen, NULL, 0);
 }
 
-bool video_save_surface_rgb(SDL_Surface *surface, const char *path)
+/** Presents the frame last shown again, without scaling a new one or counting it as a
+    frame, so the window keeps up with resizes while the game is held up. */
+void video_present_last_frame(void)
 {
-	if (surface == NULL || path == NULL || path[0] == '\0')
-		return false;
-
-	SDL_Surface *rgb = SDL_CreateRGBSurfaceWithFormat(0, surface->w, surface->h, 32, SDL_PIXELFORMAT_ARGB8888);
-	if (rgb == NULL)
-		return false;
-
-	Uint32 map_cache[256];
-	for (uint i = 0; i < COUNTOF(map_cache); ++i)
-		map_cache[i] = SDL_MapRGB(rgb->format, colors[i].r, colors[i].g, colors[i].b);
-
-	if (SDL_MUSTLOCK(surface))
-		SDL_LockSurface(surface);
-	if (SDL_MUSTLOCK(rgb))
-		SDL_LockSurface(rgb);
-
-	for (int y = 0; y < surface->h; ++y)
-	{
-		const Uint8 *src = (const Uint8 *)surface->pixels + y * surface->pitch;
-		Uint32 *dst = (Uint32 *)((Uint8 *)rgb->pixels + y * rgb->pitch);
-
-		for (int x = 0; x < surface->w; ++x)
-			dst[x] = map_cache[src[x]];
-	}
-
-	if (SDL_MUSTLOCK(rgb))
-		SDL_UnlockSurface(rgb);
-	if (SDL_MUSTLOCK(surface))
-		SDL_UnlockSurface(surface);
-
-	const int result = SDL_SaveBMP(rgb, path);
-	SDL_FreeSurface(rgb);
-	return result == 0;
+	present_texture(VGAScreen);
 }
 
 SDL_Renderer *video_get_renderer(void)
@@ -492,6 +463,12 @@ static void scale_and_flip(SDL_Surface *src_surface)
 	assert(scaler_function != NULL);
 	scaler_function(src_surface, main_window_texture);
 
+	present_texture(src_surface);
+}
+
+/** Blits the output texture, as last scaled from a surface the size of src_surface, to the window. */
+static void present_texture(SDL_Surface *src_surface)
+{
 	SDL_Rect dst_rect;
 	calc_dst_render_rect(src_surface, &dst_rect);
 
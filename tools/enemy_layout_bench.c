@@ -0,0 +1,152 @@
+/*
+ * Tyrian 3000: Enemy Layout Benchmark
+ * Copyright (C) 2026  Gary Perrigo
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+/* Times the per-frame enemy passes over the enemy array as the game lays it out
+   (one JE_SingleEnemyType per enemy) against a split that keeps the fields those
+   passes read every frame in an array of their own:
+
+     cc -std=iso9899:1999 -O2 -Isrc $(pkg-config --cflags sdl2) -o enemy_layout_bench tools/enemy_layout_bench.c
+     ./enemy_layout_bench [frames]
+
+   Each frame moves every live enemy (position, speed, random acceleration and
+   animation cycle) and tests every player shot against it (position, map offset,
+   armor and link), as JE_drawEnemy and the shot and player collision passes do.
+   The figures are only a guide; the demo benchmark (--bench-demos) times the real
+   passes on the real levels. */
+
+#include "varz.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define ENEMIES 100
+#define SHOTS   40
+#define REPEATS 5
+
+/* the fields the split moves out of JE_SingleEnemyType */
+typedef struct
+{
+	JE_integer  ex, ey;
+	JE_word     mapoffset;
+	JE_shortint exc, eyc;
+	JE_byte     armorleft;
+	JE_byte     enemycycle;
+	JE_byte     linknum;
+} EnemyHot;
+
+static struct JE_SingleEnemyType whole[ENEMIES];
+static struct JE_SingleEnemyType cold[ENEMIES];
+static EnemyHot hot[ENEMIES];
+
+static bool live[ENEMIES];
+static int shot_x[SHOTS], shot_y[SHOTS];
+
+static volatile unsigned long hits_sink;
+
+/* One frame over `h` (the hot fields) and `c` (the rest); whole[] passes the same array twice. */
+#define ENEMY_FRAME(h, c, hits) \
+	do \
+	{ \
+		for (int i = 0; i < ENEMIES; ++i) \
+		{ \
+			if (!live[i]) \
+				continue; \
+			h[i].exc += c[i].exca; \
+			h[i].eyc += c[i].eyca; \
+			c[i].exca = -c[i].exca; \
+			c[i].eyca = -c[i].eyca; \
+			h[i].ex += h[i].exc; \
+			h[i].ey += h[i].eyc; \
+			if (h[i].ex < -80 || h[i].ex > 340) \
+				h[i].exc = -h[i].exc; \
+			if (h[i].ey < -112 || h[i].ey > 190) \
+				h[i].eyc = -h[i].eyc; \
+			if (++h[i].enemycycle > 4) \
+				h[i].enemycycle = 1; \
+		} \
+		for (int s = 0; s < SHOTS; ++s) \
+		{ \
+			for (int i = 0; i < ENEMIES; ++i) \
+			{ \
+				if (!live[i] || h[i].armorleft == 0) \
+					continue; \
+				if (abs(h[i].ex + h[i].mapoffset - shot_x[s]) < 13 && abs(h[i].ey - shot_y[s] - 6) < 15) \
+					hits += h[i].linknum + 1; \
+			} \
+		} \
+	} while (0)
+
+static void reset(int live_count)
+{
+	srand(7);
+	for (int i = 0; i < ENEMIES; ++i)
+	{
+		live[i] = i < live_count;
+
+		whole[i].ex = hot[i].ex = rand() % 300;
+		whole[i].ey = hot[i].ey = rand() % 190;
+		whole[i].mapoffset = hot[i].mapoffset = 0;
+		whole[i].exc = hot[i].exc = rand() % 5 - 2;
+		whole[i].eyc = hot[i].eyc = rand() % 5 - 2;
+		whole[i].exca = cold[i].exca = rand() % 3 - 1;
+		whole[i].eyca = cold[i].eyca = rand() % 3 - 1;
+		whole[i].armorleft = hot[i].armorleft = 10;
+		whole[i].enemycycle = hot[i].enemycycle = 1;
+		whole[i].linknum = hot[i].linknum = i % 3;
+	}
+	for (int s = 0; s < SHOTS; ++s)
+	{
+		shot_x[s] = rand() % 300;
+		shot_y[s] = rand() % 190;
+	}
+}
+
+static double seconds_since(clock_t start)
+{
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char *argv[])
+{
+	const long frames = argc > 1 ? atol(argv[1]) : 200000;
+	const int live_counts[] = { 20, 50, 100 };
+
+	printf("sizeof JE_SingleEnemyType %u, EnemyHot %u; best of %d runs of %ld frames, %d shots\n",
+	       (unsigned)sizeof(struct JE_SingleEnemyType), (unsigned)sizeof(EnemyHot), REPEATS, frames, SHOTS);
+	printf("  %6s %12s %12s %8s\n", "live", "whole ns", "split ns", "change");
+
+	for (unsigned int n = 0; n < COUNTOF(live_counts); ++n)
+	{
+		unsigned long hits = 0;
+		double best_whole = 1e30, best_split = 1e30;
+
+		reset(live_counts[n]);
+		for (int r = 0; r < REPEATS; ++r)
+		{
+			clock_t start = clock();
+			for (long f = 0; f < frames; ++f)
+				ENEMY_FRAME(whole, whole, hits);
+			best_whole = MIN(best_whole, seconds_since(start));
+
+			start = clock();
+			for (long f = 0; f < frames; ++f)
+				ENEMY_FRAME(hot, cold, hits);
+			best_split = MIN(best_split, seconds_since(start));
+		}
+		hits_sink = hits;
+
+		const double per = 1e9 / ((double)frames * live_counts[n]);
+		printf("  %6d %12.1f %12.1f %+7.1f%%\n", live_counts[n], best_whole * per, best_split * per,
+		       (best_split / best_whole - 1) * 100);
+	}
+
+	return 0;
+}
@@ -44,15 +44,21 @@ TOOLS: list[dict[str, Any]] = [
     },
     {
         "name": "game_state",
-        "description": "Get current game remote-control state snapshot.",
-        "inputSchema": {"type": "object", "properties": {}},
+        "description": "Get current game remote-control state snapshot. Reward deltas are since the previous game_state or game_wait of the same session.",
+        "inputSchema": {
+            "type": "object",
+            "properties": {"session": {"type": "string", "default": "mcp"}},
+        },
     },
     {
         "name": "game_wait",
-        "description": "Wait N rendered frames.",
+        "description": "Wait N rendered frames. Reward deltas are since the previous game_state or game_wait of the same session.",
         "inputSchema": {
             "type": "object",
-            "properties": {"frames": {"type": "integer", "minimum": 1}},
+            "properties": {
+                "frames": {"type": "integer", "minimum": 1},
+                "session": {"type": "string", "default": "mcp"},
+            },
             "required": ["frames"],
         },
     },
@@ -201,10 +207,10 @@ def handle_tool_call(name: str, args: dict[str, Any]) -> str:
         return run_gamectl(["ping"])
 
     if name == "game_state":
-        return run_gamectl(["game-state"])
+        return run_gamectl(["game-state", "--session", str(args.get("session", "mcp"))])
 
     if name == "game_wait":
-        return run_gamectl(["wait", str(int(args["frames"]))])
+        return run_gamectl(["wait", str(int(args["frames"])), "--session", str(args.get("session", "mcp"))])
 
     if name == "game_send_key":
         argv = ["send-key", str(args["key"])]
@@ -118,7 +118,10 @@ def cmd_launch(args: argparse.Namespace) -> int:
         cmd.append(f"--start-menu-option={args.start_menu_option}")
     if args.start_menu_enter:
         cmd.append("--start-menu-enter")
-    cmd.extend(args.extra_args)
+    extra_args = args.extra_args
+    if extra_args[:1] == ["--"]:
+        extra_args = extra_args[1:]
+    cmd.extend(extra_args)
 
     proc = subprocess.Popen(  # noqa: S603
         cmd,
@@ -189,14 +192,27 @@ def cmd_ping(args: argparse.Namespace) -> int:
 
 def cmd_game_state(args: argparse.Namespace) -> int:
     socket_path = resolve_socket(args.socket)
-    data = call_remote({"cmd": "get_state"}, socket_path, timeout=args.timeout)
+    request: dict[str, Any] = {"cmd": "get_state"}
+    if args.session:
+        request["session"] = args.session
+    data = call_remote(request, socket_path, timeout=args.timeout)
+    print(json.dumps(data, indent=2))
+    return 0
+
+
+def cmd_audio_stats(args: argparse.Namespace) -> int:
+    socket_path = resolve_socket(args.socket)
+    data = call_remote({"cmd": "audio_stats", "reset": args.reset}, socket_path, timeout=args.timeout)
     print(json.dumps(data, indent=2))
     return 0
 
 
 def cmd_wait(args: argparse.Namespace) -> int:
     socket_path = resolve_socket(args.socket)
-    data = call_remote({"cmd": "wait_frames", "frames": args.frames}, socket_path, timeout=args.timeout)
+    request: dict[str, Any] = {"cmd": "wait_frames", "frames": args.frames}
+    if args.session:
+        request["session"] = args.session
+    data = call_remote(request, socket_path, timeout=args.timeout)
     print(json.dumps(data))
     return 0
 
@@ -221,6 +237,10 @@ def cmd_send_key(args: argparse.Namespace) -> int:
 
 def cmd_send_keys(args: argparse.Namespace) -> int:
     socket_path = resolve_socket(args.socket)
+    if args.wait_between <= 0:
+        call_remote({"cmd": "send_keys", "keys": args.keys, "action": "tap"}, socket_path, timeout=args.timeout)
+        print("{\"ok\":true}")
+        return 0
     for key in args.keys:
         call_remote({"cmd": "send_key", "key": key, "action": "tap"}, socket_path, timeout=args.timeout)
         if args.wait_between > 0:
@@ -277,17 +297,25 @@ def build_parser() -> argparse.ArgumentParser:
     ping.set_defaults(func=cmd_ping)
 
     game_state = sub.add_parser("game-state", help="query game state from the remote server")
+    game_state.add_argument("--session", default=None, help="name the reward delta baseline (default: this connection)")
     game_state.add_argument("--socket", default=None)
     game_state.add_argument("--timeout", type=float, default=5.0)
     game_state.set_defaults(func=cmd_game_state)
 
+    audio_stats = sub.add_parser("audio-stats", help="query audio callback timings and underruns")
+    audio_stats.add_argument("--reset", action="store_true", help="start a new measurement after this one")
+    audio_stats.add_argument("--socket", default=None)
+    audio_stats.add_argument("--timeout", type=float, default=5.0)
+    audio_stats.set_defaults(func=cmd_audio_stats)
+
     wait = sub.add_parser("wait", help="wait for N rendered frames")
     wait.add_argument("frames", type=int)
+    wait.add_argument("--session", default=None, help="name the reward delta baseline (default: this connection)")
     wait.add_argument("--socket", default=None)
     wait.add_argument("--timeout", type=float, default=20.0)
     wait.set_defaults(func=cmd_wait)
 
-    screenshot = sub.add_parser("screenshot", help="capture a BMP screenshot")
+    screenshot = sub.add_parser("screenshot", help="capture a PNG screenshot (BMP if the path ends in .bmp)")
     screenshot.add_argument("path")
     screenshot.add_argument("--socket", default=None)
     screenshot.add_argument("--timeout", type=float, default=20.0)
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""Tyrian 3000 local netplay soak test.
+
+Runs two game instances against each other over 127.0.0.1.  Both play with
+scripted input (--net-soak) and send through the link simulator (--net-sim),
+so a run is reproducible from its seed.  Menus are pushed through with the
+remote control socket.  Each instance prints its counters when it reaches
+the requested tick count; this script collects and compares them.
+
+With --spectators, player 1 also serves that many spectators, which replay
+the game from its state broadcast and check it against the players' own
+positions.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+from pathlib import Path
+from typing import Any
+
+from gamectl import ROOT, call_remote
+
+
+def soak_line(log_path: Path) -> dict[str, Any] | None:
+    for line in log_path.read_text(errors="replace").splitlines():
+        if line.startswith('{"net_soak":'):
+            return json.loads(line)["net_soak"]
+    return None
+
+
+def launch(args: argparse.Namespace, number: int, log_dir: Path) -> tuple[subprocess.Popen[bytes], str, Path]:
+    """Numbers 1 and 2 are the players; 3 and up are spectators."""
+    port = args.port + number - 1
+    other_port = args.port + 2 - number if number <= 2 else args.port
+    socket_path = f"/tmp/tyrian3000-netsoak-{number}.sock"
+    try:
+        os.unlink(socket_path)
+    except FileNotFoundError:
+        pass
+
+    # each end draws its own losses; the scripted keys mix in the player number
+    link = f"delay={args.delay},jitter={args.jitter},loss={args.loss},reorder={args.reorder},seed={args.seed * 2 + number}"
+
+    binary = Path(args.binary)
+    if not binary.is_absolute():
+        binary = (ROOT / binary).resolve()
+
+    cmd = [
+        str(binary),
+        f"--data={args.data}",
+        "--no-sound",
+        f"--net-spectate=127.0.0.1:{other_port}" if number > 2 else f"--net=127.0.0.1:{other_port}",
+        f"--net-port={port}",
+        f"--net-player-number={min(number, 2)}",
+        f"--net-player-name=soak{number}",
+        f"--net-delay={args.net_delay}",
+        f"--net-spectators={args.spectators if number == 1 else 0}",
+        f"--net-sim={link}",
+        f"--net-soak={args.ticks}",
+        "--remote-control",
+        f"--remote-socket={socket_path}",
+    ]
+
+    env = dict(os.environ)
+    if args.video_driver:
+        env["SDL_VIDEODRIVER"] = args.video_driver
+
+    log_path = log_dir / f"netsoak-{number}.log"
+    log_file = log_path.open("wb")
+    proc = subprocess.Popen(  # noqa: S603
+        cmd,
+        cwd=ROOT,
+        env=env,
+        stdout=log_file,
+        stderr=subprocess.STDOUT,
+        start_new_session=True,
+    )
+    return proc, socket_path, log_path
+
+
+def run(args: argparse.Namespace) -> int:
+    log_dir = Path(args.log_dir)
+    log_dir.mkdir(parents=True, exist_ok=True)
+
+    peers = [launch(args, number, log_dir) for number in range(1, 3 + args.spectators)]
+
+    # at the default speed a tick is a frame of about 1/35 s
+    deadline = time.time() + args.timeout if args.timeout else time.time() + args.ticks / 35 * 3 + 120
+    timed_out = False
+    while any(proc.poll() is None for proc, _, _ in peers):
+        if time.time() > deadline:
+            timed_out = True
+            break
+
+        # accept every menu default (episode, difficulty, start level) until play begins;
+        # spectators have no menus
+        for proc, socket_path, _ in peers[:2]:
+            if proc.poll() is not None:
+                continue
+            try:
+                state = call_remote({"cmd": "get_state"}, socket_path, timeout=2.0)
+                if state.get("context") != "in_game":
+                    call_remote({"cmd": "send_key", "key": "RETURN"}, socket_path, timeout=2.0)
+            except Exception:  # noqa: BLE001
+                pass  # not listening yet, or busy waiting on the peer
+
+        time.sleep(args.poll)
+
+    for proc, _, _ in peers:
+        if proc.poll() is None:
+            proc.kill()
+            proc.wait()
+
+    results = [soak_line(log_path) for _, _, log_path in peers]
+
+    report = {
+        "seed": args.seed,
+        "ticks": args.ticks,
+        "link": {"delay_ms": args.delay, "jitter_ms": args.jitter, "loss_pct": args.loss, "reorder_pct": args.reorder},
+        "net_delay": args.net_delay,
+        "timed_out": timed_out,
+        "players": results[:2],
+        "spectators": results[2:],
+    }
+
+    if args.json:
+        print(json.dumps(report, indent=2))
+    else:
+        for number, result in enumerate(results, start=1):
+            name = f"player {number}" if number <= 2 else f"spectator {number - 2}"
+            if result is None:
+                print(f"{name}: no report (see {peers[number - 1][2]})")
+                continue
+            print(
+                f"{name}: {result['ticks']} ticks in {result['seconds']:.1f} s, "
+                f"stalls {result['stalls']} ({result['stalls_per_minute']:.1f}/min, {result['stalled_ms']} ms), "
+                f"resends {result['resends']}, retries {result['retries']}, "
+                f"xor recoveries {result['xor_recoveries']}, desyncs {result['desyncs']}, "
+                f"dropped {result['link']['dropped']}/{result['link']['sent']}"
+            )
+        if timed_out:
+            print("timed out")
+
+    if timed_out or any(result is None or result["desyncs"] > 0 for result in results):
+        return 1
+    return 0
+
+
+def build_parser() -> argparse.ArgumentParser:
+    parser = argparse.ArgumentParser(description="Tyrian 3000 local netplay soak test")
+    parser.add_argument("--binary", default="./opentyrian2000")
+    parser.add_argument("--data", default="data/tyrian2000")
+    parser.add_argument("--ticks", type=int, default=4200, help="state ticks to play (35 per second)")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--delay", type=int, default=40, help="one-way delay in ms")
+    parser.add_argument("--jitter", type=int, default=15, help="delay varies by up to this many ms either way")
+    parser.add_argument("--loss", type=float, default=2.0, help="percentage of packets dropped")
+    parser.add_argument("--reorder", type=float, default=1.0, help="percentage of packets held back behind later ones")
+    parser.add_argument("--net-delay", type=int, default=1, help="lag-compensation delay in frames")
+    parser.add_argument("--spectators", type=int, default=0, help="spectators watching player 1 (at most 8)")
+    parser.add_argument("--port", type=int, default=14333, help="player 1 binds this port, player 2 the next, spectators the ones after")
+    parser.add_argument("--video-driver", default="dummy", help="SDL_VIDEODRIVER for both instances ('' for default)")
+    parser.add_argument("--timeout", type=float, default=0, help="seconds before giving up (default scales with --ticks)")
+    parser.add_argument("--poll", type=float, default=0.5, help="seconds between menu pokes")
+    parser.add_argument("--log-dir", default="/tmp")
+    parser.add_argument("--json", action="store_true", help="print the combined report as JSON")
+    return parser
+
+
+def main() -> int:
+    args = build_parser().parse_args()
+    try:
+        return run(args)
+    except KeyboardInterrupt:
+        return 130
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Tyrian 3000 reward delta test.
+
+Launches the game with gamectl, lets it replay the demos (--bench-demos) and
+steps it with `gamectl wait --session`, which opens a new connection for every
+command.  Between steps a second client polls get_state, once on its own
+connection and once under another session, the way a dashboard would.
+
+Every reply of the same game must report a score_delta equal to the change in
+score since the stepping session's previous reply; the polls must not take any
+of it.  The test passes after --deltas non-zero deltas have matched.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import subprocess
+import sys
+from typing import Any
+
+from gamectl import ROOT
+
+GAMECTL = str(ROOT / "tools" / "gamectl.py")
+
+
+def gamectl(*args: str) -> dict[str, Any]:
+    out = subprocess.run([sys.executable, GAMECTL, *args], check=True, capture_output=True, text=True).stdout
+    return json.loads(out)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Tyrian 3000 reward delta test")
+    parser.add_argument("--socket", default="/tmp/tyrian3000-reward-test.sock")
+    parser.add_argument("--data", default="data/tyrian2000")
+    parser.add_argument("--polls", type=int, default=600, help="wait replies to read before giving up")
+    parser.add_argument("--frames", type=int, default=10, help="frames to wait between replies")
+    parser.add_argument("--deltas", type=int, default=5, help="non-zero deltas to check before passing")
+    parser.add_argument("--build", action=argparse.BooleanOptionalAction, default=True)
+    args = parser.parse_args()
+
+    launch = ["launch", f"--socket={args.socket}", f"--data={args.data}", "--build" if args.build else "--no-build"]
+    subprocess.run([sys.executable, GAMECTL, *launch, "--", "--no-sound", "--bench-demos", "1"], check=True, stdout=subprocess.DEVNULL)
+
+    try:
+        last: tuple[int, int] | None = None  # (game, score) of the previous step
+        matched = 0
+        for _ in range(args.polls):
+            reply = gamectl("wait", f"--socket={args.socket}", "--session=reward-test", "--timeout=30", str(args.frames))
+            game, first = reply["game"], reply["players"][0]
+            score, delta = first["score"], first["score_delta"]
+
+            # a new demo starts a new game, whose first reply has no baseline and reports 0
+            if last is not None and last[0] == game:
+                if delta != score - last[1]:
+                    print(f"FAIL: score went {last[1]} -> {score} but score_delta was {delta}")
+                    return 1
+                if delta != 0:
+                    matched += 1
+                    print(f"ok: score_delta {delta} (score {last[1]} -> {score})")
+                    if matched == args.deltas:
+                        return 0
+            last = (game, score)
+
+            gamectl("game-state", f"--socket={args.socket}")
+            gamectl("game-state", f"--socket={args.socket}", "--session=dashboard")
+
+        print(f"FAIL: {matched} of {args.deltas} non-zero score_deltas in {args.polls} replies")
+        return 1
+    finally:
+        subprocess.run([sys.executable, GAMECTL, "stop", f"--socket={args.socket}"], stdout=subprocess.DEVNULL)
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())